@@ -0,0 +1,124 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Text;
+
+namespace ConvertWavToByteArray
+{
+    /// <summary>
+    /// Generates the flash resident note attacks used by the firmware.
+    /// </summary>
+    /// <remarks>
+    /// The first milliseconds of each note are written to ATTACKS.c as const 
+    /// arrays placed in the .attacks flash section. The attacks are kept in the
+    /// WAV's signed 16-bit frame format since the firmware resamples every note
+    /// before converting it to the DAC level.
+    /// </remarks>
+    static class AttackGenerator
+    {
+        const int HeaderSize = 44;
+        const int SectorSize = 512;
+        const int FlashSize = 512 * 1024;
+        const int BytesPerLine = 16;
+
+        /// <summary>
+        /// Generates ATTACKS.c from a list of WAV files.
+        /// </summary>
+        /// <param name="outputPath">The path of the generated source file.</param>
+        /// <param name="milliseconds">The length of each attack.</param>
+        /// <param name="wavFiles">The note WAV files.</param>
+        /// <returns>The number of flash bytes used by the attacks.</returns>
+        public static int Generate(string outputPath, int milliseconds, IList<string> wavFiles)
+        {
+            StringBuilder arrays = new StringBuilder();
+            StringBuilder table = new StringBuilder();
+            int totalBytes = 0;
+
+            for (int i = 0; i < wavFiles.Count; i++)
+            {
+                byte[] wav = File.ReadAllBytes(wavFiles[i]);
+                byte[] attack = GetAttack(wav, milliseconds);
+                string name = Path.GetFileName(wavFiles[i]);
+
+                arrays.AppendFormat("/* {0}, {1} bytes. */\n", name, attack.Length);
+                arrays.AppendFormat("const BYTE attack{0}[{1}] __attribute__((section(\".attacks\"), space(prog))) = {{\n", i, attack.Length);
+                for (int j = 0; j < attack.Length; j += BytesPerLine)
+                {
+                    int count = Math.Min(BytesPerLine, attack.Length - j);
+                    string[] line = new string[count];
+                    for (int k = 0; k < count; k++)
+                    {
+                        line[k] = "0x" + attack[j + k].ToString("X2");
+                    }
+                    arrays.Append("    " + string.Join(", ", line) + ",\n");
+                }
+                arrays.Append("};\n\n");
+
+                table.AppendFormat("    {{\"{0}\", {1}, &attack{2}[0]}},\n", name, attack.Length, i);
+                totalBytes += attack.Length;
+            }
+
+            string usage = string.Format("Flash usage: {0} bytes ({1:F1}% of {2} KB).", 
+                totalBytes, (100.0 * totalBytes) / FlashSize, FlashSize / 1024);
+
+            StringBuilder output = new StringBuilder();
+            output.Append("/**\n");
+            output.Append(" * @file ATTACKS.c\n");
+            output.Append(" * @details Generated by ConvertWavToByteArray from " + wavFiles.Count + " WAV files with " + milliseconds + " ms attacks. Do not edit.\n");
+            output.Append(" * " + usage + "\n");
+            output.Append(" */\n\n");
+            output.Append("#include <stddef.h>\n");
+            output.Append("#include \"STDDEF.h\"\n");
+            output.Append("#include \"ATTACKS.h\"\n\n");
+            output.Append(arrays.ToString());
+            output.Append("/** @var attacks \n * The list of note attacks, ends with a NULL file name. */\n");
+            output.Append("const ATTACK attacks[] = {\n");
+            output.Append(table.ToString());
+            output.Append("    {NULL, 0, NULL}\n");
+            output.Append("};\n");
+            File.WriteAllText(outputPath, output.ToString());
+
+            Console.WriteLine(usage);
+            return totalBytes;
+        }
+
+        /// <summary>
+        /// Returns the attack of a WAV file.
+        /// </summary>
+        /// <param name="wav">The bytes of the WAV file.</param>
+        /// <param name="milliseconds">The length of the attack.</param>
+        /// <returns>The audio data of the attack, whole sectors when possible.</returns>
+        static byte[] GetAttack(byte[] wav, int milliseconds)
+        {
+            if (wav.Length < HeaderSize || Encoding.ASCII.GetString(wav, 0, 4) != "RIFF" || 
+                Encoding.ASCII.GetString(wav, 8, 4) != "WAVE" || Encoding.ASCII.GetString(wav, 36, 4) != "data")
+            {
+                throw new InvalidDataException("Not a 44 byte header WAV file.");
+            }
+
+            int bitPerSample = (wav[35] << 8 | wav[34]);
+            int blockAlign = (wav[33] << 8 | wav[32]);
+            int byteRate = (wav[31] << 24 | wav[30] << 16 | wav[29] << 8 | wav[28]);
+            int dataSize = (wav[43] << 24 | wav[42] << 16 | wav[41] << 8 | wav[40]);
+
+            if (bitPerSample != 16 || blockAlign == 0)
+            {
+                throw new InvalidDataException("Only 16-bit WAV files are supported.");
+            }
+
+            int size = (int)(((long)byteRate * milliseconds) / 1000);
+            size = Math.Min(size, Math.Min(dataSize, wav.Length - HeaderSize));
+            size -= size % blockAlign;
+
+            // Whole sectors keep the reads that follow the attack sector aligned.
+            if (size >= SectorSize)
+            {
+                size -= size % SectorSize;
+            }
+
+            byte[] attack = new byte[size];
+            Array.Copy(wav, HeaderSize, attack, 0, size);
+            return attack;
+        }
+    }
+}
@@ -0,0 +1,119 @@
+﻿using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace ConvertWavToByteArray
+{
+    /// <summary>
+    /// Converts a directory of note WAV files without the form.
+    /// </summary>
+    /// <remarks>
+    /// The headers are checked in parallel and only the header of each file is
+    /// held in memory, the audio data is streamed into the sample pack (and into
+    /// the comma separated arrays the form shows, when asked for). The pack is
+    /// written as NOTES.PAK so it can be copied to the card as is.
+    /// </remarks>
+    static class BatchConverter
+    {
+        const int ChunkSize = 64 * 1024;
+
+        /// <summary>
+        /// Converts every WAV file of a directory.
+        /// </summary>
+        /// <param name="inputDir">The directory holding the note WAV files.</param>
+        /// <param name="outputDir">The directory the card files are written to.</param>
+        /// <param name="arrayFormat">"hex" or "dec" to also write each file as a comma separated array, null otherwise.</param>
+        /// <returns>The number of files that couldn't be converted.</returns>
+        public static int Convert(string inputDir, string outputDir, string arrayFormat)
+        {
+            Stopwatch stopwatch = Stopwatch.StartNew();
+            string[] paths = Directory.GetFiles(inputDir, "*.wav");
+            Array.Sort(paths, StringComparer.OrdinalIgnoreCase);
+            Directory.CreateDirectory(outputDir);
+
+            WavInfo[] notes = new WavInfo[paths.Length];
+            ConcurrentQueue<string> errors = new ConcurrentQueue<string>();
+            Parallel.For(0, paths.Length, i =>
+            {
+                try
+                {
+                    using (FileStream stream = new FileStream(paths[i], FileMode.Open, FileAccess.Read, FileShare.Read, ChunkSize))
+                    {
+                        notes[i] = WavInfo.Read(stream, paths[i]);
+                        if (arrayFormat != null)
+                        {
+                            WriteArray(stream, notes[i], Path.Combine(outputDir, Path.ChangeExtension(notes[i].Name, ".csv")), arrayFormat == "hex");
+                        }
+                    }
+                }
+                catch (Exception ex)
+                {
+                    notes[i] = null;
+                    errors.Enqueue(ex.Message);
+                }
+            });
+
+            foreach (string error in errors.OrderBy(e => e, StringComparer.OrdinalIgnoreCase))
+            {
+                Console.Error.WriteLine("Error: " + error);
+            }
+
+            List<WavInfo> valid = notes.Where(n => n != null).ToList();
+            long inputBytes = valid.Sum(n => (long)n.DataSize);
+            foreach (WavInfo note in valid)
+            {
+                Console.WriteLine("{0,-10} {1} ch {2,5} Hz {3,9} bytes {4,7:F3} s", note.Name, note.Channels,
+                    note.SampleRate, note.DataSize, (double)note.DataSize / note.ByteRate);
+            }
+
+            long packBytes = (valid.Count > 0) ? PackBuilder.Build(Path.Combine(outputDir, PackBuilder.FileName), valid) : 0;
+            stopwatch.Stop();
+
+            double seconds = Math.Max(stopwatch.Elapsed.TotalSeconds, 0.001);
+            Console.WriteLine("Converted {0} of {1} files, {2} bytes of audio into {3} bytes on the card ({4} sectors).",
+                valid.Count, paths.Length, inputBytes, packBytes, packBytes / 512);
+            Console.WriteLine("Took {0:F2} s, {1:F1} MB/s.", seconds, inputBytes / seconds / (1024 * 1024));
+            return paths.Length - valid.Count;
+        }
+
+        /// <summary>
+        /// Streams the audio data of a WAV file into a comma separated array.
+        /// </summary>
+        /// <param name="stream">The WAV file, positioned at the audio data.</param>
+        /// <param name="note">The header of the WAV file.</param>
+        /// <param name="outputPath">The path of the array.</param>
+        /// <param name="hex">True to write the bytes in hex, false in decimal.</param>
+        static void WriteArray(Stream stream, WavInfo note, string outputPath, bool hex)
+        {
+            byte[] buffer = new byte[ChunkSize];
+            long remaining = note.DataSize;
+            bool first = true;
+            using (StreamWriter writer = new StreamWriter(outputPath, false, Encoding.ASCII, ChunkSize))
+            {
+                while (remaining > 0)
+                {
+                    int read = stream.Read(buffer, 0, (int)Math.Min(buffer.Length, remaining));
+                    if (read <= 0)
+                    {
+                        throw new EndOfStreamException(note.Name + ": The audio data ends early.");
+                    }
+                    for (int i = 0; i < read; i++)
+                    {
+                        if (!first)
+                        {
+                            writer.Write(',');
+                        }
+                        writer.Write(hex ? buffer[i].ToString("X") : buffer[i].ToString());
+                        first = false;
+                    }
+                    remaining -= read;
+                }
+            }
+        }
+    }
+}
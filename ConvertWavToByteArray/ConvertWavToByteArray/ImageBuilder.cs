@@ -0,0 +1,342 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Text;
+using System.Text.RegularExpressions;
+
+namespace ConvertWavToByteArray
+{
+    /// <summary>
+    /// Builds an SD card image holding the files the firmware reads.
+    /// </summary>
+    /// <remarks>
+    /// The image has an MBR and one FAT32 partition laid out the way the SD
+    /// formatter does: the partition and the data area start on a 4 MB erase
+    /// block. Every file is written to one run of clusters and files larger than
+    /// an erase block start on an erase block, so the firmware can read them
+    /// with multi-block reads and without following the FAT. The image can be
+    /// written to a card with dd and used as the disk of "upload-image".
+    /// </remarks>
+    static class ImageBuilder
+    {
+        public const int SectorSize = 512;
+        public const int EraseBlockSectors = 8192;
+        const int PartitionStart = EraseBlockSectors;
+        const int MinReservedSectors = 32;
+        const int NumOfFats = 2;
+        const int MinClusters = 65536;
+        const int DirEntrySize = 32;
+        const int RootCluster = 2;
+        const uint EndOfChain = 0x0FFFFFFF;
+
+        /// <summary>
+        /// A file placed in the image.
+        /// </summary>
+        class ImageFile
+        {
+            public string Name;
+            public string Path;
+            public long Size;
+            public uint FirstCluster;
+            public uint Clusters;
+            public DateTime Time;
+        }
+
+        /// <summary>
+        /// Builds an SD card image.
+        /// </summary>
+        /// <param name="imagePath">The path of the image.</param>
+        /// <param name="clusterBytes">The cluster size, a power of two from 512 to 65536 bytes.</param>
+        /// <param name="inputs">The files of the root directory. WAV files are built into NOTES.PAK.</param>
+        public static void Build(string imagePath, int clusterBytes, IList<string> inputs)
+        {
+            int clusterSectors = clusterBytes / SectorSize;
+            if (clusterSectors < 1 || clusterSectors > 128 || (clusterSectors & (clusterSectors - 1)) != 0)
+            {
+                throw new ArgumentException("The cluster size must be a power of two from 512 to 65536 bytes.");
+            }
+
+            List<string> wavFiles = inputs.Where(p => p.EndsWith(".wav", StringComparison.OrdinalIgnoreCase)).ToList();
+            string packPath = null;
+            try
+            {
+                List<ImageFile> files = new List<ImageFile>();
+                if (wavFiles.Count > 0)
+                {
+                    packPath = System.IO.Path.GetTempFileName();
+                    PackBuilder.Build(packPath, wavFiles);
+                    files.Add(new ImageFile { Name = PackBuilder.FileName, Path = packPath, Time = DateTime.Now });
+                }
+                foreach (string path in inputs.Except(wavFiles))
+                {
+                    files.Add(new ImageFile { Name = System.IO.Path.GetFileName(path).ToUpperInvariant(), Path = path,
+                        Time = File.GetLastWriteTime(path) });
+                }
+                Write(imagePath, clusterSectors, files);
+            }
+            finally
+            {
+                if (packPath != null)
+                {
+                    File.Delete(packPath);
+                }
+            }
+        }
+
+        /// <summary>
+        /// Lays out the files and writes the image.
+        /// </summary>
+        static void Write(string imagePath, int clusterSectors, List<ImageFile> files)
+        {
+            long clusterBytes = (long)clusterSectors * SectorSize;
+            int eraseBlockClusters = EraseBlockSectors / clusterSectors;
+            if (files.Select(f => f.Name).Distinct().Count() != files.Count)
+            {
+                throw new InvalidDataException("The image can't hold two files with the same name.");
+            }
+
+            // The root directory comes first, then one run of clusters per file.
+            uint rootClusters = (uint)(((files.Count + 1) * DirEntrySize + clusterBytes - 1) / clusterBytes);
+            uint nextCluster = RootCluster + rootClusters;
+            foreach (ImageFile file in files)
+            {
+                file.Size = new FileInfo(file.Path).Length;
+                if (file.Size > 0xFFFFFFFFL)
+                {
+                    throw new InvalidDataException(file.Name + " is larger than FAT32 allows.");
+                }
+                file.Clusters = (uint)((file.Size + clusterBytes - 1) / clusterBytes);
+                if (file.Clusters > eraseBlockClusters)
+                {
+                    nextCluster = (uint)((nextCluster - RootCluster + eraseBlockClusters - 1) / eraseBlockClusters
+                        * eraseBlockClusters + RootCluster);
+                }
+                file.FirstCluster = (file.Clusters > 0) ? nextCluster : 0;
+                nextCluster += file.Clusters;
+            }
+
+            // FAT32 needs at least 65526 clusters, the data area fills whole erase blocks.
+            long clusters = Math.Max(nextCluster - RootCluster, MinClusters);
+            clusters = (clusters + eraseBlockClusters - 1) / eraseBlockClusters * eraseBlockClusters;
+            uint fatSectors = (uint)(((clusters + 2) * 4 + SectorSize - 1) / SectorSize);
+            uint reservedSectors = MinReservedSectors;
+            uint misalignment = (uint)((PartitionStart + reservedSectors + NumOfFats * fatSectors) % EraseBlockSectors);
+            if (misalignment != 0)
+            {
+                reservedSectors += EraseBlockSectors - misalignment;
+            }
+            uint dataSector = PartitionStart + reservedSectors + NumOfFats * fatSectors;
+            uint partitionSectors = (uint)(reservedSectors + NumOfFats * fatSectors + clusters * clusterSectors);
+
+            uint[] fat = new uint[nextCluster];
+            fat[0] = 0x0FFFFFF8;
+            fat[1] = EndOfChain;
+            Chain(fat, RootCluster, rootClusters);
+            foreach (ImageFile file in files)
+            {
+                Chain(fat, file.FirstCluster, file.Clusters);
+            }
+            uint usedClusters = (uint)fat.Skip(RootCluster).Count(entry => entry != 0);
+
+            using (FileStream image = new FileStream(imagePath, FileMode.Create, FileAccess.ReadWrite))
+            {
+                image.SetLength((long)(PartitionStart + partitionSectors) * SectorSize);
+
+                WriteSector(image, 0, GetMbr(partitionSectors));
+                byte[] bootSector = GetBootSector(clusterSectors, reservedSectors, fatSectors, partitionSectors);
+                byte[] fsInfo = GetFsInfo((uint)(clusters - usedClusters), nextCluster);
+                WriteSector(image, PartitionStart, bootSector);
+                WriteSector(image, PartitionStart + 1, fsInfo);
+                WriteSector(image, PartitionStart + 6, bootSector);
+                WriteSector(image, PartitionStart + 7, fsInfo);
+
+                byte[] fatBytes = new byte[fat.Length * 4];
+                Buffer.BlockCopy(fat, 0, fatBytes, 0, fatBytes.Length);
+                for (int i = 0; i < NumOfFats; i++)
+                {
+                    WriteSector(image, PartitionStart + reservedSectors + i * fatSectors, fatBytes);
+                }
+
+                WriteSector(image, dataSector, GetRootDirectory(files));
+                foreach (ImageFile file in files.Where(f => f.Clusters > 0))
+                {
+                    image.Seek(GetSector(file.FirstCluster, dataSector, clusterSectors) * SectorSize, SeekOrigin.Begin);
+                    using (FileStream input = File.OpenRead(file.Path))
+                    {
+                        input.CopyTo(image, 64 * 1024);
+                    }
+                }
+            }
+
+            Console.WriteLine("Image: {0} sectors, FAT32 partition at sector {1}, data at sector {2}, {3} clusters of {4} bytes.",
+                PartitionStart + partitionSectors, PartitionStart, dataSector, clusters, clusterBytes);
+            foreach (ImageFile file in files)
+            {
+                long sector = GetSector(file.FirstCluster, dataSector, clusterSectors);
+                Console.WriteLine("{0,-12} {1,10} bytes  sector {2,8}  {3,6} clusters  {4} fragment(s)  {5}  erase block {6} +{7}",
+                    file.Name, file.Size, (file.Clusters > 0) ? sector : 0, file.Clusters, CountFragments(fat, file.FirstCluster),
+                    (sector - dataSector) % clusterSectors == 0 ? "cluster aligned" : "unaligned",
+                    sector / EraseBlockSectors, sector % EraseBlockSectors);
+            }
+        }
+
+        /// <summary>
+        /// Links a run of clusters in the FAT.
+        /// </summary>
+        static void Chain(uint[] fat, uint firstCluster, uint clusters)
+        {
+            for (uint i = 0; i < clusters; i++)
+            {
+                fat[firstCluster + i] = (i + 1 < clusters) ? firstCluster + i + 1 : EndOfChain;
+            }
+        }
+
+        /// <summary>
+        /// Returns the number of cluster runs a file is stored in, read back from the FAT.
+        /// </summary>
+        static int CountFragments(uint[] fat, uint cluster)
+        {
+            int fragments = (cluster >= RootCluster) ? 1 : 0;
+            while (cluster >= RootCluster && fat[cluster] != EndOfChain)
+            {
+                if (fat[cluster] != cluster + 1)
+                {
+                    fragments++;
+                }
+                cluster = fat[cluster];
+            }
+            return fragments;
+        }
+
+        /// <summary>
+        /// Returns the first sector of a cluster.
+        /// </summary>
+        static long GetSector(uint cluster, uint dataSector, int clusterSectors)
+        {
+            return dataSector + (long)(cluster - RootCluster) * clusterSectors;
+        }
+
+        /// <summary>
+        /// Returns the MBR with one FAT32 (LBA) partition.
+        /// </summary>
+        static byte[] GetMbr(uint partitionSectors)
+        {
+            byte[] mbr = new byte[SectorSize];
+            byte[] entry = { 0x00, 0xFE, 0xFF, 0xFF, 0x0C, 0xFE, 0xFF, 0xFF };
+            Array.Copy(entry, 0, mbr, 446, entry.Length);
+            PutDword(mbr, 454, PartitionStart);
+            PutDword(mbr, 458, partitionSectors);
+            mbr[510] = 0x55;
+            mbr[511] = 0xAA;
+            return mbr;
+        }
+
+        /// <summary>
+        /// Returns the FAT32 boot sector.
+        /// </summary>
+        static byte[] GetBootSector(int clusterSectors, uint reservedSectors, uint fatSectors, uint partitionSectors)
+        {
+            byte[] boot = new byte[SectorSize];
+            boot[0] = 0xEB;
+            boot[1] = 0x58;
+            boot[2] = 0x90;
+            Encoding.ASCII.GetBytes("MSWIN4.1").CopyTo(boot, 3);
+            PutWord(boot, 11, SectorSize);
+            boot[13] = (byte)clusterSectors;
+            PutWord(boot, 14, (int)reservedSectors);
+            boot[16] = NumOfFats;
+            boot[21] = 0xF8;
+            PutWord(boot, 24, 63);
+            PutWord(boot, 26, 255);
+            PutDword(boot, 28, PartitionStart);
+            PutDword(boot, 32, partitionSectors);
+            PutDword(boot, 36, fatSectors);
+            PutDword(boot, 44, RootCluster);
+            PutWord(boot, 48, 1);
+            PutWord(boot, 50, 6);
+            boot[64] = 0x80;
+            boot[66] = 0x29;
+            PutDword(boot, 67, (uint)DateTime.Now.Ticks);
+            Encoding.ASCII.GetBytes("NO NAME    FAT32   ").CopyTo(boot, 71);
+            boot[510] = 0x55;
+            boot[511] = 0xAA;
+            return boot;
+        }
+
+        /// <summary>
+        /// Returns the FAT32 FSInfo sector.
+        /// </summary>
+        static byte[] GetFsInfo(uint freeClusters, uint nextFreeCluster)
+        {
+            byte[] info = new byte[SectorSize];
+            PutDword(info, 0, 0x41615252);
+            PutDword(info, 484, 0x61417272);
+            PutDword(info, 488, freeClusters);
+            PutDword(info, 492, nextFreeCluster);
+            PutDword(info, 508, 0xAA550000);
+            return info;
+        }
+
+        /// <summary>
+        /// Returns the root directory entries.
+        /// </summary>
+        static byte[] GetRootDirectory(List<ImageFile> files)
+        {
+            byte[] dir = new byte[(files.Count + 1) * DirEntrySize];
+            for (int i = 0; i < files.Count; i++)
+            {
+                int entry = i * DirEntrySize;
+                GetShortName(files[i].Name).CopyTo(dir, entry);
+                dir[entry + 11] = 0x20;
+                int time = files[i].Time.Hour << 11 | files[i].Time.Minute << 5 | files[i].Time.Second / 2;
+                int date = Math.Max(files[i].Time.Year - 1980, 0) << 9 | files[i].Time.Month << 5 | files[i].Time.Day;
+                PutWord(dir, entry + 14, time);
+                PutWord(dir, entry + 16, date);
+                PutWord(dir, entry + 18, date);
+                PutWord(dir, entry + 20, (int)(files[i].FirstCluster >> 16));
+                PutWord(dir, entry + 22, time);
+                PutWord(dir, entry + 24, date);
+                PutWord(dir, entry + 26, (int)(files[i].FirstCluster & 0xFFFF));
+                PutDword(dir, entry + 28, (uint)files[i].Size);
+            }
+            return dir;
+        }
+
+        /// <summary>
+        /// Returns the 8.3 directory name of a file, the firmware doesn't read long names.
+        /// </summary>
+        static byte[] GetShortName(string name)
+        {
+            Match match = Regex.Match(name, @"^([A-Z0-9_\-~!#$%&'()@^`{}]{1,8})(?:\.([A-Z0-9_\-~!#$%&'()@^`{}]{1,3}))?$");
+            if (!match.Success)
+            {
+                throw new InvalidDataException(name + " is not an 8.3 file name.");
+            }
+            return Encoding.ASCII.GetBytes(match.Groups[1].Value.PadRight(8) + match.Groups[2].Value.PadRight(3));
+        }
+
+        /// <summary>
+        /// Writes whole sectors at a sector of the image.
+        /// </summary>
+        static void WriteSector(FileStream image, long sector, byte[] data)
+        {
+            image.Seek(sector * SectorSize, SeekOrigin.Begin);
+            image.Write(data, 0, data.Length);
+        }
+
+        static void PutWord(byte[] buffer, int offset, int value)
+        {
+            buffer[offset] = (byte)value;
+            buffer[offset + 1] = (byte)(value >> 8);
+        }
+
+        static void PutDword(byte[] buffer, int offset, uint value)
+        {
+            buffer[offset] = (byte)value;
+            buffer[offset + 1] = (byte)(value >> 8);
+            buffer[offset + 2] = (byte)(value >> 16);
+            buffer[offset + 3] = (byte)(value >> 24);
+        }
+    }
+}
@@ -0,0 +1,151 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Text;
+using System.Text.RegularExpressions;
+
+namespace ConvertWavToByteArray
+{
+    /// <summary>
+    /// Builds the sample pack read by the firmware.
+    /// </summary>
+    /// <remarks>
+    /// The pack holds the notes of every string in one file. An 8 byte header
+    /// ("SPAK", version, number of notes) is followed by a 32 byte entry per note
+    /// holding the note ID, format, offset, length, sustain loop and the first
+    /// sample frame above the noise floor. The audio data of each note starts on
+    /// a 512 byte sector boundary. The layout matches PACKDEF.h.
+    /// </remarks>
+    static class PackBuilder
+    {
+        public const string FileName = "NOTES.PAK";
+        const int SectorSize = 512;
+        const int HeaderSize = 8;
+        const int EntrySize = 32;
+        const int Version = 1;
+
+        /// <summary>
+        /// Builds a sample pack from a list of WAV files.
+        /// </summary>
+        /// <param name="outputPath">The path of the sample pack.</param>
+        /// <param name="wavFiles">The note WAV files, named S(string)_(fret).wav.</param>
+        /// <returns>The size of the sample pack in bytes.</returns>
+        public static long Build(string outputPath, IList<string> wavFiles)
+        {
+            List<WavInfo> notes = new List<WavInfo>();
+            foreach (string path in wavFiles)
+            {
+                notes.Add(WavInfo.Read(path));
+            }
+            return Build(outputPath, notes);
+        }
+
+        /// <summary>
+        /// Builds a sample pack from the headers of the note WAV files.
+        /// </summary>
+        /// <remarks>
+        /// The audio data is streamed from each WAV file into the pack.
+        /// </remarks>
+        /// <param name="outputPath">The path of the sample pack.</param>
+        /// <param name="wavs">The note headers, named S(string)_(fret).wav.</param>
+        /// <returns>The size of the sample pack in bytes.</returns>
+        public static long Build(string outputPath, IList<WavInfo> wavs)
+        {
+            List<WavInfo> notes = new List<WavInfo>(wavs);
+            notes.Sort((a, b) => GetNoteId(a).CompareTo(GetNoteId(b)));
+
+            uint[] offsets = new uint[notes.Count];
+            uint offset = Align((uint)(HeaderSize + EntrySize * notes.Count));
+            for (int i = 0; i < notes.Count; i++)
+            {
+                if (i > 0 && GetNoteId(notes[i]) == GetNoteId(notes[i - 1]))
+                {
+                    throw new InvalidDataException(notes[i].Name + " duplicates " + notes[i - 1].Name + ".");
+                }
+                offsets[i] = offset;
+                offset = Align(offset + notes[i].DataSize);
+            }
+
+            using (BinaryWriter writer = new BinaryWriter(File.Create(outputPath)))
+            {
+                writer.Write(Encoding.ASCII.GetBytes("SPAK"));
+                writer.Write((ushort)Version);
+                writer.Write((ushort)notes.Count);
+                for (int i = 0; i < notes.Count; i++)
+                {
+                    writer.Write((ushort)GetNoteId(notes[i]));
+                    writer.Write((byte)notes[i].Channels);
+                    writer.Write((byte)notes[i].BitsPerSample);
+                    writer.Write((uint)notes[i].SampleRate);
+                    writer.Write((ushort)notes[i].BlockAlign);
+                    writer.Write((ushort)0);
+                    writer.Write(offsets[i]);
+                    writer.Write(notes[i].DataSize);
+                    writer.Write(notes[i].LoopStart);
+                    writer.Write(notes[i].LoopLength);
+                    writer.Write(notes[i].StartFrame);
+                }
+                for (int i = 0; i < notes.Count; i++)
+                {
+                    writer.Write(new byte[offsets[i] - writer.BaseStream.Position]);
+                    using (FileStream wav = File.OpenRead(notes[i].FilePath))
+                    {
+                        wav.Position = notes[i].DataOffset;
+                        Copy(wav, writer.BaseStream, notes[i].DataSize);
+                    }
+                }
+                writer.Write(new byte[offset - writer.BaseStream.Position]);
+            }
+
+            for (int i = 0; i < notes.Count; i++)
+            {
+                int id = GetNoteId(notes[i]);
+                Console.WriteLine("{0,-10} string {1} fret {2,2}  sector {3,6}  {4,8} bytes  start {5,4} ms{6}", notes[i].Name,
+                    id >> 8, id & 0xFF, offsets[i] / SectorSize, notes[i].DataSize,
+                    notes[i].SampleRate > 0 ? notes[i].StartFrame * 1000L / notes[i].SampleRate : 0,
+                    notes[i].LoopLength > 0 ? string.Format("  loop {0}+{1}", notes[i].LoopStart, notes[i].LoopLength) : "");
+            }
+            Console.WriteLine("Pack size: {0} bytes, {1} notes.", offset, notes.Count);
+            return offset;
+        }
+
+        /// <summary>
+        /// Returns the note ID of a WAV file named S(string)_(fret).wav.
+        /// </summary>
+        static int GetNoteId(WavInfo wav)
+        {
+            Match match = Regex.Match(wav.Name, @"^S(\d+)_(\d+)\.wav$", RegexOptions.IgnoreCase);
+            if (!match.Success)
+            {
+                throw new InvalidDataException(wav.Name + " is not named S(string)_(fret).wav.");
+            }
+            return int.Parse(match.Groups[1].Value) << 8 | int.Parse(match.Groups[2].Value);
+        }
+
+        /// <summary>
+        /// Copies a number of bytes between streams.
+        /// </summary>
+        static void Copy(Stream input, Stream output, long count)
+        {
+            byte[] buffer = new byte[64 * 1024];
+            while (count > 0)
+            {
+                int read = input.Read(buffer, 0, (int)Math.Min(buffer.Length, count));
+                if (read <= 0)
+                {
+                    throw new EndOfStreamException("The audio data ends early.");
+                }
+                output.Write(buffer, 0, read);
+                count -= read;
+            }
+        }
+
+        /// <summary>
+        /// Rounds an offset up to the next sector boundary.
+        /// </summary>
+        static uint Align(uint offset)
+        {
+            return (offset + SectorSize - 1) / SectorSize * SectorSize;
+        }
+    }
+}
@@ -11,12 +11,103 @@ namespace ConvertWavToByteArray
         /// <summary>
         /// The main entry point for the application.
         /// </summary>
+        /// <remarks>
+        /// "attacks milliseconds output.c note.wav..." generates the flash 
+        /// resident note attacks and "pack output.pak note.wav..." builds the 
+        /// sample pack without opening the form. "upload port pack.pak" uploads
+        /// a sample pack to the instrument and "upload-image image.img sector 
+        /// pack.pak [errorInterval]" uploads it into a disk image instead. 
+        /// "batch inputDir outputDir [hex|dec]" converts every WAV file of a 
+        /// directory into the sample pack and, optionally, comma separated arrays.
+        /// "image image.img clusterKB file..." builds an SD card image holding 
+        /// the files, with the WAV files built into the sample pack.
+        /// </remarks>
         [STAThread]
-        static void Main()
+        static int Main(string[] args)
         {
+            if (args.Length >= 4 && args[0] == "attacks")
+            {
+                try
+                {
+                    AttackGenerator.Generate(args[2], int.Parse(args[1]), args.Skip(3).ToList());
+                    return 0;
+                }
+                catch (Exception ex)
+                {
+                    Console.Error.WriteLine("Error: Could not generate the attacks. Original error: " + ex.Message);
+                    return 1;
+                }
+            }
+
+            if (args.Length >= 3 && args[0] == "pack")
+            {
+                try
+                {
+                    PackBuilder.Build(args[1], args.Skip(2).ToList());
+                    return 0;
+                }
+                catch (Exception ex)
+                {
+                    Console.Error.WriteLine("Error: Could not build the sample pack. Original error: " + ex.Message);
+                    return 1;
+                }
+            }
+
+            if ((args.Length == 3 || args.Length == 4) && args[0] == "batch")
+            {
+                try
+                {
+                    string arrayFormat = (args.Length == 4) ? args[3].ToLowerInvariant() : null;
+                    if (arrayFormat != null && arrayFormat != "hex" && arrayFormat != "dec")
+                    {
+                        Console.Error.WriteLine("Error: The array format must be hex or dec.");
+                        return 1;
+                    }
+                    return (BatchConverter.Convert(args[1], args[2], arrayFormat) == 0) ? 0 : 1;
+                }
+                catch (Exception ex)
+                {
+                    Console.Error.WriteLine("Error: Could not convert the directory. Original error: " + ex.Message);
+                    return 1;
+                }
+            }
+
+            if (args.Length >= 4 && args[0] == "image")
+            {
+                try
+                {
+                    ImageBuilder.Build(args[1], int.Parse(args[2]) * 1024, args.Skip(3).ToList());
+                    return 0;
+                }
+                catch (Exception ex)
+                {
+                    Console.Error.WriteLine("Error: Could not build the card image. Original error: " + ex.Message);
+                    return 1;
+                }
+            }
+
+            if ((args.Length == 3 && args[0] == "upload") || (args.Length >= 4 && args[0] == "upload-image"))
+            {
+                try
+                {
+                    using (IUploadLink link = (args[0] == "upload") ? (IUploadLink)new SerialUploadLink(args[1]) :
+                        new ImageUploadLink(args[1], long.Parse(args[2]), (args.Length > 4) ? int.Parse(args[4]) : 0))
+                    {
+                        UploadSender.Send(link, args[args[0] == "upload" ? 2 : 3]);
+                    }
+                    return 0;
+                }
+                catch (Exception ex)
+                {
+                    Console.Error.WriteLine("Error: Could not upload the sample pack. Original error: " + ex.Message);
+                    return 1;
+                }
+            }
+
             Application.EnableVisualStyles();
             Application.SetCompatibleTextRenderingDefault(false);
             Application.Run(new MainForm());
+            return 0;
         }
     }
 }
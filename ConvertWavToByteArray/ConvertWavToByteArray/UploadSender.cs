@@ -0,0 +1,361 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
+using System.IO.Ports;
+using System.Text;
+using System.Text.RegularExpressions;
+
+namespace ConvertWavToByteArray
+{
+    /// <summary>
+    /// The connection to the firmware used to upload a sample pack.
+    /// </summary>
+    interface IUploadLink : IDisposable
+    {
+        void WriteLine(string line);
+        string ReadLine(int timeoutMs);
+        void Write(byte[] buffer, int offset, int count);
+        int ReadByte(int timeoutMs);
+        void SetBaudRate(int baudRate);
+    }
+
+    /// <summary>
+    /// Uploads a sample pack to the instrument over UART.
+    /// </summary>
+    /// <remarks>
+    /// Follows the frame format of UPLOAD.c: a 16-bit sequence number, 2048 data
+    /// bytes and a CRC-16/CCITT, all little endian. The firmware answers every
+    /// frame with ACK or NAK and reports the CRC-32 of the sectors it read back,
+    /// which is compared with the CRC-32 of the pack.
+    /// </remarks>
+    static class UploadSender
+    {
+        public const int MonitorBaudRate = 19200;
+        public const int UploadBaudRate = 460800;
+        public const int BlockSize = 2048;
+        public const int SectorSize = 512;
+        public const int FrameSize = 2 + BlockSize + 2;
+        public const byte Ack = 0x06;
+        public const byte Nak = 0x15;
+        const int MaxRetries = 10;
+        const int ReplyTimeoutMs = 1000;
+        const int ResultTimeoutMs = 60000;
+
+        /// <summary>
+        /// Uploads a sample pack.
+        /// </summary>
+        /// <param name="link">The connection to the firmware.</param>
+        /// <param name="packPath">The path of the sample pack.</param>
+        public static void Send(IUploadLink link, string packPath)
+        {
+            byte[] pack = File.ReadAllBytes(packPath);
+            int sectors = (pack.Length + SectorSize - 1) / SectorSize;
+            int frames = (sectors * SectorSize + BlockSize - 1) / BlockSize;
+            byte[] data = new byte[frames * BlockSize];
+            Array.Copy(pack, data, pack.Length);
+
+            link.WriteLine("UPLOAD " + sectors);
+            string reply;
+            do
+            {
+                reply = link.ReadLine(ReplyTimeoutMs * 2);
+                if (reply == null || reply.StartsWith("Failed"))
+                {
+                    throw new IOException("The firmware refused the upload: " + (reply ?? "no reply") + ".");
+                }
+            } while (!reply.StartsWith("UPLOAD READY"));
+
+            // Waits for the firmware to switch baud rate and request the first frame.
+            link.SetBaudRate(UploadBaudRate);
+            int ready;
+            do
+            {
+                ready = link.ReadByte(ReplyTimeoutMs * 2);
+                if (ready < 0)
+                {
+                    throw new IOException("The firmware didn't request the first frame.");
+                }
+            } while (ready != Ack);
+
+            Stopwatch stopwatch = Stopwatch.StartNew();
+            byte[] frame = new byte[FrameSize];
+            int retries = 0;
+            for (int sequence = 0; sequence < frames; sequence++)
+            {
+                frame[0] = (byte)sequence;
+                frame[1] = (byte)(sequence >> 8);
+                Array.Copy(data, sequence * BlockSize, frame, 2, BlockSize);
+                ushort crc = Crc16(frame, 0, 2 + BlockSize);
+                frame[2 + BlockSize] = (byte)crc;
+                frame[3 + BlockSize] = (byte)(crc >> 8);
+
+                int attempts = 0;
+                while (true)
+                {
+                    link.Write(frame, 0, FrameSize);
+                    int answer = link.ReadByte(ReplyTimeoutMs);
+                    if (answer == Ack)
+                    {
+                        break;
+                    }
+                    retries++;
+                    if (++attempts > MaxRetries)
+                    {
+                        throw new IOException("Frame " + sequence + " was rejected " + attempts + " times.");
+                    }
+                }
+            }
+            stopwatch.Stop();
+
+            link.SetBaudRate(MonitorBaudRate);
+            do
+            {
+                reply = link.ReadLine(ResultTimeoutMs);
+                if (reply == null)
+                {
+                    throw new IOException("The firmware didn't report the result.");
+                }
+            } while (!reply.StartsWith("UPLOAD DONE") && !reply.StartsWith("UPLOAD FAILED"));
+            Console.WriteLine(reply);
+
+            double seconds = Math.Max(stopwatch.Elapsed.TotalSeconds, 0.001);
+            double bytesPerSecond = sectors * SectorSize / seconds;
+            Console.WriteLine("Sent {0} sectors in {1:F2} s, {2:F0} B/s ({3:F0}% of line rate), {4} retries.",
+                sectors, seconds, bytesPerSecond, 100.0 * bytesPerSecond / (UploadBaudRate / 10), retries);
+
+            Match match = Regex.Match(reply, "CRC32 ([0-9A-F]{8})");
+            uint expected = Crc32(data, 0, sectors * SectorSize);
+            if (!match.Success || Convert.ToUInt32(match.Groups[1].Value, 16) != expected)
+            {
+                throw new IOException(string.Format("The card doesn't hold the pack, expected CRC32 {0:X8}.", expected));
+            }
+            Console.WriteLine("Verified CRC32 {0:X8}.", expected);
+        }
+
+        /// <summary>
+        /// Returns the CRC-16/CCITT of a frame.
+        /// </summary>
+        public static ushort Crc16(byte[] data, int offset, int count)
+        {
+            ushort crc = 0xFFFF;
+            for (int i = offset; i < offset + count; i++)
+            {
+                crc ^= (ushort)(data[i] << 8);
+                for (int bit = 0; bit < 8; bit++)
+                {
+                    crc = (ushort)((crc & 0x8000) != 0 ? (crc << 1) ^ 0x1021 : crc << 1);
+                }
+            }
+            return crc;
+        }
+
+        /// <summary>
+        /// Returns the CRC-32 of the uploaded sectors.
+        /// </summary>
+        public static uint Crc32(byte[] data, int offset, int count)
+        {
+            uint crc = 0xFFFFFFFF;
+            for (int i = offset; i < offset + count; i++)
+            {
+                crc ^= data[i];
+                for (int bit = 0; bit < 8; bit++)
+                {
+                    crc = (crc & 1) != 0 ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+                }
+            }
+            return crc ^ 0xFFFFFFFF;
+        }
+    }
+
+    /// <summary>
+    /// Uploads through a serial port.
+    /// </summary>
+    class SerialUploadLink : IUploadLink
+    {
+        readonly SerialPort port;
+
+        public SerialUploadLink(string portName)
+        {
+            port = new SerialPort(portName, UploadSender.MonitorBaudRate, Parity.None, 8, StopBits.One);
+            port.NewLine = "\n\r";
+            port.ReadBufferSize = 16 * 1024;
+            port.WriteBufferSize = 16 * 1024;
+            port.Open();
+        }
+
+        public void WriteLine(string line)
+        {
+            port.Write(line + "\r");
+        }
+
+        public string ReadLine(int timeoutMs)
+        {
+            port.ReadTimeout = timeoutMs;
+            try
+            {
+                return port.ReadLine().TrimStart('>');
+            }
+            catch (TimeoutException)
+            {
+                return null;
+            }
+        }
+
+        public void Write(byte[] buffer, int offset, int count)
+        {
+            port.Write(buffer, offset, count);
+        }
+
+        public int ReadByte(int timeoutMs)
+        {
+            port.ReadTimeout = timeoutMs;
+            try
+            {
+                return port.ReadByte();
+            }
+            catch (TimeoutException)
+            {
+                return -1;
+            }
+        }
+
+        public void SetBaudRate(int baudRate)
+        {
+            port.BaseStream.Flush();
+            port.DiscardInBuffer();
+            port.BaudRate = baudRate;
+        }
+
+        public void Dispose()
+        {
+            port.Close();
+        }
+    }
+
+    /// <summary>
+    /// Uploads into a disk image instead of the instrument.
+    /// </summary>
+    /// <remarks>
+    /// Answers the upload the way UPLOAD.c does and writes the frames over the
+    /// pack sectors in the image, so the protocol and the written data can be
+    /// verified on the host. Every errorInterval-th frame is corrupted to exercise
+    /// the retries. The reported time is the time the frames take at line rate.
+    /// </remarks>
+    class ImageUploadLink : IUploadLink
+    {
+        readonly FileStream image;
+        readonly long firstSector;
+        readonly int errorInterval;
+        readonly Queue<string> lines = new Queue<string>();
+        readonly Queue<byte> bytes = new Queue<byte>();
+        int sectors;
+        int nextSequence;
+        int framesReceived;
+        int retries;
+        long lineBytes;
+
+        public ImageUploadLink(string imagePath, long firstSector, int errorInterval)
+        {
+            image = new FileStream(imagePath, FileMode.Open, FileAccess.ReadWrite);
+            this.firstSector = firstSector;
+            this.errorInterval = errorInterval;
+        }
+
+        public void WriteLine(string line)
+        {
+            Match match = Regex.Match(line, @"^UPLOAD (\d+)$");
+            if (match.Success && (firstSector + int.Parse(match.Groups[1].Value)) * UploadSender.SectorSize <= image.Length)
+            {
+                sectors = int.Parse(match.Groups[1].Value);
+                lines.Enqueue("UPLOAD READY " + sectors + " " + UploadSender.UploadBaudRate);
+            }
+            else
+            {
+                lines.Enqueue("Failed to start the upload.");
+            }
+        }
+
+        public string ReadLine(int timeoutMs)
+        {
+            return lines.Count > 0 ? lines.Dequeue() : null;
+        }
+
+        public void Write(byte[] buffer, int offset, int count)
+        {
+            byte[] frame = new byte[count];
+            Array.Copy(buffer, offset, frame, 0, count);
+            lineBytes += count + 1;
+            if (errorInterval > 0 && ++framesReceived % errorInterval == 0)
+            {
+                frame[count / 2] ^= 0x55;
+            }
+
+            int sequence = frame[0] | frame[1] << 8;
+            ushort crc = (ushort)(frame[count - 2] | frame[count - 1] << 8);
+            if (count != UploadSender.FrameSize || crc != UploadSender.Crc16(frame, 0, count - 2))
+            {
+                retries++;
+                bytes.Enqueue(UploadSender.Nak);
+            }
+            else if (sequence == nextSequence - 1)
+            {
+                bytes.Enqueue(UploadSender.Ack);
+            }
+            else if (sequence != nextSequence)
+            {
+                retries++;
+                bytes.Enqueue(UploadSender.Nak);
+            }
+            else
+            {
+                int sector = sequence * (UploadSender.BlockSize / UploadSender.SectorSize);
+                int length = Math.Min(UploadSender.BlockSize, (sectors - sector) * UploadSender.SectorSize);
+                image.Seek((firstSector + sector) * UploadSender.SectorSize, SeekOrigin.Begin);
+                image.Write(frame, 2, length);
+                nextSequence++;
+                bytes.Enqueue(UploadSender.Ack);
+            }
+        }
+
+        public int ReadByte(int timeoutMs)
+        {
+            return bytes.Count > 0 ? bytes.Dequeue() : -1;
+        }
+
+        public void SetBaudRate(int baudRate)
+        {
+            if (baudRate == UploadSender.UploadBaudRate)
+            {
+                bytes.Enqueue(UploadSender.Ack);
+                return;
+            }
+
+            // Reads the sectors back like the firmware does.
+            byte[] written = new byte[sectors * UploadSender.SectorSize];
+            image.Flush();
+            image.Seek(firstSector * UploadSender.SectorSize, SeekOrigin.Begin);
+            int read = 0;
+            while (read < written.Length)
+            {
+                int count = image.Read(written, read, written.Length - read);
+                if (count <= 0)
+                {
+                    break;
+                }
+                read += count;
+            }
+
+            long ms = lineBytes * 10 * 1000 / UploadSender.UploadBaudRate;
+            long bytesPerSecond = ms > 0 ? written.Length * 1000L / ms : 0;
+            lines.Enqueue(string.Format("UPLOAD DONE {0} sectors, {1} ms, {2} B/s, {3}% of line rate, {4} retries, CRC32 {5:X8}",
+                sectors, ms, bytesPerSecond, bytesPerSecond * 100 / (UploadSender.UploadBaudRate / 10), retries,
+                UploadSender.Crc32(written, 0, written.Length)));
+        }
+
+        public void Dispose()
+        {
+            image.Dispose();
+        }
+    }
+}
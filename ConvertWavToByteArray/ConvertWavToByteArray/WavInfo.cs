@@ -0,0 +1,177 @@
+﻿using System;
+using System.IO;
+using System.Text;
+
+namespace ConvertWavToByteArray
+{
+    /// <summary>
+    /// The header of a note WAV file.
+    /// </summary>
+    /// <remarks>
+    /// Only the header is read, the audio data is left in the file so it can be
+    /// streamed. The checks follow the WAV error codes in WAVDEF.h. The audio
+    /// data is only scanned up to the first sample above the noise floor.
+    /// </remarks>
+    class WavInfo
+    {
+        const int ChunkHeaderSize = 8;
+        const int NoiseFloor = 256;
+        const int PreRollFrames = 32;
+
+        public string Name;
+        public string FilePath;
+        public int Channels;
+        public int SampleRate;
+        public int ByteRate;
+        public int BlockAlign;
+        public int BitsPerSample;
+        public long DataOffset;
+        public uint DataSize;
+        public uint LoopStart;
+        public uint LoopLength;
+        public uint StartFrame;
+
+        /// <summary>
+        /// Reads the header of a WAV file.
+        /// </summary>
+        /// <param name="stream">The WAV file, positioned at its start.</param>
+        /// <param name="filePath">The path of the WAV file.</param>
+        /// <returns>The header, the stream is left at the audio data.</returns>
+        public static WavInfo Read(Stream stream, string filePath)
+        {
+            WavInfo info = new WavInfo();
+            string name = Path.GetFileName(filePath);
+            info.Name = name;
+            info.FilePath = filePath;
+            BinaryReader reader = new BinaryReader(stream, Encoding.ASCII);
+
+            byte[] riff = reader.ReadBytes(12);
+            if (riff.Length < 12)
+            {
+                throw new InvalidDataException(name + ": Header size is invalid.");
+            }
+            if (Encoding.ASCII.GetString(riff, 0, 4) != "RIFF")
+            {
+                throw new InvalidDataException(name + ": Chunk ID is invalid.");
+            }
+            if (Encoding.ASCII.GetString(riff, 8, 4) != "WAVE")
+            {
+                throw new InvalidDataException(name + ": Header format is invalid.");
+            }
+
+            // Walks the chunks, they are word aligned.
+            long position = 12;
+            bool hasFormat = false;
+            while (position + ChunkHeaderSize <= stream.Length)
+            {
+                stream.Position = position;
+                string id = Encoding.ASCII.GetString(reader.ReadBytes(4));
+                long size = Math.Min(reader.ReadUInt32(), stream.Length - position - ChunkHeaderSize);
+                long start = position + ChunkHeaderSize;
+
+                if (id == "fmt " && size >= 16)
+                {
+                    reader.ReadUInt16();
+                    info.Channels = reader.ReadUInt16();
+                    info.SampleRate = (int)reader.ReadUInt32();
+                    info.ByteRate = (int)reader.ReadUInt32();
+                    info.BlockAlign = reader.ReadUInt16();
+                    info.BitsPerSample = reader.ReadUInt16();
+                    hasFormat = true;
+                }
+                else if (id == "data")
+                {
+                    info.DataOffset = start;
+                    info.DataSize = (uint)size;
+                }
+                else if (id == "smpl" && size >= 52)
+                {
+                    stream.Position = start + 28;
+                    uint loops = reader.ReadUInt32();
+                    stream.Position = start + 44;
+                    uint loopStart = reader.ReadUInt32();
+                    uint loopEnd = reader.ReadUInt32();
+                    if (loops > 0 && loopEnd > loopStart)
+                    {
+                        info.LoopStart = loopStart;
+                        info.LoopLength = loopEnd - loopStart + 1;
+                    }
+                }
+                position = start + size + (size & 1);
+            }
+
+            if (!hasFormat)
+            {
+                throw new InvalidDataException(name + ": Chunk ID 1 is invalid.");
+            }
+            if (info.DataOffset == 0)
+            {
+                throw new InvalidDataException(name + ": Chunk ID 2 is invalid.");
+            }
+            if (info.BitsPerSample != 16 || info.Channels < 1 || info.Channels > 2 || info.BlockAlign != 2 * info.Channels)
+            {
+                throw new InvalidDataException(name + ": Chunk ID 1 data is invalid, only 16-bit mono or stereo is supported.");
+            }
+            if ((long)(info.LoopStart + info.LoopLength) * info.BlockAlign > info.DataSize)
+            {
+                info.LoopStart = 0;
+                info.LoopLength = 0;
+            }
+            info.StartFrame = FindStart(stream, info);
+            if (info.LoopLength > 0 && info.StartFrame >= info.LoopStart)
+            {
+                info.StartFrame = 0;
+            }
+
+            stream.Position = info.DataOffset;
+            return info;
+        }
+
+        /// <summary>
+        /// Returns the first sample frame above the noise floor.
+        /// </summary>
+        /// <remarks>
+        /// A short pre-roll is kept so the start of the pluck isn't cut. A note
+        /// that never rises above the noise floor is played from its start.
+        /// </remarks>
+        static uint FindStart(Stream stream, WavInfo info)
+        {
+            byte[] buffer = new byte[4096];
+            uint frames = info.DataSize / (uint)info.BlockAlign;
+            uint frame = 0;
+            stream.Position = info.DataOffset;
+            while (frame < frames)
+            {
+                int read = stream.Read(buffer, 0, (int)Math.Min(buffer.Length, (frames - frame) * info.BlockAlign));
+                read -= read % info.BlockAlign;
+                if (read <= 0)
+                {
+                    break;
+                }
+                for (int i = 0; i < read; i += 2)
+                {
+                    if (Math.Abs((int)BitConverter.ToInt16(buffer, i)) > NoiseFloor)
+                    {
+                        uint start = frame + (uint)(i / info.BlockAlign);
+                        return start > PreRollFrames ? start - PreRollFrames : 0;
+                    }
+                }
+                frame += (uint)(read / info.BlockAlign);
+            }
+            return 0;
+        }
+
+        /// <summary>
+        /// Reads the header of a WAV file.
+        /// </summary>
+        /// <param name="filePath">The path of the WAV file.</param>
+        /// <returns>The header.</returns>
+        public static WavInfo Read(string filePath)
+        {
+            using (FileStream stream = File.OpenRead(filePath))
+            {
+                return Read(stream, filePath);
+            }
+        }
+    }
+}
@@ -3,35 +3,65 @@
  * @author Kue Yang
  * @date 2/27/2017
  * @details The ADC module will handle reading strumming sensor data and 
- * kick start the audio playback process.
+ * kick start the audio playback process. The fret position sensors are 
+ * converted in the same scan and passed to the FRET module.
  */
 
 #include <p32xxxx.h>
+#include <stdio.h>
 #include "plib/plib.h"
 #include "HardwareProfile.h"
 #include "STDDEF.h"
 #include "IO.h"
 #include "TIMER.h"
+#include "STRUM.h"
+#include "CAPTURE.h"
+#include "LATENCY.h"
+#include "AUDIO.h"
+#include "UPLOAD.h"
+#include "FRET.h"
 #include "ADC.h"
 
 /**@def NUM_OF_ADCCHANNELS 
- * Defines the number of ADC channels used. */
-#define NUM_OF_ADCCHANNELS      1
-/** @def ADC_ARRAY_SIZE 
- * Defines the ADC local array size. */
-#define ADC_ARRAY_SIZE          5
+ * Defines the number of ADC channels used, one strumming sensor per string. */
+#define NUM_OF_ADCCHANNELS      4
+/**@def NUM_OF_ADCINPUTS 
+ * Defines the number of scanned inputs, a strumming and a position sensor per string. */
+#define NUM_OF_ADCINPUTS        (2*NUM_OF_ADCCHANNELS)
+/** @def ADC_SCAN_INPUTS 
+ * Defines the scanned inputs. Strumming sensors: AN2 (RB2), AN3 (RB3), AN4 (RB4)
+ * and AN28 (RG15). Position sensors: AN12 (RB12), AN13 (RB13), AN14 (RB14) and
+ * AN15 (RB15). */
+#define ADC_SCAN_INPUTS         ((1 << 2) | (1 << 3) | (1 << 4) | (1 << 12) | (1 << 13) | \
+                                 (1 << 14) | (1 << 15) | (1 << 28))
+/** @def ADC_POSITION 
+ * Defines the flag marking a scanned input as a position sensor. */
+#define ADC_POSITION            0x80
 /** @def ADC_MIDRAIL 
  * Defines the ADC mid-rail. */
 #define ADC_MIDRAIL             512
-/** @def ADC_NOISEMAG 
- * Defines the minimum noise magnitude ADC thread hold. */
-#define ADC_NOISEMAG            150         
-/** @def ADC_MINDELTA 
- * Defines the minimum change in ADC sample for indicating strum. */
-#define ADC_MINDELTA            10  
-/** @def ADC_MINSAMPLE 
- * Defines the minimum sample count for strum detection. */
-#define ADC_MINSAMPLE           256
+/** @def ADC_SCANS_PER_BLOCK 
+ * Defines the number of scans the DMA collects before the ADC interrupt hands 
+ * them to the strum detectors. */
+#ifndef ADC_SCANS_PER_BLOCK
+#define ADC_SCANS_PER_BLOCK     4
+#endif
+#if (ADC_SCANS_PER_BLOCK < 1) || (ADC_SCANS_PER_BLOCK > 255)
+#error "ADC_SCANS_PER_BLOCK must be 1 to 255, the DMA ring is limited to 64 KB."
+#endif
+/** @def ADC_BLOCK_SIZE 
+ * Defines the number of conversions collected per ADC interrupt. */
+#define ADC_BLOCK_SIZE          (ADC_SCANS_PER_BLOCK*NUM_OF_ADCINPUTS)
+/** @def ADC_BUF_STRIDE 
+ * Defines the spacing in words between the ADC1BUFx registers. */
+#define ADC_BUF_STRIDE          4
+/** @def ADC_SCAN_WORDS 
+ * Defines the number of words the DMA copies per scan, ADC1BUF0-ADC1BUF7 and 
+ * the unused words between them. */
+#define ADC_SCAN_WORDS          (NUM_OF_ADCINPUTS*ADC_BUF_STRIDE)
+/** @def ADC_SCAN_TICKS 
+ * Defines the core timer ticks between two scans of a string, 204.8 us. */
+#define ADC_SCAN_TICKS          4096
 
 #define ADC_SCALE_STEP          ADC_MIDRAIL/4
 #define ADC_SCALE_1P            ADC_MIDRAIL+ADC_SCALE_STEP
@@ -44,23 +74,36 @@
 #define ADC_SCALE_4N            ADC_MIDRAIL-4*ADC_SCALE_STEP
 
 
-/** @var isPositive 
- * Indicates if the sample is the positive or negative part of signal. */
-BOOL isPositive;
-/** @var peakMax 
- * Stores max values for a single peak. */
-UINT16 peakMax[ADC_ARRAY_SIZE];
-/** @var localMax 
- * Stores max values for different peaks. */
-UINT16 localMax[ADC_ARRAY_SIZE];
-/** @var sampleCount 
- * Counts the number of adc samples since playing a tone. */
-UINT32 sampleCount;
-/** @var startStrumDetection 
- * Boolean used to enable the strum detection. */
-BOOL startStrumDetection;
+/** @var adcScanString 
+ * Maps each scanned input, in ascending AN order, to its string. The position
+ * sensors are flagged with ADC_POSITION. */
+const UINT8 adcScanString[NUM_OF_ADCINPUTS] = {1, 2, 3, ADC_POSITION | 3, ADC_POSITION | 2,
+        ADC_POSITION | 1, ADC_POSITION | 0, 0};
+/** @var adcRing 
+ * The ring the DMA copies each scan into, two blocks of ADC_SCANS_PER_BLOCK 
+ * scans. The ADC interrupt reads one block while the DMA fills the other. */
+UINT32 adcRing[2*ADC_BLOCK_SIZE*ADC_BUF_STRIDE];
+/** @var strum 
+ * The strum detectors, one per string. */
+STRUM strum[NUM_OF_ADCCHANNELS];
+/** @var strumCount 
+ * Counts the number of strums detected per string. */
+UINT32 strumCount[NUM_OF_ADCCHANNELS];
+/** @var strumVelocity 
+ * Stores the velocity of the last strum per string. */
+UINT16 strumVelocity[NUM_OF_ADCCHANNELS];
+/** @var detectTicks 
+ * Accumulates the core timer ticks spent in the strum detectors. */
+UINT32 detectTicks;
+/** @var detectScans 
+ * Counts the number of scans run through the strum detectors. */
+UINT32 detectScans;
 
-void ADC_ZeroBuffer(void);
+void ADC_ReadBlock(const UINT32* block, UINT16 samples[][ADC_SCANS_PER_BLOCK], 
+        UINT16 positions[][NUM_OF_ADCCHANNELS]);
+void ADC_ProcessBlock(const UINT32* block, UINT32 blockTicks);
+void ADC_Strum(int string, UINT32 blockTicks);
+void ADC_SetVelocity(int string);
 int ADC_GetScaleFactor(UINT16 localMax);
 
 /**
@@ -79,128 +122,249 @@ void ADC_Init(void)
     /* AD2CON configurations */
     AD1CON2bits.VCFG = 0b000;       // AVDD and AVSS are the voltage references
     AD1CON2bits.OFFCAL = 0;         // Input offset calibration mode disabled
-    AD1CON2bits.CSCNA = 0;          // Scans inputs disabled
-    AD1CON2bits.SMPI = 0b0000;      // Interrupts at the completion of conversion for each sample/convert sequence
-    AD1CON2bits.BUFM = 0;           // Buffer  is configured as one 16-Word buffer
+    AD1CON2bits.CSCNA = 1;          // Scans the inputs selected by AD1CSSL
+    AD1CON2bits.SMPI = NUM_OF_ADCINPUTS-1;  // Interrupts at the completion of every scan, triggers the DMA
+    AD1CON2bits.BUFM = 0;           // Buffer is configured as one 16-Word buffer, the DMA empties it
     AD1CON2bits.ALTS = 0;           // Always use sample A input multiplexer settings
     
-    /* AD3CON configurations. Samples every 51.2 us.*/
+    /* AD3CON configurations. Each input is sampled every 204.8 us.*/
     AD1CON3bits.ADRC = 0;           // ADC conversion clock is PBCLK, TPB = 1/PCLK = 25 ns
-    AD1CON3bits.ADCS = 0xFF;        // ADC conversion clock, TAD = 512*TPB = 12.8 us
+    AD1CON3bits.ADCS = 0x1F;        // ADC conversion clock, TAD = 64*TPB = 1.6 us
     AD1CON3bits.SAMC = 0b00100;     // Sample Time period, 4 TADs
     
     /* AD1CH configurations */
     AD1CHSbits.CH0NA = 0;           // Channel 0 negative input is VREFL
-    AD1CHSbits.CH0SA = 0x001C;      // Channel 0 positive input for Sample A is AN28
+    AD1CHSbits.CH0SA = 0x001C;      // Channel 0 positive input for Sample A is AN28, ignored while scanning
     
     /* AD1CSSL configurations */
-    AD1CSSLbits.CSSL = 0x001C;      // Selects AN28 for input scan, all others are skipped
+    AD1CSSL = ADC_SCAN_INPUTS;      // Selects the strumming and position sensors for input scan, all others are skipped
+    
+    /* DMA channel 0 copies each scan into the ring */
+    DMACONbits.ON = 1;                      // Enables the DMA controller
+    DCH0CON = 0;
+    DCH0CONbits.CHPRI = 3;                  // Highest channel priority
+    DCH0CONbits.CHAEN = 1;                  // Channel restarts at the top of the ring when it is full
+    DCH0ECON = 0;
+    DCH0ECONbits.CHSIRQ = _ADC_IRQ;         // Starts a cell transfer at the end of every scan
+    DCH0ECONbits.SIRQEN = 1;
+    DCH0SSA = KVA_TO_PA((void*)&ADC1BUF0);
+    DCH0DSA = KVA_TO_PA((void*)&adcRing[0]);
+    DCH0SSIZ = ADC_SCAN_WORDS*sizeof(UINT32);   // ADC1BUF0-ADC1BUF7
+    DCH0DSIZ = sizeof(adcRing);
+    DCH0CSIZ = ADC_SCAN_WORDS*sizeof(UINT32);   // One scan per ADC event
+    DCH0INTCLR = 0x00FF00FF;
+    DCH0INTbits.CHDHIE = 1;                 // Interrupts when the first block is full
+    DCH0INTbits.CHDDIE = 1;                 // Interrupts when the second block is full
+    DCH0CONbits.CHEN = 1;
+    
+    // The ADC interrupt only triggers the DMA
+    IFS0bits.AD1IF = 0;
+    IEC0bits.AD1IE = 0;
     
     AD1CON1bits.ON = 1;             // Enables ADC
     AD1CON1bits.ASAM = 1;           // Sampling begins immediately
     
-    // Set up the ADC interrupt with a priority of 2
-    IFS0bits.AD1IF = 0;
-    IEC0bits.AD1IE = 1;
-    IPC5bits.AD1IP = 2;
-    IPC5bits.AD1IS = 3;
-    
-    // Initializes strumming variables
-    ADC_ZeroBuffer();
-    isPositive = FALSE;
-    sampleCount = 0;
-    startStrumDetection = TRUE;
-}
-
-/**
- * @brief Reinitializes ADC buffers to the midrail.
- * @return Void
- */
-void ADC_ZeroBuffer(void)
-{
+    // Set up the DMA interrupt with a priority of 2, the priority of the monitor
+    IFS1bits.DMA0IF = 0;
+    IEC1bits.DMA0IE = 1;
+    IPC10bits.DMA0IP = 2;
+    IPC10bits.DMA0IS = 3;
+    
+    // Initializes the strum detectors
     int i = 0;
-    for(i = 0; i < ADC_ARRAY_SIZE; i++)
+    for(i = 0; i < NUM_OF_ADCCHANNELS; i++)
     {
-        peakMax[i] = ADC_MIDRAIL;
-        localMax[i] = ADC_MIDRAIL;
+        STRUM_Init(&strum[i], ADC_MIDRAIL);
+        strumCount[i] = 0;
+        strumVelocity[i] = 0;
     }
+    detectTicks = 0;
+    detectScans = 0;
 }
 
 /**
- * @brief ADC Interrupt Service Routine.
- * @details The interrupt service routine is used read the strummer sensor.
- * @return Void.
+ * @brief Reads a block of conversions from the DMA ring.
+ * @details Each scan in the ring is a copy of ADC1BUF0-ADC1BUF7, so the inputs
+ * are ADC_BUF_STRIDE words apart. The strumming samples are separated by 
+ * string and the position readings by scan.
+ * @arg block The block of the ring that has been filled.
+ * @arg samples The block used to store ADC_SCANS_PER_BLOCK samples per string.
+ * @arg positions The array used to store the position readings of each scan.
+ * @return Void
  */
-void __ISR(_ADC_VECTOR, IPL2AUTO) ADCHandler(void)
+void ADC_ReadBlock(const UINT32* block, UINT16 samples[][ADC_SCANS_PER_BLOCK], 
+        UINT16 positions[][NUM_OF_ADCCHANNELS])
 {
-    CLEAR_WATCHDOG_TIMER;
-            
-    // Reads the ADC buffer
-    UINT16 adcSample = (UINT16)ADC1BUF0;
-    sampleCount++;
+    UINT8 input = 0;
+    int i = 0;
     
-    if(adcSample >= (ADC_MIDRAIL+ADC_NOISEMAG) || adcSample <= (ADC_MIDRAIL-ADC_NOISEMAG))
+    for(i = 0; i < ADC_BLOCK_SIZE; i++)
     {
-        if(adcSample >= ADC_MIDRAIL)
+        input = adcScanString[i%NUM_OF_ADCINPUTS];
+        if(input & ADC_POSITION)
         {
-            isPositive = TRUE;
+            positions[i/NUM_OF_ADCINPUTS][input & ~ADC_POSITION] = (UINT16)block[i*ADC_BUF_STRIDE];
         }
         else
         {
-            isPositive = FALSE;
+            samples[input][i/NUM_OF_ADCINPUTS] = (UINT16)block[i*ADC_BUF_STRIDE];
         }
+    }
+}
 
-        // Stores the biggest sample read by magnitude
-        if(isPositive && (adcSample > peakMax[0]))
+/**
+ * @brief Handles a strum detected on a string.
+ * @details Counts the strum. A strum on the local string sets the new tone and 
+ * starts the audio playback unless a sample pack is being uploaded. The tone is
+ * unscaled until the strum velocity settles. The strum onset is estimated from
+ * the number of scans since the strum threshold was crossed.
+ * @arg string The string that has been strummed.
+ * @arg blockTicks The core timer count when the block was received.
+ * @return Void
+ */
+void ADC_Strum(int string, UINT32 blockTicks)
+{
+    strumCount[string]++;
+    
+    if(string == ADC_LOCAL_STRING && !UPLOAD_IsActive())
+    {
+        LATENCY_Start(blockTicks - STRUM_GetAge(&strum[string])*ADC_SCAN_TICKS);
+        LATENCY_Mark(LATENCY_DECISION);
+        AUDIO_setNewTone(IO_getFret(), ADC_GetScaleFactor(ADC_MIDRAIL), TRUE);    // Sets the file to be read.
+        if(!TIMER3_IsON())
         {
-            peakMax[4] = peakMax[3];
-            peakMax[3] = peakMax[2]; 
-            peakMax[2] = peakMax[1];
-            peakMax[1] = peakMax[0]; 
-            peakMax[0] = adcSample;
+            TIMER3_ON(TRUE);                            // Kick starts reading the audio file process.
+            MON_SendString("ADC: Turning on timer.");
         }
+    }
+}
 
-        // Checks if sample changes polarity
-        if(!isPositive && (peakMax[0] > ADC_MIDRAIL))
-        {
-            // Takes the average of the local max
-            localMax[4] = localMax[3];
-            localMax[3] = localMax[2];
-            localMax[2] = localMax[1];
-            localMax[1] = localMax[0];
-            localMax[0] = 2*(peakMax[4] + peakMax[3] + peakMax[2] + peakMax[1] + peakMax[0])/10;
-            UINT16 tempMax = (localMax[4] + localMax[3] + localMax[2] + localMax[1])/4;
+/**
+ * @brief Handles a strum velocity that has settled.
+ * @details Records the strum velocity. The velocity of a strum on the local 
+ * string scales its tone.
+ * @arg string The string that has been strummed.
+ * @return Void
+ */
+void ADC_SetVelocity(int string)
+{
+    strumVelocity[string] = STRUM_GetVelocity(&strum[string]);
+    
+    if(string == ADC_LOCAL_STRING && !UPLOAD_IsActive())
+    {
+        AUDIO_SetToneFactor(ADC_GetScaleFactor(ADC_MIDRAIL + strumVelocity[string]));
+    }
+}
 
-            // Compares local maxs to determine if user has strum.
-            if((localMax[0] > (tempMax+ADC_MINDELTA)) && startStrumDetection)
-            {
-                AUDIO_setNewTone(IO_scanFrets(), ADC_GetScaleFactor(localMax[0]));                // Sets the file to be read.
-                if(!TIMER3_IsON())
-                {
-                    TIMER3_ON(TRUE);                            // Kick starts reading the audio file process.
-                    MON_SendString("ADC: Turning on timer.");
-                }
-                sampleCount = 0;
-                startStrumDetection = FALSE;
-            }
+/**
+ * @brief Displays the strum detector statistics.
+ * @details Displays the strum count and last velocity of each string, the 
+ * average cost of running all the strum detectors for one scan and the ADC 
+ * interrupt rate.
+ * @return Void
+ */
+void ADC_ShowStrumStats(void)
+{
+    char buf[64];
+    int i = 0;
+    
+    for(i = 0; i < NUM_OF_ADCCHANNELS; i++)
+    {
+        snprintf(&buf[0], 64, "String %d: %u strums, velocity %u", i, strumCount[i], strumVelocity[i]);
+        MON_SendString(&buf[0]);
+    }
+    
+    // The core timer ticks once every two system clocks.
+    if(detectScans > 0)
+    {
+        snprintf(&buf[0], 64, "Detector cost: %u cycles per scan of %d strings", 
+                (detectTicks*2)/detectScans, NUM_OF_ADCCHANNELS);
+        MON_SendString(&buf[0]);
+    }
+    snprintf(&buf[0], 64, "ADC interrupt: %d scans, every %d us", ADC_SCANS_PER_BLOCK, 
+            (ADC_SCANS_PER_BLOCK*ADC_SCAN_TICKS)/TIMER_TICKS_PER_US);
+    MON_SendString(&buf[0]);
+}
 
-            ADC_ZeroBuffer();
+/**
+ * @brief Runs a block of scans through the strum detectors.
+ * @details The position readings of each scan are passed to the FRET module 
+ * and the strums are handled after every detector has run.
+ * @arg block The block of the ring that has been filled.
+ * @arg blockTicks The core timer count when the block was received.
+ * @return Void
+ */
+void ADC_ProcessBlock(const UINT32* block, UINT32 blockTicks)
+{
+    UINT16 samples[NUM_OF_ADCCHANNELS][ADC_SCANS_PER_BLOCK];
+    UINT16 positions[ADC_SCANS_PER_BLOCK][NUM_OF_ADCCHANNELS];
+    BOOL isStrum[NUM_OF_ADCCHANNELS];
+    UINT32 startTicks;
+    int i = 0;
+    
+    // Reads the block and runs the strum detectors
+    ADC_ReadBlock(block, samples, positions);
+    for(i = 0; i < ADC_SCANS_PER_BLOCK; i++)
+    {
+        FRET_AddReadings(&positions[i][0]);
+    }
+    startTicks = TIMER_GetCoreTicks();
+    for(i = 0; i < NUM_OF_ADCCHANNELS; i++)
+    {
+        isStrum[i] = STRUM_DetectBlock(&strum[i], &samples[i][0], ADC_SCANS_PER_BLOCK);
+    }
+    detectTicks += TIMER_GetCoreTicks() - startTicks;
+    detectScans += ADC_SCANS_PER_BLOCK;
+    
+    // Records the captured string for replay
+    if(CAPTURE_IsRunning())
+    {
+        i = CAPTURE_GetString();
+        CAPTURE_AddBlock(&samples[i][0], ADC_SCANS_PER_BLOCK, IO_getFret(), isStrum[i]);
+    }
+    
+    // Handles the strums after the detectors have run
+    for(i = 0; i < NUM_OF_ADCCHANNELS; i++)
+    {
+        if(isStrum[i])
+        {
+            ADC_Strum(i, blockTicks);
         }
-
-        if(sampleCount >= ADC_MINSAMPLE)
+        if(STRUM_HasSettled(&strum[i], ADC_SCANS_PER_BLOCK))
         {
-            startStrumDetection = TRUE;
+            ADC_SetVelocity(i);
         }
     }
+}
+
+/**
+ * @brief ADC DMA Interrupt Service Routine.
+ * @details The interrupt service routine is used read the strummer sensors. The
+ * DMA copies every scan into the ring and interrupts once every 
+ * ADC_SCANS_PER_BLOCK scans, when one half of the ring is full. The full half
+ * is run through the strum detector of each string.
+ * @return Void.
+ */
+void __ISR(_DMA_0_VECTOR, IPL2AUTO) ADCHandler(void)
+{
+    CLEAR_WATCHDOG_TIMER;
+            
+    UINT32 blockTicks = TIMER_GetCoreTicks();
     
-    // Resets the sample counter if overflows
-    if(sampleCount >= INT32_MAX_NUM)
+    // Handles the half of the ring that the DMA has filled
+    if(DCH0INTbits.CHDHIF)
+    {
+        DCH0INTCLR = _DCH0INT_CHDHIF_MASK;
+        ADC_ProcessBlock(&adcRing[0], blockTicks);
+    }
+    if(DCH0INTbits.CHDDIF)
     {
-        sampleCount = 0;
+        DCH0INTCLR = _DCH0INT_CHDDIF_MASK;
+        ADC_ProcessBlock(&adcRing[ADC_BLOCK_SIZE*ADC_BUF_STRIDE], blockTicks);
     }
     
     // Clear the interrupt flag
-    IFS0bits.AD1IF = 0;
+    IFS1bits.DMA0IF = 0;
     
     CLEAR_WATCHDOG_TIMER;
 }
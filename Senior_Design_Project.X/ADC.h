@@ -11,7 +11,12 @@
 extern "C" {
 #endif
 
+/** @def ADC_LOCAL_STRING 
+ * Defines the string played by this board's audio output. */
+#define ADC_LOCAL_STRING        0
+
 void ADC_Init(void);
+void ADC_ShowStrumStats(void);
 
 #ifdef	__cplusplus
 }
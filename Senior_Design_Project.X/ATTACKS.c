@@ -0,0 +1,15 @@
+/**
+ * @file ATTACKS.c
+ * @details Generated by ConvertWavToByteArray from 0 WAV files with 300 ms attacks. Do not edit.
+ * Flash usage: 0 bytes (0.0% of 512 KB).
+ */
+
+#include <stddef.h>
+#include "STDDEF.h"
+#include "ATTACKS.h"
+
+/** @var attacks 
+ * The list of note attacks, ends with a NULL file name. */
+const ATTACK attacks[] = {
+    {NULL, 0, NULL}
+};
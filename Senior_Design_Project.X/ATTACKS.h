@@ -0,0 +1,39 @@
+/**
+ * @file ATTACKS.h
+ * @author Kue Yang
+ * @date 10/19/2026
+ */
+
+#ifndef ATTACKS_H
+#define	ATTACKS_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include "STDDEF.h"
+
+/**
+ * @brief ATTACK data structure.
+ * @details The ATTACK data structure stores the start of a note that is held
+ * in program flash. The data is the first bytes of the WAV audio data.
+ */
+typedef struct ATTACK
+{
+    /**@{*/
+    const char* fileName;       /**< Variable used to store the name of the WAV file. */
+    UINT32 size;                /**< Variable used to store the size of the attack in bytes. */
+    const BYTE* data;           /**< Variable used to point to the attack in program flash. */
+    /**@}*/
+}ATTACK;
+
+/** @var attacks 
+ * The list of note attacks generated by ConvertWavToByteArray. */
+extern const ATTACK attacks[];
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* ATTACKS_H */
+
@@ -4,7 +4,11 @@
  * @date 11/22/2016
  * @details The Audio module will handle all audio processing related tasks.
  * Tasks includes: initializing Fatfs File System library, 
- * reading data from external memory and writing audio data to the DACs.
+ * reading data from external memory and writing audio data to the DACs. The 
+ * notes are decoded and resampled by the main loop in blocks of 
+ * AUDIO_BLOCK_FRAMES frames, the Timer 3 interrupt only copies one frame out 
+ * to the DACs. While the card is recovering, notes are played from the attacks
+ * in flash and the sustain loops in RAM.
  * @remarks The Audio module requires Fatfs File System library. The library
  * uses the library from the pic24 example project.
  */
@@ -12,19 +16,90 @@
 #include <p32xxxx.h>
 #include <stdio.h>
 #include <string.h>
+#include "plib/plib.h"
 #include "STDDEF.h"
 #include "IO.h"
 #include "DAC.h"
+#include "TIMER.h"
 #include "FILES.h"
 #include "FILEDEF.h"
+#include "PACKDEF.h"
+#include "LATENCY.h"
+#include "RESAMPLE.h"
+#include "ATTACKS.h"
+#include "UPLOAD.h"
+#include "JITTER.h"
+#include "READAHEAD.h"
 #include "AUDIO.h"
 
-UINT8 AUDIO_GetHeader(int index);
+/** @def AUDIO_RESAMPLE_MODE 
+ * Defines the interpolation used to resample the root samples. */
+#define AUDIO_RESAMPLE_MODE     RESAMPLE_CUBIC
+/** @def AUDIO_RESAMPLE_MAX_OUT 
+ * Defines the most output samples produced per source sample, a step of half a
+ * sample (one octave down) produces up to 3. */
+#define AUDIO_RESAMPLE_MAX_OUT  3
+/** @def AUDIO_SOURCE_FRAMES 
+ * Defines the most frames decoded from the note at once, a receive buffer. */
+#define AUDIO_SOURCE_FRAMES     (REC_BUF_SIZE/4)
+/** @def AUDIO_LOOP_SIZE 
+ * Defines the longest sustain loop, in sample frames, held in RAM per root. */
+#define AUDIO_LOOP_SIZE         2048
+/** @def AUDIO_LOOP_FADE 
+ * Defines the number of sample frames crossfaded at the loop seam. */
+#define AUDIO_LOOP_FADE         64
+/** @def AUDIO_LOOP_FULL_GAIN 
+ * Defines the sustain gain at the start of the loop, 1.0 in Q30. */
+#define AUDIO_LOOP_FULL_GAIN    (1L << 30)
+/** @def AUDIO_LOOP_MIN_GAIN 
+ * Defines the sustain gain the note ends at, about -54 dB. */
+#define AUDIO_LOOP_MIN_GAIN     (1L << 21)
+/** @def AUDIO_LOOP_DECAY_SHIFT 
+ * Defines the sustain decay time constant, 2^15 source samples. */
+#define AUDIO_LOOP_DECAY_SHIFT  15
+/** @def AUDIO_BENCHMARK_SAMPLES 
+ * Defines the number of source samples used to benchmark the resampler. */
+#define AUDIO_BENCHMARK_SAMPLES 256
+/** @def AUDIO_BENCHMARK_BYTES 
+ * Defines the number of note bytes used to benchmark the decoder. */
+#define AUDIO_BENCHMARK_BYTES   8192
+/** @def AUDIO_PREFETCH_SIZE 
+ * Defines the bytes of the opening of a note prefetched when its fret is 
+ * pressed, two sectors. */
+#define AUDIO_PREFETCH_SIZE     1024
+/** @def AUDIO_NO_PREFETCH 
+ * Defines the root sample index used when no opening is prefetched. */
+#define AUDIO_NO_PREFETCH       0xFFFF
+/** @def AUDIO_REFILL_URGENT 
+ * Defines the refill priority when the audio buffers are less than a quarter 
+ * full, above every other task. */
+#define AUDIO_REFILL_URGENT     7
+/** @def AUDIO_REFILL_NORMAL 
+ * Defines the refill priority when the audio buffers are less than half full. */
+#define AUDIO_REFILL_NORMAL     5
+/** @def AUDIO_REFILL_LOW 
+ * Defines the refill priority when the audio buffers are at least half full. */
+#define AUDIO_REFILL_LOW        2
+
+BOOL AUDIO_LoadLoop(int index);
+void AUDIO_FindAttack(int index);
+void AUDIO_FindStart(int index);
 BOOL AUDIO_GetAudioData(FILES* file, UINT16 bytes);
+BOOL AUDIO_GetLoopData(UINT16 frames);
+BOOL AUDIO_isLooping(void);
+void AUDIO_RunDecodeBenchmark(void);
+void AUDIO_RunPrefetch(UINT16 index);
+UINT32 AUDIO_SumSamples(const BYTE* data, UINT16 bytes);
+INT16 AUDIO_GetMonoSample(BYTE* frame, UINT16 numOfChannels);
+UINT16 AUDIO_GetBufferSpace(void);
+void AUDIO_StartTone(void);
+void AUDIO_RenderBlock(void);
+void AUDIO_QueueBlock(BOOL isEnd);
+void AUDIO_ClearBlocks(void);
 
 /** @var files 
- * The list of audio files that are to be used. */
-FILES files[MAX_NUM_OF_FILES];
+ * The list of root samples in the sample pack that are to be used. */
+FILES files[NUM_OF_ROOTS];
 /** @var receiveBuffer
  * A buffer used to store data read from the audio file. */
 BYTE receiveBuffer[REC_BUF_SIZE];
@@ -35,90 +110,406 @@ UINT16 LAUDIOSTACK[AUDIO_BUF_SIZE];
  * A buffer used to store right channel audio data. */
 UINT16 RAUDIOSTACK[AUDIO_BUF_SIZE];
 /** @var fileIndex 
- * The index used to specify the audio file that is being read. */
+ * The index used to specify the root sample file that is being read. */
 UINT16 fileIndex;
-/** @var audioInPtr 
- * The index used to store audio data into to audio buffer. */
-UINT16 audioInPtr;
-/** @var audioOutPtr 
- * The index used to write audio data out of the audio buffer. */
-UINT16 audioOutPtr;
 /** @var bytesRead 
  * Stores the number of bytes that have been read. */
 UINT32 bytesRead;
-/** @var bytesWritten 
- * Stores the number of bytes that have been written. */
-UINT32 bytesWritten;
-/** @var hasReadFile 
- * Stores boolean indicating the specified audio file has been read. */
-BOOL hasReadFile;
+/** @var framesQueued 
+ * The number of frames queued in the audio buffers, only written by the main 
+ * loop while the output is on. The buffer index is the count masked. */
+volatile UINT32 framesQueued;
+/** @var framesWritten 
+ * The number of frames written to the DACs, only written by the Timer 3 
+ * interrupt while the output is on. */
+volatile UINT32 framesWritten;
+/** @var isEndQueued 
+ * Stores boolean indicating the last block of the note has been queued. */
+volatile BOOL isEndQueued;
+/** @var isTonePending 
+ * Stores boolean indicating a new tone has been set and not yet started by the
+ * refill task. The Timer 3 interrupt holds the output meanwhile. */
+volatile BOOL isTonePending;
+/** @var toneFret 
+ * The fret of the pending tone. */
+volatile int toneFret;
+/** @var toneFactor 
+ * The scaling factor of the pending tone. */
+volatile UINT16 toneFactor;
+/** @var isToneStrum 
+ * Stores boolean indicating the pending tone was started by a strum. */
+volatile BOOL isToneStrum;
+/** @var sourceLeft 
+ * The left channel frames decoded from the note and not yet resampled. */
+INT16 sourceLeft[AUDIO_SOURCE_FRAMES];
+/** @var sourceRight 
+ * The right channel frames decoded from the note and not yet resampled. */
+INT16 sourceRight[AUDIO_SOURCE_FRAMES];
+/** @var sourceCount 
+ * The number of frames in the source buffers. */
+UINT16 sourceCount;
+/** @var sourceIndex 
+ * The index of the next source frame resampled. */
+UINT16 sourceIndex;
+/** @var blockLeft 
+ * The left channel of the block being rendered, with room for the frames the 
+ * resampler produces past the block. */
+INT16 blockLeft[AUDIO_BLOCK_FRAMES + AUDIO_RESAMPLE_MAX_OUT - 1];
+/** @var blockRight 
+ * The right channel of the block being rendered. */
+INT16 blockRight[AUDIO_BLOCK_FRAMES + AUDIO_RESAMPLE_MAX_OUT - 1];
+/** @var blockCount 
+ * The number of frames rendered into the block. */
+UINT16 blockCount;
+/** @var blocksRendered 
+ * The number of blocks rendered. */
+UINT32 blocksRendered;
+/** @var renderTicks 
+ * The core timer ticks spent rendering blocks. */
+UINT64 renderTicks;
+/** @var renderMaxTicks 
+ * The longest block render in core timer ticks. */
+UINT32 renderMaxTicks;
+/** @var copyFrames 
+ * The number of frames copied out to the DACs. */
+UINT32 copyFrames;
+/** @var copyTicks 
+ * The core timer ticks spent copying frames out to the DACs. */
+UINT64 copyTicks;
+/** @var copyMaxTicks 
+ * The longest frame copy in core timer ticks. */
+UINT32 copyMaxTicks;
 
 UINT16 scaleFactor;
 
+/** @var resampleLeft 
+ * The resampler used for the left channel. */
+RESAMPLE resampleLeft;
+/** @var resampleRight 
+ * The resampler used for the right channel. */
+RESAMPLE resampleRight;
+/** @var loopBuffers 
+ * The sustain loop of each root sample. */
+INT16 loopBuffers[NUM_OF_ROOTS][AUDIO_LOOP_SIZE];
+/** @var loopIndex 
+ * The index of the next sample read from the sustain loop. */
+UINT16 loopIndex;
+/** @var loopGain 
+ * The gain of the sustain loop in Q30. */
+INT32 loopGain;
+/** @var currentFret 
+ * The fret the ringing note is played at. */
+int currentFret;
+/** @var pendingFret 
+ * The fret read by the last fret scan, used to debounce slides. */
+int pendingFret;
+/** @var slideMode 
+ * Stores how the ringing note follows the finger, AUDIO_SLIDE_OFF if it doesn't. */
+UINT8 slideMode;
+/** @var isDecodeBenchmark 
+ * Stores boolean indicating the decoder is benchmarked once playback stops. */
+BOOL isDecodeBenchmark;
+/** @var prefetchBuffer 
+ * The opening of the note whose fret is pressed, read before the strum. */
+BYTE prefetchBuffer[AUDIO_PREFETCH_SIZE];
+/** @var prefetchIndex 
+ * The root sample held in the prefetch buffer, AUDIO_NO_PREFETCH if none. */
+volatile UINT16 prefetchIndex;
+/** @var prefetchRequest 
+ * The root sample of the fret that was pressed, AUDIO_NO_PREFETCH if none. */
+volatile UINT16 prefetchRequest;
+/** @var prefetchStart 
+ * The offset in the audio data of the first byte in the prefetch buffer. */
+UINT32 prefetchStart;
+/** @var prefetchSize 
+ * The number of bytes in the prefetch buffer. */
+UINT16 prefetchSize;
+/** @var prefetchTicks 
+ * The core timer ticks the prefetch took, the latency saved by a hit. */
+UINT32 prefetchTicks;
+/** @var prefetchReads 
+ * The number of openings prefetched. */
+UINT32 prefetchReads;
+/** @var prefetchHits 
+ * The number of strummed tones whose opening was prefetched. */
+UINT32 prefetchHits;
+/** @var prefetchMisses 
+ * The number of strummed tones read cold from the card. */
+UINT32 prefetchMisses;
+/** @var prefetchSavedTicks 
+ * The core timer ticks of card reads saved by prefetch hits. */
+UINT32 prefetchSavedTicks;
+/** @var cardSkips 
+ * The number of notes continued from RAM, or ended, because the card was down. */
+UINT32 cardSkips;
+
 /**
  * @brief Initializes the Audio module.
- * @details Initializes the SD card and Microchip MDD File library. After 
- * initialization, all the audio files that are specific to the PIC are opened.
+ * @details Initializes the FILES module. The SD card is brought up by the card
+ * task, which opens the sample pack and finds the root samples of the string 
+ * played by the PIC once the card is mounted.
  * @return Void
  */
 void AUDIO_Init(void)
 {
-    // Checks to make sure that the SD card is attached and initialized
+    // The card is initialized and mounted by the card task.
     FILES_Init();
+    cardSkips = 0;
+    // The read-ahead is tuned to the card as it is read.
+    READAHEAD_Init();
+
+    isTonePending = FALSE;
+    AUDIO_ClearBlocks();
+
+    // Slides are disabled until enabled from the monitor.
+    slideMode = AUDIO_SLIDE_OFF;
+    isDecodeBenchmark = FALSE;
+    prefetchRequest = AUDIO_NO_PREFETCH;
+    AUDIO_ClearPrefetch();
     
-    // Opens all related audio files.
+    /* 
+     * The end of a note is handled by core software interrupt 0 at the priority
+     * of the strum interrupt, which also sets new tones.
+     */
+    CoreClearSoftwareInterrupt0();
+    IFS0bits.CS0IF = 0;
+    IPC0bits.CS0IP = 2;
+    IPC0bits.CS0IS = 0;
+    IEC0bits.CS0IE = 1;
+}
+
+/**
+ * @brief Loads the root samples from the sample pack.
+ * @details Opens the sample pack once, every note is read from it. The root 
+ * samples are found in the note table and their sustain loops are copied into 
+ * RAM. Called by the card task once the card is mounted and again once a new
+ * pack has been uploaded.
+ * @return Void
+ */
+void AUDIO_LoadPack(void)
+{
     int i = 0;
-    for(i = 0; i < MAX_NUM_OF_FILES; i++)
+    
+    // The prefetched opening belongs to the previous pack.
+    prefetchIndex = AUDIO_NO_PREFETCH;
+    
+    if(FILES_OpenPack(PACK_FILE_NAME) != FR_OK)
     {
-        // Opens the given file and sets a pointer to the file.
-        FILES_OpenFile(&files[i].File, fileNames[i],FA_READ);
-        // Copies the files name.
-        strncpy(&files[i].audioInfo.fileName[0], fileNames[i], sizeof(files[i].audioInfo.fileName));
-        // Reads the file header.
-        AUDIO_GetHeader(i);
-        // Sets the file start pointer.
-        files[i].startPtr = files[i].File.fptr;
-        files[i].cluster = files[i].File.clust;
-        files[i].sector = files[i].File.sect;
+        MON_SendString("Failed to open the sample pack.");
     }
-
+    
+    // Finds the root samples, every other fret is resampled from them.
+    for(i = 0; i < NUM_OF_ROOTS; i++)
+    {
+        // Reads the note header from the note table, a missing note is silent.
+        FILES_FindNote(PACK_MAKE_NOTE_ID(PACK_STRING, rootFrets[i]), &files[i].audioInfo, &files[i].dataOffset);
+        // Copies the sustain loop into RAM.
+        AUDIO_LoadLoop(i);
+        // Finds the attack in flash.
+        AUDIO_FindAttack(i);
+        // Finds where the note starts after the silence.
+        AUDIO_FindStart(i);
+    }
+    
     // Initializes the index to the first file.
-    fileIndex = FILE_1;
+    fileIndex = fretRoots[FILE_1];
     // Sets the initial tone.
-    AUDIO_setNewTone(fileIndex, 1);
-    // Sets the TIMER clock period to write out audio data.
-    TIMER3_SetSampleRate(files[fileIndex].audioInfo.sampleRate);
-    // Lists the files in memory
-    FILES_ListFiles(&files[fileIndex].audioInfo.fileName[0]);
+    AUDIO_setNewTone(FILE_1, 1, FALSE);
+    // Sets the TIMER clock period to write out audio data, a missing note keeps the last.
+    if(files[fileIndex].audioInfo.sampleRate > 0)
+    {
+        TIMER3_SetSampleRate(files[fileIndex].audioInfo.sampleRate);
+    }
+    // Lists the notes in the sample pack
+    FILES_ListNotes(&files[fileIndex].audioInfo.fileName[0]);
 }
 
 /**
  * @brief Process audio data.
- * @details The audio data will process audio data based on data received from
- * the IO and ADC modules. The data received by the IO module will correspond to
- * the fret location. The data received by the ADC module will correspond to the
- * strumming data.
+ * @details Refills the audio buffers with a block of the note that is playing.
+ * Run by the refill task of the main loop.
  * @remarks Requires the IO and ADC modules to be initialized. 
  * @return Void
  */
 void AUDIO_Process(void)
 {
-    if(TIMER3_IsON())
+    if(AUDIO_NeedsRefill())
+    {
+        AUDIO_RenderBlock();
+    }
+}
+
+/**
+ * @brief Checks if the audio buffers need a refill.
+ * @details The audio buffers are filled to the read-ahead depth tuned to the 
+ * card. The card is left to the upload while a sample pack is uploaded. A new
+ * tone is started by the refill task even while the output is off.
+ * @return Returns a boolean indicating if a new tone is pending, or if the 
+ * audio buffers are below the read-ahead depth and a block fits in them, until
+ * the note has been queued.
+ */
+BOOL AUDIO_NeedsRefill(void)
+{
+    UINT16 space = AUDIO_GetBufferSpace();
+    
+    if(isTonePending)
+    {
+        return TRUE;
+    }
+    return TIMER3_IsON() && !UPLOAD_IsActive() && !isEndQueued && (space >= AUDIO_BLOCK_FRAMES) &&
+            ((AUDIO_BUF_SIZE - space) < READAHEAD_GetFrames());
+}
+
+/**
+ * @brief Returns the priority of the refill task.
+ * @details The emptier the audio buffers, the higher the refill runs. The fill
+ * level is measured against the read-ahead depth.
+ * @return Returns the refill priority for the audio buffer fill level.
+ */
+UINT8 AUDIO_GetRefillPriority(void)
+{
+    UINT16 fill = AUDIO_BUF_SIZE - AUDIO_GetBufferSpace();
+    UINT16 depth = READAHEAD_GetFrames();
+    
+    if(isTonePending || (fill < depth/2))
+    {
+        return AUDIO_REFILL_URGENT;
+    }
+    if(fill < depth)
+    {
+        return AUDIO_REFILL_NORMAL;
+    }
+    return AUDIO_REFILL_LOW;
+}
+
+/**
+ * @brief Brings up and recovers the SD card.
+ * @details Steps the card state machine and reloads the sample pack once the 
+ * card has been mounted. The pack is reloaded after the ringing note, which is
+ * played from flash and RAM meanwhile. Run by the card task of the main loop.
+ * @return Void
+ */
+void AUDIO_CardProcess(void)
+{
+    // The card belongs to the upload while one is active
+    if(!AUDIO_IsCardFree())
+    {
+        return;
+    }
+    
+    FILES_Process();
+    if(FILES_NeedsPack() && !TIMER3_IsON())
+    {
+        AUDIO_LoadPack();
+    }
+}
+
+/**
+ * @brief Checks if the card task can use the card.
+ * @return Returns a boolean indicating if the card is free of an upload.
+ */
+BOOL AUDIO_IsCardFree(void)
+{
+    return !UPLOAD_IsActive();
+}
+
+/**
+ * @brief Displays the card statistics.
+ * @details Displays the card faults and recovery times and the number of notes
+ * played without the card.
+ * @arg reset Clears the statistics after they are displayed.
+ * @return Void
+ */
+void AUDIO_ShowCard(BOOL reset)
+{
+    char buf[64];
+    
+    FILES_ShowCard(reset);
+    snprintf(&buf[0], 64, "Notes played without the card: %u", cardSkips);
+    MON_SendString(&buf[0]);
+    
+    if(reset)
+    {
+        cardSkips = 0;
+    }
+}
+
+/**
+ * @brief Follows the pressed fret.
+ * @details Scans the frets, slides or bends the ringing note and requests the 
+ * opening of the pressed fret. Run by the fret task of the main loop.
+ * @return Void
+ */
+void AUDIO_FretProcess(void)
+{
+    IO_Process();
+    if(slideMode == AUDIO_SLIDE_FRETLESS)
+    {
+        AUDIO_BendToPosition(IO_getPosition());
+    }
+    else
+    {
+        AUDIO_SlideToFret(IO_getFret());
+    }
+    AUDIO_PrefetchFret(IO_getFret());
+}
+
+/**
+ * @brief Prefetches the opening of the note whose fret was pressed.
+ * @details Run by the prefetch task of the main loop.
+ * @return Void
+ */
+void AUDIO_PrefetchProcess(void)
+{
+    if(AUDIO_NeedsPrefetch())
+    {
+        AUDIO_RunPrefetch(prefetchRequest);
+    }
+}
+
+/**
+ * @brief Checks if an opening is waiting to be prefetched.
+ * @return Returns a boolean indicating if a prefetch was requested.
+ */
+BOOL AUDIO_NeedsPrefetch(void)
+{
+    return (prefetchRequest != AUDIO_NO_PREFETCH) && !UPLOAD_IsActive() && FILES_IsReady();
+}
+
+/**
+ * @brief Runs the requested decoder benchmark.
+ * @details The decoder is benchmarked on the card once the note has finished.
+ * Run by the monitor task of the main loop.
+ * @return Void
+ */
+void AUDIO_BenchmarkProcess(void)
+{
+    if(AUDIO_NeedsBenchmark())
     {
-        AUDIO_ReadFile(REC_BUF_SIZE);
+        isDecodeBenchmark = FALSE;
+        AUDIO_RunDecodeBenchmark();
     }
 }
 
+/**
+ * @brief Checks if the decoder benchmark can run.
+ * @return Returns a boolean indicating if the benchmark was requested and the
+ * card is free.
+ */
+BOOL AUDIO_NeedsBenchmark(void)
+{
+    return isDecodeBenchmark && !TIMER3_IsON() && !UPLOAD_IsActive() && FILES_IsReady();
+}
+
 /**
  * @brief Displays the list of audio files.
- * @details Finds all WAV files in the root directory of the SD card and displays
- * them via UART to serial.
+ * @details Displays the notes in the sample pack via UART to serial.
  * @remarks Requires the UART module and SD card to be initialized. 
  * @return Void
  */
 void AUDIO_ListFiles(void)
 {
-    FILES_ListFiles(&files[fileIndex].audioInfo.fileName[0]);
+    FILES_ListNotes(&files[fileIndex].audioInfo.fileName[0]);
 }
 
 /**
@@ -130,9 +521,9 @@ void AUDIO_ListFiles(void)
  */
 BOOL AUDIO_setNewFile(UINT16 selectedFile)
 {
-    if(selectedFile <= 20 && selectedFile >= 0)
+    if(selectedFile < MAX_NUM_OF_FILES)
     {
-        AUDIO_setNewTone(selectedFile, 1);
+        AUDIO_setNewTone(selectedFile, 1, FALSE);
         return TRUE;
     }
     return FALSE;
@@ -140,14 +531,21 @@ BOOL AUDIO_setNewFile(UINT16 selectedFile)
 
 /**
  * @brief Sets a new tone.
- * @details Sets a new tone based on the fret that is passed into the function.
- * Resets all related variables prior to reading the new tone.
+ * @details Requests the tone of the fret that is passed into the function. The
+ * output is held until the refill task starts the tone, so the render state is
+ * only ever changed by the main loop. A later request replaces a pending one.
+ * @remarks Called from the strum and core software interrupts and the monitor
+ * task.
  * @arg fret The fret that is being played.
+ * @arg factor The scaling factor.
+ * @arg isStrum The tone is started by a strum and counts in the prefetch 
+ * statistics.
  * @return Void
  */
-char buf[64];
-void AUDIO_setNewTone(int fret, UINT16 factor)
+void AUDIO_setNewTone(int fret, UINT16 factor, BOOL isStrum)
 {
+    UINT32 status;
+    
     /* Disables the timer if it is on. */
     if(TIMER3_IsON())
     {
@@ -155,43 +553,189 @@ void AUDIO_setNewTone(int fret, UINT16 factor)
         MON_SendString("Turning off timer");
     }
     
+    /* The main loop sets tones too, the request is written at once. */
+    status = INTDisableInterrupts();
+    toneFret = fret;
+    toneFactor = factor;
+    isToneStrum = isStrum;
+    isTonePending = TRUE;
+    INTRestoreInterrupts(status);
+}
+
+/**
+ * @brief Sets the scaling factor of the last tone.
+ * @details A tone that hasn't started yet takes the factor when it starts.
+ * @remarks Called from the strum interrupt once the strum velocity settles.
+ * @arg factor The scaling factor.
+ * @return Void
+ */
+void AUDIO_SetToneFactor(UINT16 factor)
+{
+    UINT32 status;
+    
+    status = INTDisableInterrupts();
+    if(isTonePending)
+    {
+        toneFactor = factor;
+    }
+    else
+    {
+        scaleFactor = factor;
+    }
+    INTRestoreInterrupts(status);
+}
+
+/**
+ * @brief Starts the pending tone.
+ * @details Resets all related variables prior to reading the new tone. The fret
+ * is played by resampling the root sample that serves the fret. Run by the 
+ * refill task before it renders, so no read or resample of the previous note is
+ * in progress.
+ * @return Void
+ */
+char buf[64];
+void AUDIO_StartTone(void)
+{
+    UINT32 status;
+    int fret;
+    BOOL isStrum;
+    
     /* Clears out all the buffers. */
     memset(&receiveBuffer[0], AC_ZERO, sizeof(receiveBuffer));
-    memset(&LAUDIOSTACK[0], AC_ZERO, sizeof(LAUDIOSTACK));
-    memset(&RAUDIOSTACK[0], AC_ZERO, sizeof(RAUDIOSTACK));
-    
-    /* Sets the audio in pointer to zero. */
-    audioInPtr = 0;
-    /* Sets the audio out pointer to zero. */
-    audioOutPtr = 0;
-    /* Sets the bytes read to zero. */
-    bytesRead = 0;
-    /* Sets the bytes written to zero. */
-    bytesWritten = 0;
-    /* Resets the file pointer. */
-    AUDIO_resetFilePtr();
-    /* Sets the file index to the specified fret. */
-    fileIndex = fret;
+    
+    /* Takes the request and empties the audio buffers before the output resumes. */
+    status = INTDisableInterrupts();
+    fret = toneFret;
+    scaleFactor = toneFactor;
+    isStrum = isToneStrum;
+    framesQueued = 0;
+    framesWritten = 0;
+    isEndQueued = FALSE;
+    isTonePending = FALSE;
+    INTRestoreInterrupts(status);
+    
+    /* Drops the source frames and the block of the previous note. */
+    sourceCount = 0;
+    sourceIndex = 0;
+    blockCount = 0;
+    /* Restarts the sustain loop. */
+    loopIndex = 0;
+    loopGain = AUDIO_LOOP_FULL_GAIN;
+    /* Sets the file index to the root sample of the specified fret. */
+    if(fret < 0 || fret >= MAX_NUM_OF_FILES)
+    {
+        fret = FILE_0;
+    }
+    fileIndex = fretRoots[fret];
+    /* Starts reading after the silence before the pluck. */
+    bytesRead = files[fileIndex].startOffset;
+    /* Counts if the opening of a strummed note was prefetched. */
+    if(isStrum)
+    {
+        if(prefetchIndex == fileIndex)
+        {
+            prefetchHits++;
+            prefetchSavedTicks += prefetchTicks;
+        }
+        else
+        {
+            prefetchMisses++;
+        }
+    }
+    currentFret = fret;
+    pendingFret = fret;
+    /* Shifts the root sample to the pitch of the fret. */
+    RESAMPLE_Init(&resampleLeft, RESAMPLE_GetSemitoneStep(fret - rootFrets[fileIndex]), AUDIO_RESAMPLE_MODE);
+    RESAMPLE_Init(&resampleRight, RESAMPLE_GetSemitoneStep(fret - rootFrets[fileIndex]), AUDIO_RESAMPLE_MODE);
     /* Sets the DAC's output to zero. */
     DAC_Zero();
-    /* Sets the scaling factor. */
-    scaleFactor = factor;
-    /* Sets the hasReadFile boolean. */
-    hasReadFile = FALSE;
+    
+    LATENCY_Mark(LATENCY_TONE);
     
     snprintf(&buf[0] ,64 ,"Fret: %d \n\rScale Factor: %f \n\rSetting new a tone.", fret, scaleFactor/1024);
     MON_SendString(&buf[0]);
 }
 
+/**
+ * @brief Slides the ringing note to a new fret.
+ * @details Called by the fret task with the fret that is pressed. In slide mode,
+ * a fret that is read twice in a row glides the pitch of the ringing note to 
+ * the new fret. The root sample keeps playing so the attack isn't read again.
+ * @arg fret The fret that is pressed.
+ * @return Void
+ */
+void AUDIO_SlideToFret(int fret)
+{
+    UINT32 step;
+    
+    if(slideMode != AUDIO_SLIDE_FRETTED || !TIMER3_IsON() || fret < 0 || fret >= MAX_NUM_OF_FILES)
+    {
+        return;
+    }
+    
+    /* Waits for the fret to settle between two fret scans. */
+    if(fret != pendingFret)
+    {
+        pendingFret = fret;
+        return;
+    }
+    
+    if(fret != currentFret)
+    {
+        currentFret = fret;
+        step = RESAMPLE_GetSemitoneStep(fret - rootFrets[fileIndex]);
+        RESAMPLE_GlideTo(&resampleLeft, step);
+        RESAMPLE_GlideTo(&resampleRight, step);
+    }
+}
+
+/**
+ * @brief Bends the ringing note to the finger position.
+ * @details Called by the fret task with the finger position. In fretless mode,
+ * the pitch of the ringing note glides to the position between the frets, so 
+ * the note bends as the finger slides. The position is already smoothed and 
+ * the glide hides the steps between two fret scans.
+ * @arg position The finger position in frets, 8 fractional bits like a bend.
+ * @return Void
+ */
+void AUDIO_BendToPosition(INT32 position)
+{
+    UINT32 step;
+    
+    if(slideMode != AUDIO_SLIDE_FRETLESS || !TIMER3_IsON() || position < 0 || 
+            position >= ((INT32)MAX_NUM_OF_FILES << RESAMPLE_BEND_Q))
+    {
+        return;
+    }
+    
+    currentFret = (position + (1 << (RESAMPLE_BEND_Q - 1))) >> RESAMPLE_BEND_Q;
+    pendingFret = currentFret;
+    step = RESAMPLE_GetBendStep(position - ((INT32)rootFrets[fileIndex] << RESAMPLE_BEND_Q));
+    RESAMPLE_GlideTo(&resampleLeft, step);
+    RESAMPLE_GlideTo(&resampleRight, step);
+}
+
+/**
+ * @brief Sets the slide mode.
+ * @arg mode The slide mode, AUDIO_SLIDE_OFF, AUDIO_SLIDE_FRETTED or 
+ * AUDIO_SLIDE_FRETLESS.
+ * @return Void
+ */
+void AUDIO_SetSlideMode(UINT8 mode)
+{
+    slideMode = mode;
+}
+
 /**
  * @brief Resets the file pointer for selected file.
+ * @details Notes are read from the sample pack at an offset from the start of 
+ * the note, so reading restarts where the note starts after its silence. The 
+ * offset maps straight to a sector of the pack.
  * @return Void
  */
 void AUDIO_resetFilePtr(void)
 {
-    files[fileIndex].File.fptr = files[fileIndex].startPtr;
-    files[fileIndex].File.clust = files[fileIndex].cluster;
-    files[fileIndex].File.sect = files[fileIndex].sector;
+    bytesRead = files[fileIndex].startOffset;
 }
 
 /**
@@ -211,6 +755,11 @@ UINT32 AUDIO_getBytesRead(void)
  */
 BOOL AUDIO_isDoneReading(void)
 {
+    if(files[fileIndex].audioInfo.loopLength > 0)
+    {
+        // A looped note is done once the sustain has decayed.
+        return (loopGain < AUDIO_LOOP_MIN_GAIN);
+    }
     if(bytesRead >= files[fileIndex].audioInfo.dataSize)
     {
         return TRUE;
@@ -218,94 +767,183 @@ BOOL AUDIO_isDoneReading(void)
     return FALSE;
 }
 
+/**
+ * @brief Checks if the note is sustained from the loop in RAM.
+ * @return Returns a boolean indicating if the attack has been read.
+ * @retval TRUE, if the note is played from the sustain loop.
+ * @retval FALSE, if the note is read from the file.
+ */
+BOOL AUDIO_isLooping(void)
+{
+    AUDIOINFO* info = &files[fileIndex].audioInfo;
+    
+    if((info->loopLength > 0) && (bytesRead >= info->loopStart*info->blockAlign))
+    {
+        return TRUE;
+    }
+    return FALSE;
+}
+
 /**
  * @brief Returns the number of bytes written.
  * @return Returns the number of bytes written.
  */
 UINT32 AUDIO_getBytesWritten(void)
 {
-    return bytesWritten;
+    return framesWritten*4;
 }
 
 /**
- * @brief Checks if writing to the DAC is done.
- * @return Returns a boolean indicating if writing to the DAC is done.
- * @retval TRUE, if done writing to the DAC.
- * @retval FALSE, if not done writing to the DAC.
+ * @brief Returns the free space in the audio buffers.
+ * @return Returns the number of samples that can be stored in the audio buffers.
  */
-BOOL AUDIO_isDoneWriting(void)
+UINT16 AUDIO_GetBufferSpace(void)
 {
-    if(bytesWritten >= files[fileIndex].audioInfo.dataSize)
-    {
-        return TRUE;
-    }
-    return FALSE;
+    return (AUDIO_BUF_SIZE - (framesQueued - framesWritten));
 }
 
 /**
- * @brief Reads the header of a WAV file.
- * @arg index The file that is being read.
- * @return A code indicating if reading the file is successful or not.
- * @retval 1, Read the header successfully
- * @retval 2, Header size is invalid
- * @retval 3, Chunk ID is invalid
- * @retval 4, Header format is invalid
- * @retval 5, Chunk ID 1 is invalid
- * @retval 6, Chunk ID 1 Data is invalid
- * @retval 7, Chunk ID 2 is invalid
+ * @brief Copies the sustain loop of a root sample into RAM.
+ * @details Reads the loop stored in the note table into RAM as mono samples. 
+ * The end of the loop is crossfaded into the samples before the loop start so 
+ * the seam is smooth. Loops that are longer than AUDIO_LOOP_SIZE are not used.
+ * @arg index The root sample.
+ * @return Returns a boolean indicating if the loop is loaded.
+ * @retval TRUE if the loop is loaded.
+ * @retval FALSE if the note has no usable loop.
  */
-UINT8 AUDIO_GetHeader(int index)
+BOOL AUDIO_LoadLoop(int index)
 {
-    UINT16 readPtr = 0;
-    if(FILES_ReadFile(&files[index].File, &receiveBuffer[0], WAV_HEADER_SIZE, &readPtr) == FR_OK)
+    FILES* file = &files[index];
+    AUDIOINFO* info = &file->audioInfo;
+    INT16 fade[AUDIO_LOOP_FADE];
+    INT16* loop = &loopBuffers[index][0];
+    UINT32 start = info->loopStart, length = info->loopLength;
+    UINT32 offset, frame, bytesLeft;
+    UINT16 readPtr = 0, bytes = 0, i = 0, j = 0;
+    
+    // The loop needs room for the crossfade and must fit in RAM.
+    BOOL isLoaded = (length > AUDIO_LOOP_FADE) && (info->blockAlign > 0) && (start >= AUDIO_LOOP_FADE) && 
+            (start + length <= info->dataSize/info->blockAlign) && (length <= AUDIO_LOOP_SIZE);
+    
+    // Reads the samples before the loop start followed by the loop.
+    frame = 0;
+    offset = file->dataOffset + (start - AUDIO_LOOP_FADE)*info->blockAlign;
+    bytesLeft = (AUDIO_LOOP_FADE + length)*info->blockAlign;
+    while(isLoaded && bytesLeft > 0)
     {
-        if((receiveBuffer[WAV_CHUNK_ID] != 'R')|
-                (receiveBuffer[WAV_CHUNK_ID+1] != 'I')|
-                (receiveBuffer[WAV_CHUNK_ID+2] != 'F')|
-                (receiveBuffer[WAV_CHUNK_ID+3] != 'F'))
+        bytes = (bytesLeft > REC_BUF_SIZE) ? (REC_BUF_SIZE - (REC_BUF_SIZE % info->blockAlign)) : bytesLeft;
+        isLoaded = (FILES_ReadPack(offset, &receiveBuffer[0], bytes, &readPtr) == FR_OK) && (readPtr == bytes);
+        for(i = 0; isLoaded && i < bytes; i += info->blockAlign, frame++)
         {
-            return WAV_CHUNK_ID_ERROR;
-        }
-        else if((receiveBuffer[WAV_FORMAT] != 'W')|
-                (receiveBuffer[WAV_FORMAT+1] != 'A')|
-                (receiveBuffer[WAV_FORMAT+2] != 'V')|
-                (receiveBuffer[WAV_FORMAT+3] != 'E'))
-        {
-            return WAV_FORMAT_ERROR;
+            if(frame < AUDIO_LOOP_FADE)
+            {
+                fade[frame] = AUDIO_GetMonoSample(&receiveBuffer[i], info->numOfChannels);
+            }
+            else
+            {
+                loop[frame - AUDIO_LOOP_FADE] = AUDIO_GetMonoSample(&receiveBuffer[i], info->numOfChannels);
+            }
         }
-        else if((receiveBuffer[WAV_CHUNK1_SUB_ID] != 'f')|
-                (receiveBuffer[WAV_CHUNK1_SUB_ID+1] != 'm')|
-                (receiveBuffer[WAV_CHUNK1_SUB_ID+2] != 't'))
+        offset += bytes;
+        bytesLeft -= bytes;
+    }
+    
+    if(isLoaded)
+    {
+        // Crossfades the end of the loop into the samples before the loop start.
+        for(i = 0; i < AUDIO_LOOP_FADE; i++)
         {
-            return WAV_SUB_CHUNK1_ID_ERROR;
+            j = length - AUDIO_LOOP_FADE + i;
+            loop[j] = (INT16)((loop[j]*(AUDIO_LOOP_FADE - 1 - i) + fade[i]*(i + 1))/AUDIO_LOOP_FADE);
         }
-        else if((receiveBuffer[WAV_CHUNK2_SUB_ID] != 'd')|
-                (receiveBuffer[WAV_CHUNK2_SUB_ID+1] != 'a')|
-                (receiveBuffer[WAV_CHUNK2_SUB_ID+2] != 't')|
-                (receiveBuffer[WAV_CHUNK2_SUB_ID+3] != 'a'))
+    }
+    else
+    {
+        info->loopStart = 0;
+        info->loopLength = 0;
+    }
+    return isLoaded;
+}
+
+/**
+ * @brief Finds the attack of a root sample in program flash.
+ * @details Reading the sample pack continues where the attack ends. Notes 
+ * without an attack are read from the start of the audio data.
+ * @arg index The root sample file.
+ * @return Void
+ */
+void AUDIO_FindAttack(int index)
+{
+    FILES* file = &files[index];
+    int i = 0;
+    
+    file->attackData = NULL;
+    file->attackSize = 0;
+    
+    for(i = 0; attacks[i].fileName != NULL; i++)
+    {
+        if(strcmp(attacks[i].fileName, &file->audioInfo.fileName[0]) == 0)
         {
-            return WAV_SUB_CHUNK2_ID_ERROR;
+            file->attackData = attacks[i].data;
+            file->attackSize = attacks[i].size;
+            if(file->attackSize > file->audioInfo.dataSize)
+            {
+                file->attackSize = file->audioInfo.dataSize;
+            }
+            break;
         }
-        
-        // Stores the corresponding header information
-        files[index].audioInfo.sampleRate = receiveBuffer[WAV_SAMPLE_RATE+1] << 8 | 
-                                    receiveBuffer[WAV_SAMPLE_RATE];
-        files[index].audioInfo.bitsPerSample = receiveBuffer[WAV_BITS_PER_SAMPLE];
-        files[index].audioInfo.blockAlign = receiveBuffer[WAV_BLOCK_ALIGN];
-        files[index].audioInfo.numOfChannels = receiveBuffer[WAV_NUM_CHANNELS];
-        files[index].audioInfo.dataSize = (receiveBuffer[WAV_DATA-1] << 24) | 
-                                    (receiveBuffer[WAV_DATA-2] << 16) |
-                                    (receiveBuffer[WAV_DATA-3] << 8) |
-                                    (receiveBuffer[WAV_DATA-4]);
-        return WAV_SUCCESS;
     }
-    return WAV_HEADER_SIZE_ERROR;
+}
+
+/**
+ * @brief Finds where a root sample starts playing.
+ * @details The pack builder stores the first sample frame above the noise floor
+ * of each note. The start is kept on the decode stride and before the sustain 
+ * loop, otherwise the note is played from the start of its audio data.
+ * @arg index The root sample file.
+ * @return Void
+ */
+void AUDIO_FindStart(int index)
+{
+    FILES* file = &files[index];
+    AUDIOINFO* info = &file->audioInfo;
+    UINT32 start = (info->startFrame*info->blockAlign) & ~3;
+    UINT32 end = info->dataSize;
+    
+    if(info->loopLength > 0)
+    {
+        end = info->loopStart*info->blockAlign;
+    }
+    file->startOffset = (start < end) ? start : 0;
+}
+
+/**
+ * @brief Returns a mono sample from a sample frame.
+ * @arg frame The sample frame.
+ * @arg numOfChannels The number of channels in the frame.
+ * @return Returns the average of the channels.
+ */
+INT16 AUDIO_GetMonoSample(BYTE* frame, UINT16 numOfChannels)
+{
+    INT32 left = (INT16)((frame[1] << 8) | frame[0]);
+    
+    if(numOfChannels == 2)
+    {
+        return (INT16)((left + (INT16)((frame[3] << 8) | frame[2])) >> 1);
+    }
+    return (INT16)left;
 }
 
 /**
  * @brief Reads a number of bytes from the audio file.
+ * @details The attack of the note is read from program flash if it has been 
+ * generated, the rest is decoded in place from the sector borrowed from the sample
+ * pack. The samples read are decoded into the source buffers. While the card 
+ * is down, a looped note skips to its sustain loop in RAM and any other note 
+ * ends.
  * @arg file The files to read from.
- * @arg bytes The number of bytes to read.
+ * @arg bytes The number of bytes to read, at most REC_BUF_SIZE.
  * @return Returns a boolean indicating if the file was read successfully.
  * @retval TRUE if the file was read successfully.
  * @retval FALSE if the file was read unsuccessfully.
@@ -313,61 +951,251 @@ UINT8 AUDIO_GetHeader(int index)
 BOOL AUDIO_GetAudioData(FILES* file, UINT16 bytes)
 {
     UINT32 bytesLeft = (file->audioInfo.dataSize - bytesRead);
-    UINT16 readPtr = 0;
+    UINT16 readPtr = 0, lent = 0;
+    INT16 leftData, rightData;
+    const BYTE* data = NULL;
+    UINT32 reads = FILES_GetPackReads();
+    UINT32 startTicks = TIMER_GetCoreTicks();
     
-    // Calculates the number of bytes left to read.
+    // A looped note only reads the attack from the file.
+    if(file->audioInfo.loopLength > 0)
+    {
+        bytesLeft = file->audioInfo.loopStart*file->audioInfo.blockAlign - bytesRead;
+    }
+    
+    // Calculates the number of bytes left to read, at most a receive buffer.
+    if(bytes > REC_BUF_SIZE)
+    {
+        bytes = REC_BUF_SIZE;
+    }
     if(bytes > bytesLeft)
     {
         bytes = bytesLeft;
     }
     
-    // Reads the file and verifies that the file is read.
-    if(FILES_ReadFile(&(file->File), &receiveBuffer[0], bytes, &readPtr) == FR_OK)
+    // Reads the attack from flash and the rest of the note from the file.
+    if(bytesRead < file->attackSize)
+    {
+        if(bytes > (file->attackSize - bytesRead))
+        {
+            bytes = file->attackSize - bytesRead;
+        }
+        data = &file->attackData[bytesRead];
+    }
+    else if((prefetchIndex < NUM_OF_ROOTS) && (file == &files[prefetchIndex]) && 
+            (bytesRead >= prefetchStart) && (bytesRead < prefetchStart + prefetchSize))
+    {
+        // Reads the opening prefetched when the fret was pressed.
+        if(bytes > (prefetchStart + prefetchSize - bytesRead))
+        {
+            bytes = prefetchStart + prefetchSize - bytesRead;
+        }
+        data = &prefetchBuffer[bytesRead - prefetchStart];
+    }
+    else if(!FILES_IsReady())
+    {
+        // The card is recovering, the note isn't read from the pack.
+        data = NULL;
+    }
+    else if((FILES_LendPack(file->dataOffset + bytesRead, bytes, &data, &lent) == FR_OK) && (lent >= 4))
+    {
+        // Decodes whole frames straight from the pack sector.
+        bytes = lent & ~3;
+    }
+    else
+    {
+        // A frame split between two sectors is copied into the receive buffer.
+        data = NULL;
+        if(FILES_ReadPack(file->dataOffset + bytesRead, &receiveBuffer[0], bytes, &readPtr) == FR_OK)
+        {
+            data = &receiveBuffer[0];
+        }
+    }
+    
+    // Times the reads that reached the card to tune the read-ahead.
+    if((data != NULL) && (FILES_GetPackReads() != reads))
+    {
+        READAHEAD_AddRead(TIMER_GetCoreTicks() - startTicks, file->audioInfo.sampleRate);
+    }
+    
+    // Verifies that the data is read.
+    if(data != NULL)
     {   
-        // Converts and writes read bytes to audio buffers.
+        // Decodes the read bytes into the source buffers.
         int i = 0;
-        UINT16 audioData, unsign_audio;
-        for(i = 0; i < bytes; i+=4)
+        sourceCount = 0;
+        sourceIndex = 0;
+        for(i = 0; (i + 3) < bytes; i+=4)
         {
             // Left Channel
-            audioData = ((receiveBuffer[i+1] << 8) | (receiveBuffer[i]));
-            if (audioData & 0x8000) {
-                unsign_audio = ~(audioData - 1);
-                audioData = AC_ZERO - unsign_audio;
-            }
-            else {
-                audioData = AC_ZERO + audioData;
-            }
-            LAUDIOSTACK[audioInPtr] = audioData;
+            leftData = (INT16)((data[i+1] << 8) | (data[i]));
+            rightData = leftData;
             
             if(file->audioInfo.numOfChannels == 2)
             {
-                audioData = ((receiveBuffer[i+3] << 8) | (receiveBuffer[i+2]));
-                if (audioData & 0x8000) {
-                    unsign_audio = ~(audioData - 1);
-                    audioData = AC_ZERO - unsign_audio;
-                }
-                else {
-                    audioData = AC_ZERO + audioData;
-                }             
+                rightData = (INT16)((data[i+3] << 8) | (data[i+2]));
             }
-            RAUDIOSTACK[audioInPtr++] = audioData;
             
-            if(audioInPtr >= AUDIO_BUF_SIZE)
-            {
-                audioInPtr = 0;
-            }
+            sourceLeft[sourceCount] = leftData;
+            sourceRight[sourceCount++] = rightData;
+        }
+        if(bytesRead == file->startOffset)
+        {
+            LATENCY_Mark(LATENCY_SD_BLOCK);
         }
         bytesRead+=bytes;
-        hasReadFile = TRUE;
         return TRUE;
     }
-    hasReadFile = FALSE;
+    
+    if(!FILES_IsReady())
+    {
+        // Continues from the sustain loop in RAM, or ends the note.
+        cardSkips++;
+        bytesRead = (file->audioInfo.loopLength > 0) ? 
+                file->audioInfo.loopStart*file->audioInfo.blockAlign : file->audioInfo.dataSize;
+        return FALSE;
+    }
     return FALSE;
 }
 
+/**
+ * @brief Requests the opening of a fret to be prefetched.
+ * @details Called by the fret task with the fret that is pressed, before the 
+ * string is strummed. The opening of the root sample that plays the fret is 
+ * read from the main loop unless it is already held.
+ * @arg fret The fret that is pressed.
+ * @return Void
+ */
+void AUDIO_PrefetchFret(int fret)
+{
+    if(fret < 0 || fret >= MAX_NUM_OF_FILES)
+    {
+        return;
+    }
+    if(fretRoots[fret] != prefetchIndex)
+    {
+        prefetchRequest = fretRoots[fret];
+    }
+}
+
+/**
+ * @brief Prefetches the opening of a root sample.
+ * @details Reads the first bytes of the note that follow its attack in flash 
+ * into the prefetch buffer. The time the read takes is the latency saved when
+ * the note is strummed.
+ * @arg index The root sample.
+ * @return Void
+ */
+void AUDIO_RunPrefetch(UINT16 index)
+{
+    FILES* file = &files[index];
+    AUDIOINFO* info = &file->audioInfo;
+    UINT32 start = (file->attackSize > file->startOffset) ? file->attackSize : file->startOffset;
+    UINT32 end = info->dataSize, size = 0;
+    UINT32 startTicks = TIMER_GetCoreTicks();
+    UINT16 readPtr = 0;
+    
+    prefetchRequest = AUDIO_NO_PREFETCH;
+    prefetchIndex = AUDIO_NO_PREFETCH;
+    if(info->loopLength > 0)
+    {
+        end = info->loopStart*info->blockAlign;
+    }
+    
+    // A note played from flash up to its end has nothing to prefetch.
+    if(start < end)
+    {
+        size = ((end - start) > AUDIO_PREFETCH_SIZE) ? AUDIO_PREFETCH_SIZE : ((end - start) & ~3);
+        if(FILES_ReadPack(file->dataOffset + start, &prefetchBuffer[0], size, &readPtr) != FR_OK || readPtr != size)
+        {
+            return;
+        }
+    }
+    
+    prefetchStart = start;
+    prefetchSize = size;
+    prefetchTicks = TIMER_GetCoreTicks() - startTicks;
+    prefetchReads++;
+    prefetchIndex = index;
+}
+
+/**
+ * @brief Displays the prefetch statistics.
+ * @details Displays the number of openings prefetched, the hit rate of the 
+ * strummed tones and the card read time saved per hit.
+ * @arg reset Clears the statistics after they are displayed.
+ * @return Void
+ */
+void AUDIO_ShowPrefetch(BOOL reset)
+{
+    char buf[80];
+    UINT32 tones = prefetchHits + prefetchMisses;
+    
+    snprintf(&buf[0], 80, "Prefetch: %u reads, %u hits, %u misses, %u%% hit rate", prefetchReads, 
+            prefetchHits, prefetchMisses, (tones > 0) ? (prefetchHits*100)/tones : 0);
+    MON_SendString(&buf[0]);
+    snprintf(&buf[0], 80, "Saved: %u us per hit, %u us in total", 
+            (prefetchHits > 0) ? (prefetchSavedTicks/TIMER_TICKS_PER_US)/prefetchHits : 0,
+            prefetchSavedTicks/TIMER_TICKS_PER_US);
+    MON_SendString(&buf[0]);
+    
+    if(reset)
+    {
+        AUDIO_ClearPrefetch();
+    }
+}
+
+/**
+ * @brief Clears the prefetch statistics.
+ * @return Void
+ */
+void AUDIO_ClearPrefetch(void)
+{
+    prefetchReads = 0;
+    prefetchHits = 0;
+    prefetchMisses = 0;
+    prefetchSavedTicks = 0;
+}
+
+/**
+ * @brief Plays a number of sample frames from the sustain loop.
+ * @details The loop is read from RAM with a decaying gain into the source 
+ * buffers.
+ * @arg frames The number of sample frames to play, at most AUDIO_SOURCE_FRAMES.
+ * @return Returns a boolean indicating if the loop was played.
+ */
+BOOL AUDIO_GetLoopData(UINT16 frames)
+{
+    INT16* loop = &loopBuffers[fileIndex][0];
+    UINT32 loopLength = files[fileIndex].audioInfo.loopLength;
+    INT16 sample;
+    
+    if(frames > AUDIO_SOURCE_FRAMES)
+    {
+        frames = AUDIO_SOURCE_FRAMES;
+    }
+    
+    for(sourceCount = 0; sourceCount < frames; sourceCount++)
+    {
+        sample = (INT16)((loop[loopIndex]*(loopGain >> 15)) >> 15);
+        loopGain -= loopGain >> AUDIO_LOOP_DECAY_SHIFT;
+        if(++loopIndex >= loopLength)
+        {
+            loopIndex = 0;
+        }
+        
+        sourceLeft[sourceCount] = sample;
+        sourceRight[sourceCount] = sample;
+    }
+    sourceIndex = 0;
+    return TRUE;
+}
+
 /**
  * @brief Reads a number of bytes from the audio file.
+ * @details Decodes the bytes into the source buffers, which are resampled by
+ * the block renderer. Once the attack of a looped note has been read, the note
+ * is sustained from the loop in RAM without reading the file.
  * @arg bytesToRead The number of bytes to read.
  * @return Returns a boolean indicating if the file was read successfully.
  * @retval TRUE if the file was read successfully.
@@ -375,6 +1203,10 @@ BOOL AUDIO_GetAudioData(FILES* file, UINT16 bytes)
  */
 BOOL AUDIO_ReadFile(UINT16 bytesToRead)
 {
+    if(AUDIO_isLooping())
+    {
+        return (AUDIO_isDoneReading() ? FALSE : AUDIO_GetLoopData(bytesToRead/4));
+    }
     if(AUDIO_isDoneReading())
     {
         return FALSE;
@@ -394,34 +1226,352 @@ BYTE* AUDIO_GetRecieveBuffer(void)
     return &receiveBuffer[0];
 }
 
+/**
+ * @brief Renders a block of the note into the audio buffers.
+ * @details Starts the pending tone first. Pulls the decoded frames of the note
+ * through the resamplers until the block holds AUDIO_BLOCK_FRAMES frames and 
+ * queues it. The frames produced past the block are kept for the next block. 
+ * Once the note is done, the last block is padded with silence and queued as 
+ * the end of the note. A block left short by the card is finished by the next 
+ * run. Run by the refill task.
+ * @return Void
+ */
+void AUDIO_RenderBlock(void)
+{
+    UINT32 startTicks = 0;
+    UINT32 ticks = 0;
+    UINT16 count = 0;
+    BOOL isEnd = FALSE;
+    
+    if(isTonePending)
+    {
+        AUDIO_StartTone();
+        if(!AUDIO_NeedsRefill())
+        {
+            return;
+        }
+    }
+    
+    startTicks = TIMER_GetCoreTicks();
+    while(blockCount < AUDIO_BLOCK_FRAMES)
+    {
+        if(sourceIndex >= sourceCount)
+        {
+            // Decodes the next frames of the note, or waits for them.
+            if(!AUDIO_ReadFile(REC_BUF_SIZE) || (sourceCount == 0))
+            {
+                break;
+            }
+        }
+        
+        count = RESAMPLE_Process(&resampleLeft, sourceLeft[sourceIndex], &blockLeft[blockCount], AUDIO_RESAMPLE_MAX_OUT);
+        RESAMPLE_Process(&resampleRight, sourceRight[sourceIndex], &blockRight[blockCount], AUDIO_RESAMPLE_MAX_OUT);
+        sourceIndex++;
+        blockCount += count;
+    }
+    
+    if(blockCount < AUDIO_BLOCK_FRAMES)
+    {
+        if(!AUDIO_isDoneReading())
+        {
+            return;
+        }
+        
+        // Pads the last block of the note with silence.
+        for(count = blockCount; count < AUDIO_BLOCK_FRAMES; count++)
+        {
+            blockLeft[count] = 0;
+            blockRight[count] = 0;
+        }
+        blockCount = AUDIO_BLOCK_FRAMES;
+        isEnd = TRUE;
+    }
+    AUDIO_QueueBlock(isEnd);
+    
+    ticks = TIMER_GetCoreTicks() - startTicks;
+    blocksRendered++;
+    renderTicks += ticks;
+    if(ticks > renderMaxTicks)
+    {
+        renderMaxTicks = ticks;
+    }
+}
+
+/**
+ * @brief Queues the rendered block in the audio buffers.
+ * @details Centers the signed samples on the DAC zero level. The frames are 
+ * published to the Timer 3 interrupt before the end of the note is. A block 
+ * never wraps around the audio buffers, the buffer size is a multiple of the
+ * block size and only whole blocks are queued.
+ * @arg isEnd Indicates if the block is the last block of the note.
+ * @return Void
+ */
+void AUDIO_QueueBlock(BOOL isEnd)
+{
+    UINT16 in = framesQueued & (AUDIO_BUF_SIZE - 1);
+    UINT16 i = 0;
+    
+    for(i = 0; i < AUDIO_BLOCK_FRAMES; i++)
+    {
+        LAUDIOSTACK[in + i] = (UINT16)(AC_ZERO + blockLeft[i]);
+        RAUDIOSTACK[in + i] = (UINT16)(AC_ZERO + blockRight[i]);
+    }
+    
+    // Keeps the frames produced past the block.
+    for(i = AUDIO_BLOCK_FRAMES; i < blockCount; i++)
+    {
+        blockLeft[i - AUDIO_BLOCK_FRAMES] = blockLeft[i];
+        blockRight[i - AUDIO_BLOCK_FRAMES] = blockRight[i];
+    }
+    blockCount -= AUDIO_BLOCK_FRAMES;
+    
+    // Only the refill task writes the queued count, a new tone is started by it too.
+    framesQueued += AUDIO_BLOCK_FRAMES;
+    isEndQueued = isEnd;
+}
+
 /**
  * @brief Writes audio data out to the DAC
- * @details Writes audio data out to the DAC. Handles stopping and resetting all 
- * the selected after writing all audio data out to the DAC.
+ * @details Copies the next queued frame out to the DACs. Stops the output once
+ * the last block of the note has been written and requests the tone to be 
+ * reset. The output is held while a new tone is pending.
+ * @remarks Called from the Timer 3 interrupt, which preempts every other 
+ * interrupt, so it only writes one frame.
  * @return Void
  */
 void AUDIO_WriteDataToDAC(void)
 {
-    if(AUDIO_isDoneReading() && AUDIO_isDoneWriting())
+    UINT32 startTicks = TIMER_GetCoreTicks();
+    UINT32 fill = framesQueued - framesWritten;
+    UINT16 out = framesWritten & (AUDIO_BUF_SIZE - 1);
+    
+    if(isTonePending)
     {
-        AUDIO_setNewTone(FILE_0, 1);
+        /* The queued frames belong to the previous note. */
+        return;
     }
-    else
+    
+    if(fill > 0)
     {
-        if((bytesRead > bytesWritten) && hasReadFile == TRUE)
+        JITTER_AddFrame(startTicks, fill, FALSE);
+        
+        /* Writes 1 WORD of data to the DAC Channel A, left channel. */
+        DAC_WriteToDAC(WRITE_UPDATE_CHN_A, LAUDIOSTACK[out]);
+        if(LAUDIOSTACK[out] != AC_ZERO)
         {
-            /* Writes 1 WORD of data to the DAC Channel A, left channel. */
-            DAC_WriteToDAC(WRITE_UPDATE_CHN_A, LAUDIOSTACK[audioOutPtr]);
-            /* Writes 1 WORD of data to the DAC Channel B, right channel. */
-            DAC_WriteToDAC(WRITE_UPDATE_CHN_B, RAUDIOSTACK[audioOutPtr++]);
+            LATENCY_Mark(LATENCY_DAC);
+        }
+        /* Writes 1 WORD of data to the DAC Channel B, right channel. */
+        DAC_WriteToDAC(WRITE_UPDATE_CHN_B, RAUDIOSTACK[out]);
+        framesWritten++;
+        
+        fill = TIMER_GetCoreTicks() - startTicks;
+        copyFrames++;
+        copyTicks += fill;
+        if(fill > copyMaxTicks)
+        {
+            copyMaxTicks = fill;
+        }
+    }
+    else if(isEndQueued)
+    {
+        /* Stops the output and resets the tone at a lower priority. */
+        TIMER3_ON(FALSE);
+        CoreSetSoftwareInterrupt0();
+    }
+    else if(framesQueued > 0)
+    {
+        /* The audio buffers are empty, the DAC holds the last frame. */
+        JITTER_AddFrame(startTicks, 0, TRUE);
+    }
+}
 
-            if(audioOutPtr >= AUDIO_BUF_SIZE)
-            {
-                audioOutPtr = 0;
-            }
-            
-            // Increments the byte written count.
-            bytesWritten+=4;
+/**
+ * @brief Displays the cost of the audio blocks.
+ * @details Displays the cycles per frame spent rendering blocks in the main 
+ * loop and copying frames out in the Timer 3 interrupt, against the Timer 3
+ * period.
+ * @arg reset Clears the statistics after they are displayed.
+ * @return Void
+ */
+void AUDIO_ShowBlocks(BOOL reset)
+{
+    char buf[128];
+    UINT32 cycles = 0;
+    
+    // The core timer ticks once every two system clocks.
+    cycles = (blocksRendered > 0) ? (UINT32)((renderTicks*2)/((UINT64)blocksRendered*AUDIO_BLOCK_FRAMES)) : 0;
+    snprintf(&buf[0], 128, "Render: %u blocks of %u frames, %u cycles per frame (%u%% of the Timer 3 period), max %u cycles per block",
+            blocksRendered, AUDIO_BLOCK_FRAMES, cycles, (cycles*100)/(PR3 + 1), renderMaxTicks*2);
+    MON_SendString(&buf[0]);
+    cycles = (copyFrames > 0) ? (UINT32)((copyTicks*2)/copyFrames) : 0;
+    snprintf(&buf[0], 128, "Copy-out: %u frames, %u cycles per frame (%u%% of the Timer 3 period), max %u cycles",
+            copyFrames, cycles, (cycles*100)/(PR3 + 1), copyMaxTicks*2);
+    MON_SendString(&buf[0]);
+    
+    if(reset)
+    {
+        AUDIO_ClearBlocks();
+    }
+}
+
+/**
+ * @brief Clears the block statistics.
+ * @return Void
+ */
+void AUDIO_ClearBlocks(void)
+{
+    blocksRendered = 0;
+    renderTicks = 0;
+    renderMaxTicks = 0;
+    copyFrames = 0;
+    copyTicks = 0;
+    copyMaxTicks = 0;
+}
+
+/**
+ * @brief Core Software Interrupt 0 Service Routine.
+ * @details Resets the tone once a note has been written out. A strum handled
+ * since the note ended has already set a new tone and turned the output on.
+ * @return Void.
+ */
+void __ISR(_CORE_SOFTWARE_0_VECTOR, IPL2AUTO) AudioDoneHandler(void)
+{
+    CoreClearSoftwareInterrupt0();
+    IFS0bits.CS0IF = 0;
+    
+    if(!TIMER3_IsON())
+    {
+        AUDIO_setNewTone(FILE_0, 1, FALSE);
+    }
+}
+
+/**
+ * @brief Benchmarks the resampler.
+ * @details Resamples a test signal two semitones down with each interpolation 
+ * mode and displays the cost of each stereo output sample against the Timer 3
+ * sample period.
+ * @return Void
+ */
+void AUDIO_BenchmarkResampler(void)
+{
+    RESAMPLE left, right;
+    INT16 leftOut[AUDIO_RESAMPLE_MAX_OUT], rightOut[AUDIO_RESAMPLE_MAX_OUT];
+    UINT32 startTicks, ticks, outputs, cycles;
+    char buf[64];
+    UINT8 mode = 0;
+    int i = 0;
+    
+    for(mode = RESAMPLE_LINEAR; mode <= RESAMPLE_CUBIC; mode++)
+    {
+        RESAMPLE_Init(&left, RESAMPLE_GetSemitoneStep(-2), mode);
+        RESAMPLE_Init(&right, RESAMPLE_GetSemitoneStep(-2), mode);
+        outputs = 0;
+        
+        startTicks = TIMER_GetCoreTicks();
+        for(i = 0; i < AUDIO_BENCHMARK_SAMPLES; i++)
+        {
+            outputs += RESAMPLE_Process(&left, (INT16)(i*251), &leftOut[0], AUDIO_RESAMPLE_MAX_OUT);
+            RESAMPLE_Process(&right, (INT16)(i*-251), &rightOut[0], AUDIO_RESAMPLE_MAX_OUT);
         }
+        ticks = TIMER_GetCoreTicks() - startTicks;
+        
+        // The core timer ticks once every two system clocks.
+        cycles = (ticks*2)/outputs;
+        snprintf(&buf[0], 64, "%s: %u cycles per sample, %u%% of the Timer 3 period", 
+                (mode == RESAMPLE_LINEAR) ? "Linear" : "Cubic", cycles, (cycles*100)/(PR3 + 1));
+        MON_SendString(&buf[0]);
     }
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Benchmarks the decoder.
+ * @details Requests the decoder benchmark, it is run from the main loop since 
+ * it reads the card.
+ * @return Void
+ */
+void AUDIO_BenchmarkDecode(void)
+{
+    isDecodeBenchmark = TRUE;
+}
+
+/**
+ * @brief Runs the decoder benchmark.
+ * @details Reads the current note from two bytes past its start, so the copy 
+ * goes through f_read like a note that isn't sector aligned. The note is decoded 
+ * once after copying it into the receive buffer and once in place from the 
+ * borrowed pack sector. The cost of each per KB of audio is displayed.
+ * @return Void
+ */
+void AUDIO_RunDecodeBenchmark(void)
+{
+    FILES* file = &files[fileIndex];
+    UINT32 offset = file->dataOffset + 2;
+    UINT32 bytes = AUDIO_BENCHMARK_BYTES, done = 0;
+    UINT32 startTicks, copyTicks, lendTicks;
+    volatile UINT32 sum = 0;
+    const BYTE* data = NULL;
+    UINT16 readPtr = 0;
+    char buf[80];
+    
+    if(bytes > (file->audioInfo.dataSize - 2))
+    {
+        bytes = (file->audioInfo.dataSize - 2) & ~(REC_BUF_SIZE - 1);
+    }
+    if((file->audioInfo.dataSize < 2) || (bytes == 0))
+    {
+        MON_SendString("The note is too short to benchmark.");
+        return;
+    }
+    
+    // Copies into the receive buffer and decodes it.
+    startTicks = TIMER_GetCoreTicks();
+    for(done = 0; done < bytes; done += readPtr)
+    {
+        if((FILES_ReadPack(offset + done, &receiveBuffer[0], REC_BUF_SIZE, &readPtr) != FR_OK) || (readPtr == 0))
+        {
+            MON_SendString("Failed to read the note.");
+            return;
+        }
+        sum += AUDIO_SumSamples(&receiveBuffer[0], readPtr);
+    }
+    copyTicks = TIMER_GetCoreTicks() - startTicks;
+    
+    // Decodes in place from the pack sector.
+    startTicks = TIMER_GetCoreTicks();
+    for(done = 0; done < bytes; done += readPtr)
+    {
+        if((FILES_LendPack(offset + done, bytes - done, &data, &readPtr) != FR_OK) || (readPtr == 0))
+        {
+            MON_SendString("Failed to read the note.");
+            return;
+        }
+        sum += AUDIO_SumSamples(data, readPtr);
+    }
+    lendTicks = TIMER_GetCoreTicks() - startTicks;
+    
+    // The core timer ticks once every two system clocks, a KB is two sectors.
+    snprintf(&buf[0], 80, "Copy: %u cycles/KB, in place: %u cycles/KB, over %u bytes", 
+            (copyTicks*4)/(bytes/REC_BUF_SIZE), (lendTicks*4)/(bytes/REC_BUF_SIZE), bytes);
+    MON_SendString(&buf[0]);
+}
+
+/**
+ * @brief Sums the samples in a number of bytes.
+ * @details Decodes the 16-bit samples the way the audio data is decoded, the 
+ * sum keeps the benchmark from being optimized away.
+ * @arg data The bytes to decode.
+ * @arg bytes The number of bytes to decode.
+ * @return Returns the sum of the samples.
+ */
+UINT32 AUDIO_SumSamples(const BYTE* data, UINT16 bytes)
+{
+    UINT32 sum = 0;
+    int i = 0;
+    
+    for(i = 0; (i + 1) < bytes; i+=2)
+    {
+        sum += (INT16)((data[i+1] << 8) | (data[i]));
+    }
+    return sum;
+}
@@ -14,23 +14,67 @@ extern "C" {
 #include "WAVDEF.h"
 #include "FILES.h"
 
+/** @def AUDIO_SLIDE_OFF 
+ * Defines the slide mode where ringing notes keep their pitch. */
+#define AUDIO_SLIDE_OFF         0
+/** @def AUDIO_SLIDE_FRETTED 
+ * Defines the slide mode where ringing notes glide to the pressed fret. */
+#define AUDIO_SLIDE_FRETTED     1
+/** @def AUDIO_SLIDE_FRETLESS 
+ * Defines the slide mode where ringing notes bend with the finger position. */
+#define AUDIO_SLIDE_FRETLESS    2
 /** @def REC_BUF_SIZE 
  * Defines the receive buffer size. */
 #define REC_BUF_SIZE            512
 /** @def AUDIO_BUF_SIZE 
- * Defines the audio buffer size. */
-#define AUDIO_BUF_SIZE          REC_BUF_SIZE/4
+ * Defines the audio buffer size in samples, must be a power of 2. */
+#define AUDIO_BUF_SIZE          512
+/** @def AUDIO_BLOCK_FRAMES 
+ * Defines the number of frames rendered per block in the main loop, must be a
+ * power of 2 no larger than AUDIO_BUF_SIZE/2. */
+#ifndef AUDIO_BLOCK_FRAMES
+#define AUDIO_BLOCK_FRAMES      32
+#endif
+
+#if (AUDIO_BUF_SIZE & (AUDIO_BUF_SIZE - 1)) != 0
+#error "AUDIO_BUF_SIZE must be a power of 2."
+#endif
+#if (AUDIO_BLOCK_FRAMES < 1) || ((AUDIO_BLOCK_FRAMES & (AUDIO_BLOCK_FRAMES - 1)) != 0) || \
+        (AUDIO_BLOCK_FRAMES > AUDIO_BUF_SIZE/2)
+#error "AUDIO_BLOCK_FRAMES must be a power of 2 no larger than AUDIO_BUF_SIZE/2."
+#endif
 
 void AUDIO_Init(void);
+void AUDIO_LoadPack(void);
 void AUDIO_Process(void);
+BOOL AUDIO_NeedsRefill(void);
+UINT8 AUDIO_GetRefillPriority(void);
+void AUDIO_CardProcess(void);
+BOOL AUDIO_IsCardFree(void);
+void AUDIO_ShowCard(BOOL reset);
+void AUDIO_FretProcess(void);
+void AUDIO_PrefetchProcess(void);
+BOOL AUDIO_NeedsPrefetch(void);
+void AUDIO_BenchmarkProcess(void);
+BOOL AUDIO_NeedsBenchmark(void);
 BYTE* AUDIO_GetRecieveBuffer(void);
 BOOL AUDIO_ReadFile(UINT16 bytesToRead);
 void AUDIO_WriteDataToDAC(void);
+void AUDIO_SlideToFret(int fret);
+void AUDIO_BendToPosition(INT32 position);
+void AUDIO_SetSlideMode(UINT8 mode);
+void AUDIO_PrefetchFret(int fret);
 
 /* UART related functions */
 void AUDIO_ListFiles(void);
-void AUDIO_setNewTone(int fret, UINT16 factor);
+void AUDIO_setNewTone(int fret, UINT16 factor, BOOL isStrum);
+void AUDIO_SetToneFactor(UINT16 factor);
 BOOL AUDIO_setNewFile(UINT16 selectedFile);
+void AUDIO_BenchmarkResampler(void);
+void AUDIO_BenchmarkDecode(void);
+void AUDIO_ShowPrefetch(BOOL reset);
+void AUDIO_ShowBlocks(BOOL reset);
+void AUDIO_ClearPrefetch(void);
 void AUDIO_resetFilePtr(void);
 
 UINT32 AUDIO_getBytesRead(void);
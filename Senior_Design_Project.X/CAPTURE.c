@@ -0,0 +1,414 @@
+/**
+ * @file CAPTURE.c
+ * @author Kue Yang
+ * @date 10/19/2026
+ * @details The CAPTURE module records the raw strumming sensor samples of one
+ * string into a RAM ring. Each entry is annotated with the fret that is pressed
+ * and whether the live strum detector fired. The ring can be dumped over UART or
+ * replayed through the strum detector to measure detection timing and cost.
+ * @remarks Dumping and replaying are run by the capture task of the main loop,
+ * a line or a slice of the replay per run, so the monitor task only starts them
+ * and returns. The capture ring is only built if CAPTURE_RING is set to 1.
+ */
+
+#include <p32xxxx.h>
+#include <stdio.h>
+#include "STDDEF.h"
+#include "TIMER.h"
+#include "UART.h"
+#include "STRUM.h"
+#include "CAPTURE.h"
+
+/** @def CAPTURE_MATCH_WINDOW
+ * Defines how far apart, in samples, a replay strum and a live strum can be. */
+#define CAPTURE_MATCH_WINDOW    64
+/** @def CAPTURE_LINE_SIZE
+ * Defines the size of a dump line. */
+#define CAPTURE_LINE_SIZE       32
+/** @def CAPTURE_MAX_LISTED
+ * Defines the number of replay strums listed, the rest are only counted. */
+#define CAPTURE_MAX_LISTED      10
+/** @def CAPTURE_REPLAY_SLICE
+ * Defines the number of samples replayed per run of the capture task. */
+#define CAPTURE_REPLAY_SLICE    128
+
+/** @def CAPTURE_IDLE
+ * Defines the state where the capture ring is not in use. */
+#define CAPTURE_IDLE            0
+/** @def CAPTURE_RUNNING
+ * Defines the state where samples are being captured. */
+#define CAPTURE_RUNNING         1
+/** @def CAPTURE_DUMPING
+ * Defines the state where the capture ring is being sent over UART. */
+#define CAPTURE_DUMPING         2
+/** @def CAPTURE_REPLAYING
+ * Defines the state where the capture ring is replayed through the detector. */
+#define CAPTURE_REPLAYING       3
+
+#if CAPTURE_RING
+/** @var captureRing
+ * The capture ring. */
+UINT16 captureRing[CAPTURE_SIZE];
+/** @var captureHead
+ * The index of the next entry to be written. */
+UINT16 captureHead;
+/** @var captureFilled
+ * The number of valid entries in the capture ring. */
+UINT16 captureFilled;
+/** @var captureIndex
+ * The entry that is being dumped. */
+UINT16 captureIndex;
+/** @var captureString
+ * The string that is being captured. */
+int captureString;
+/** @var captureState
+ * The state of the capture ring. */
+volatile UINT8 captureState;
+/** @var replayStrum
+ * The strum detector the capture ring is replayed through. */
+STRUM replayStrum;
+/** @var replayIndex
+ * The entry that is replayed next. */
+UINT16 replayIndex;
+/** @var replayTicks
+ * Accumulates the core timer ticks spent in the replay detector. */
+UINT32 replayTicks;
+/** @var replayDetected
+ * Counts the strums found by the replay. */
+UINT16 replayDetected;
+/** @var replayMatched
+ * Counts the replay strums with a live strum nearby. */
+UINT16 replayMatched;
+/** @var replayLive
+ * Counts the live strums replayed. */
+UINT16 replayLive;
+
+UINT16 CAPTURE_GetEntry(UINT16 index);
+BOOL CAPTURE_FindLiveStrum(UINT16 index, UINT16* liveIndex);
+void CAPTURE_SendNextEntry(void);
+void CAPTURE_RunReplay(void);
+#endif
+
+/**
+ * @brief Initializes the CAPTURE module.
+ * @return Void
+ */
+void CAPTURE_Init(void)
+{
+#if CAPTURE_RING
+    captureHead = 0;
+    captureFilled = 0;
+    captureIndex = 0;
+    captureString = 0;
+    captureState = CAPTURE_IDLE;
+#endif
+}
+
+/**
+ * @brief Processes capture related tasks.
+ * @details Sends the capture ring over UART while dumping, or replays the
+ * capture ring through the strum detector.
+ * @return Void
+ */
+void CAPTURE_Process(void)
+{
+#if CAPTURE_RING
+    if(captureState == CAPTURE_DUMPING)
+    {
+        CAPTURE_SendNextEntry();
+    }
+    else if(captureState == CAPTURE_REPLAYING)
+    {
+        CAPTURE_RunReplay();
+    }
+#endif
+}
+
+/**
+ * @brief Starts capturing a string.
+ * @details Clears the capture ring and starts recording. Recording continues
+ * until the capture ring is dumped or replayed, keeping the most recent samples.
+ * @arg string The string to capture.
+ * @return Returns a boolean indicating if the capture has started.
+ */
+BOOL CAPTURE_Start(int string)
+{
+#if CAPTURE_RING
+    captureState = CAPTURE_IDLE;
+    captureHead = 0;
+    captureFilled = 0;
+    captureString = string;
+    captureState = CAPTURE_RUNNING;
+    return TRUE;
+#else
+    MON_SendString("The ADC capture ring isn't built, build with -DCAPTURE_RING=1.");
+    return FALSE;
+#endif
+}
+
+/**
+ * @brief Stops capturing and starts sending the capture ring over UART.
+ * @return Void
+ */
+void CAPTURE_Dump(void)
+{
+#if CAPTURE_RING
+    captureState = CAPTURE_IDLE;
+    captureIndex = 0;
+    captureState = CAPTURE_DUMPING;
+#else
+    MON_SendString("The ADC capture ring isn't built, build with -DCAPTURE_RING=1.");
+#endif
+}
+
+/**
+ * @brief Stops capturing and replays the capture ring through the detector.
+ * @details The replay is run by the capture task, CAPTURE_REPLAY_SLICE samples
+ * at a time.
+ * @return Void
+ */
+void CAPTURE_Replay(void)
+{
+#if CAPTURE_RING
+    captureState = CAPTURE_IDLE;
+    replayIndex = 0;
+    replayTicks = 0;
+    replayDetected = 0;
+    replayMatched = 0;
+    replayLive = 0;
+    captureState = CAPTURE_REPLAYING;
+#else
+    MON_SendString("The ADC capture ring isn't built, build with -DCAPTURE_RING=1.");
+#endif
+}
+
+/**
+ * @brief Checks if the capture ring is being dumped or replayed.
+ * @return Returns a boolean indicating if the capture has work for the main loop.
+ */
+BOOL CAPTURE_IsBusy(void)
+{
+#if CAPTURE_RING
+    return (captureState == CAPTURE_DUMPING) || (captureState == CAPTURE_REPLAYING);
+#else
+    return FALSE;
+#endif
+}
+
+#if CAPTURE_RING
+/**
+ * @brief Checks if samples are being captured.
+ * @return Returns a boolean indicating if samples are being captured.
+ * @retval TRUE if samples are being captured.
+ * @retval FALSE if samples are not being captured.
+ */
+BOOL CAPTURE_IsRunning(void)
+{
+    return (captureState == CAPTURE_RUNNING);
+}
+
+/**
+ * @brief Returns the string that is being captured.
+ * @return Returns the string that is being captured.
+ */
+int CAPTURE_GetString(void)
+{
+    return captureString;
+}
+
+/**
+ * @brief Adds a block of samples to the capture ring.
+ * @details Called from the ADC interrupt. The live strum flag is set on the
+ * last sample of the block the live detector fired in.
+ * @arg samples The raw ADC samples, oldest first.
+ * @arg count The number of samples in the block.
+ * @arg fret The fret that is pressed.
+ * @arg isStrum Indicates if the live detector fired within the block.
+ * @return Void
+ */
+void CAPTURE_AddBlock(const UINT16* samples, UINT16 count, int fret, BOOL isStrum)
+{
+    UINT16 annotation = (fret & CAPTURE_FRET_MASK) << CAPTURE_FRET_SHIFT;
+    UINT16 i = 0;
+
+    for(i = 0; i < count; i++)
+    {
+        captureRing[captureHead] = (samples[i] & CAPTURE_SAMPLE_MASK) | annotation;
+        captureHead = (captureHead + 1) & (CAPTURE_SIZE - 1);
+    }
+    if(isStrum)
+    {
+        captureRing[(captureHead - 1) & (CAPTURE_SIZE - 1)] |= CAPTURE_STRUM_FLAG;
+    }
+
+    captureFilled += count;
+    if(captureFilled > CAPTURE_SIZE)
+    {
+        captureFilled = CAPTURE_SIZE;
+    }
+}
+
+/**
+ * @brief Returns a capture entry.
+ * @arg index The entry index, counted from the oldest entry.
+ * @return Returns the capture entry.
+ */
+UINT16 CAPTURE_GetEntry(UINT16 index)
+{
+    UINT16 oldest = (captureFilled < CAPTURE_SIZE) ? 0 : captureHead;
+    return captureRing[(oldest + index) & (CAPTURE_SIZE - 1)];
+}
+
+/**
+ * @brief Sends the next capture entry over UART.
+ * @details Sends one entry per call if the UART transmit buffer has room. The
+ * format is one line per entry: index,sample,fret,strum.
+ * @return Void
+ */
+void CAPTURE_SendNextEntry(void)
+{
+    char buf[CAPTURE_LINE_SIZE];
+    UINT16 entry;
+
+    // Leaves room for the header and an entry.
+    if(MON_GetTxFree() < 2*CAPTURE_LINE_SIZE)
+    {
+        return;
+    }
+
+    if(captureIndex == 0)
+    {
+        snprintf(&buf[0], CAPTURE_LINE_SIZE, "CAPTURE %d %u", captureString, captureFilled);
+        MON_SendString(&buf[0]);
+    }
+
+    if(captureIndex >= captureFilled)
+    {
+        MON_SendString("END");
+        captureState = CAPTURE_IDLE;
+        return;
+    }
+
+    entry = CAPTURE_GetEntry(captureIndex);
+    snprintf(&buf[0], CAPTURE_LINE_SIZE, "%u,%u,%u,%u", captureIndex,
+            entry & CAPTURE_SAMPLE_MASK,
+            (entry >> CAPTURE_FRET_SHIFT) & CAPTURE_FRET_MASK,
+            (entry & CAPTURE_STRUM_FLAG) ? 1 : 0);
+    MON_SendString(&buf[0]);
+    captureIndex++;
+}
+
+/**
+ * @brief Finds the live strum closest to a capture entry.
+ * @arg index The entry index, counted from the oldest entry.
+ * @arg liveIndex Stores the entry index of the live strum.
+ * @return Returns a boolean indicating if a live strum is within the window.
+ */
+BOOL CAPTURE_FindLiveStrum(UINT16 index, UINT16* liveIndex)
+{
+    UINT16 offset = 0;
+
+    for(offset = 0; offset <= CAPTURE_MATCH_WINDOW; offset++)
+    {
+        if((index + offset) < captureFilled && (CAPTURE_GetEntry(index + offset) & CAPTURE_STRUM_FLAG))
+        {
+            *liveIndex = index + offset;
+            return TRUE;
+        }
+        if(offset <= index && (CAPTURE_GetEntry(index - offset) & CAPTURE_STRUM_FLAG))
+        {
+            *liveIndex = index - offset;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/**
+ * @brief Replays a slice of the capture ring through the strum detector.
+ * @details Runs the next CAPTURE_REPLAY_SLICE captured samples through the 
+ * replay detector and displays the sample of each detected strum next to the 
+ * live detector's strum. The strum counts and the detector cost per sample are
+ * displayed once the whole ring has been replayed.
+ * @return Void
+ */
+void CAPTURE_RunReplay(void)
+{
+    char buf[64];
+    UINT32 startTicks;
+    UINT16 end, liveIndex = 0;
+    UINT16 sample;
+    BOOL isStrum;
+
+    if(replayIndex == 0)
+    {
+        if(captureFilled == 0)
+        {
+            MON_SendString("Nothing has been captured.");
+            captureState = CAPTURE_IDLE;
+            return;
+        }
+
+        // Seeds the DC estimate with the first sample.
+        STRUM_Init(&replayStrum, CAPTURE_GetEntry(0) & CAPTURE_SAMPLE_MASK);
+    }
+
+    end = captureFilled;
+    if(end - replayIndex > CAPTURE_REPLAY_SLICE)
+    {
+        end = replayIndex + CAPTURE_REPLAY_SLICE;
+    }
+
+    for(; replayIndex < end; replayIndex++)
+    {
+        sample = CAPTURE_GetEntry(replayIndex);
+        if(sample & CAPTURE_STRUM_FLAG)
+        {
+            replayLive++;
+        }
+
+        startTicks = TIMER_GetCoreTicks();
+        isStrum = STRUM_Detect(&replayStrum, sample & CAPTURE_SAMPLE_MASK);
+        replayTicks += TIMER_GetCoreTicks() - startTicks;
+
+        if(isStrum)
+        {
+            replayDetected++;
+            if(replayDetected > CAPTURE_MAX_LISTED)
+            {
+                replayMatched += CAPTURE_FindLiveStrum(replayIndex, &liveIndex);
+            }
+            else if(CAPTURE_FindLiveStrum(replayIndex, &liveIndex))
+            {
+                replayMatched++;
+                snprintf(&buf[0], 64, "Strum at %u, fret %u, live at %u", replayIndex,
+                        (sample >> CAPTURE_FRET_SHIFT) & CAPTURE_FRET_MASK, liveIndex);
+            }
+            else
+            {
+                snprintf(&buf[0], 64, "Strum at %u, fret %u, no live strum", replayIndex,
+                        (sample >> CAPTURE_FRET_SHIFT) & CAPTURE_FRET_MASK);
+            }
+
+            if(replayDetected <= CAPTURE_MAX_LISTED)
+            {
+                MON_SendString(&buf[0]);
+            }
+        }
+    }
+
+    if(replayIndex < captureFilled)
+    {
+        return;
+    }
+
+    snprintf(&buf[0], 64, "Replay: %u strums, live: %u strums, matched: %u",
+            replayDetected, replayLive, replayMatched);
+    MON_SendString(&buf[0]);
+
+    // The core timer ticks once every two system clocks.
+    snprintf(&buf[0], 64, "Detector cost: %u cycles per sample", (replayTicks*2)/captureFilled);
+    MON_SendString(&buf[0]);
+    captureState = CAPTURE_IDLE;
+}
+#endif
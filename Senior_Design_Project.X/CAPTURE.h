@@ -0,0 +1,60 @@
+/**
+ * @file CAPTURE.h
+ * @author Kue Yang
+ * @date 10/19/2026
+ */
+
+#ifndef CAPTURE_H
+#define	CAPTURE_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include "STDDEF.h"
+
+/** @def CAPTURE_RING
+ * Defines if the ADC capture ring is built. The ring is a diagnostic left out 
+ * of the build by default, build with -DCAPTURE_RING=1 to capture, dump and 
+ * replay the strumming sensor samples. */
+#ifndef CAPTURE_RING
+#define CAPTURE_RING            0
+#endif
+/** @def CAPTURE_SIZE
+ * Defines the number of samples held by the capture ring, must be a power of 2. */
+#define CAPTURE_SIZE            8192
+/** @def CAPTURE_SAMPLE_MASK
+ * Defines the bits of a capture entry that store the raw ADC sample. */
+#define CAPTURE_SAMPLE_MASK     0x03FF
+/** @def CAPTURE_FRET_SHIFT
+ * Defines the position of the fret annotation in a capture entry. */
+#define CAPTURE_FRET_SHIFT      10
+/** @def CAPTURE_FRET_MASK
+ * Defines the size of the fret annotation in a capture entry. */
+#define CAPTURE_FRET_MASK       0x1F
+/** @def CAPTURE_STRUM_FLAG
+ * Defines the bit of a capture entry set when the live detector fired. */
+#define CAPTURE_STRUM_FLAG      0x8000
+
+void CAPTURE_Init(void);
+void CAPTURE_Process(void);
+BOOL CAPTURE_Start(int string);
+void CAPTURE_Dump(void);
+void CAPTURE_Replay(void);
+BOOL CAPTURE_IsBusy(void);
+#if CAPTURE_RING
+BOOL CAPTURE_IsRunning(void);
+int CAPTURE_GetString(void);
+void CAPTURE_AddBlock(const UINT16* samples, UINT16 count, int fret, BOOL isStrum);
+#else
+#define CAPTURE_IsRunning()     FALSE
+#define CAPTURE_GetString()     0
+#define CAPTURE_AddBlock(samples, count, fret, isStrum)
+#endif
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* CAPTURE_H */
+
@@ -4,48 +4,266 @@
  * @date 11/22/2016
  * @details The FIFO module handles all FIFO related tasks. The FIFO module 
  * handles pushing and popping data into a given FIFO queue for processing.
+ * Bytes are moved one at a time, in bulk, or in place through the contiguous
+ * span at the head or tail of the buffer, which suits copies and DMA. A push
+ * into a full queue is dropped and counted.
+ * @remarks Each queue has one producer and one consumer. The buffer is only 
+ * accessed between reading the other side's index and writing its own.
  */
 
+#include <string.h>
 #include "STDDEF.h"
 #include "FIFO.h"
 
+/** @def FIFO_BARRIER
+ * Keeps the compiler from moving buffer accesses across an index update. */
+#define FIFO_BARRIER()  __asm__ __volatile__("" ::: "memory")
+
+/**
+ * @brief Initializes a FIFO queue.
+ * @arg fifo The FIFO queue.
+ * @arg buffer The buffer that stores the queued data.
+ * @arg size The size of the buffer, a power of 2 up to 32768.
+ * @return Returns a boolean indicating if the queue is initialized.
+ * @retval TRUE If the queue is initialized.
+ * @retval FALSE If the size isn't a power of 2.
+ */
+BOOL FIFO_Init(FIFO* fifo, BYTE* buffer, UINT16 size)
+{
+    if(size == 0 || (size & (size - 1)) != 0 || size > 32768)
+    {
+        return FALSE;
+    }
+    fifo->buffer = buffer;
+    fifo->mask = size - 1;
+    fifo->head = 0;
+    fifo->tail = 0;
+    fifo->drops = 0;
+    return TRUE;
+}
+
 /**
  * @brief Pushes data into the FIFO queue.
  * @arg fifo The FIFO buffer that will be receiving data.
- * @arg ch The data that will be inserted into the FIFO.
+ * @arg data The data that will be inserted into the FIFO.
  * @return Returns a boolean to indicate whether operation is successful or not.
  * @retval TRUE If pushing data to queue is successful.
- * @retval FALSE If pushing data to queue is unsuccessful.
+ * @retval FALSE If the queue is full, the data is dropped.
  */
-BOOL FIFO_MonPush(MON_FIFO* fifo, char ch)
+BOOL FIFO_Push(FIFO* fifo, BYTE data)
 {
-    if(fifo->bufferSize >= MON_BUFFERSIZE)
+    UINT16 tail = fifo->tail;
+    
+    if((UINT16)(tail - fifo->head) > fifo->mask)
     {
+        fifo->drops++;
         return FALSE;
     }
-    fifo->buffer[fifo->tailPtr++] = ch;
-    fifo->bufferSize++;
+    fifo->buffer[tail & fifo->mask] = data;
+    FIFO_BARRIER();
+    fifo->tail = tail + 1;
+    return TRUE;
+}
+
+/**
+ * @brief Pops data from the FIFO queue.
+ * @arg fifo The FIFO buffer that will be reading data from.
+ * @arg data The data popped from the FIFO, left unchanged if it is empty.
+ * @return Returns a boolean indicating if data was popped.
+ * @retval TRUE If data was popped.
+ * @retval FALSE If the queue is empty.
+ */
+BOOL FIFO_Pop(FIFO* fifo, BYTE* data)
+{
+    UINT16 head = fifo->head;
     
-    if(fifo->tailPtr >= MON_BUFFERSIZE)
+    if(head == fifo->tail)
     {
-        fifo->tailPtr = 0;
+        return FALSE;
     }
+    FIFO_BARRIER();
+    *data = fifo->buffer[head & fifo->mask];
+    FIFO_BARRIER();
+    fifo->head = head + 1;
     return TRUE;
 }
 
 /**
- * @brief Pops data from the FIFO queue.
- * @arg fifo The FIFO buffer that will be reading data from.
- * @return Returns the next character in the FIFO buffer.
+ * @brief Writes a number of bytes into the FIFO queue.
+ * @details Copies up to two contiguous spans. Bytes that don't fit are dropped.
+ * @arg fifo The FIFO queue.
+ * @arg data The bytes to write.
+ * @arg count The number of bytes to write.
+ * @return Returns the number of bytes written.
+ */
+UINT16 FIFO_Write(FIFO* fifo, const BYTE* data, UINT16 count)
+{
+    UINT16 written = 0, span = 0;
+    BYTE* ptr = NULL;
+    
+    while(written < count)
+    {
+        span = FIFO_PeekWrite(fifo, &ptr);
+        if(span == 0)
+        {
+            fifo->drops += count - written;
+            break;
+        }
+        if(span > (count - written))
+        {
+            span = count - written;
+        }
+        memcpy(ptr, &data[written], span);
+        FIFO_CommitWrite(fifo, span);
+        written += span;
+    }
+    return written;
+}
+
+/**
+ * @brief Reads a number of bytes from the FIFO queue.
+ * @details Copies up to two contiguous spans.
+ * @arg fifo The FIFO queue.
+ * @arg data The buffer to store the bytes read.
+ * @arg count The most bytes to read.
+ * @return Returns the number of bytes read.
  */
-char FIFO_MonPop(MON_FIFO* fifo)
+UINT16 FIFO_Read(FIFO* fifo, BYTE* data, UINT16 count)
 {
-    fifo->bufferSize--;
-    char ch = fifo->buffer[fifo->headPtr++];
+    UINT16 read = 0, span = 0;
+    const BYTE* ptr = NULL;
     
-    if(fifo->headPtr >= MON_BUFFERSIZE)
+    while(read < count)
     {
-        fifo->headPtr = 0;
+        span = FIFO_PeekRead(fifo, &ptr);
+        if(span == 0)
+        {
+            break;
+        }
+        if(span > (count - read))
+        {
+            span = count - read;
+        }
+        memcpy(&data[read], ptr, span);
+        FIFO_CommitRead(fifo, span);
+        read += span;
     }
-    return ch;
-}
\ No newline at end of file
+    return read;
+}
+
+/**
+ * @brief Returns the contiguous free space at the tail of the FIFO queue.
+ * @details The span ends at the end of the buffer or at the head. The bytes
+ * written into it are queued by FIFO_CommitWrite.
+ * @arg fifo The FIFO queue.
+ * @arg data A pointer set to the start of the span.
+ * @return Returns the number of bytes that can be written into the span.
+ */
+UINT16 FIFO_PeekWrite(FIFO* fifo, BYTE** data)
+{
+    UINT16 tail = fifo->tail;
+    UINT16 index = tail & fifo->mask;
+    UINT16 space = (fifo->mask + 1) - (UINT16)(tail - fifo->head);
+    UINT16 span = (fifo->mask + 1) - index;
+    
+    FIFO_BARRIER();
+    *data = &fifo->buffer[index];
+    return (space < span) ? space : span;
+}
+
+/**
+ * @brief Queues bytes written into the span at the tail.
+ * @arg fifo The FIFO queue.
+ * @arg count The number of bytes written, at most the span returned by 
+ * FIFO_PeekWrite.
+ * @return Void
+ */
+void FIFO_CommitWrite(FIFO* fifo, UINT16 count)
+{
+    FIFO_BARRIER();
+    fifo->tail += count;
+}
+
+/**
+ * @brief Returns the contiguous data at the head of the FIFO queue.
+ * @details The span ends at the end of the buffer or at the tail. The bytes are
+ * removed from the queue by FIFO_CommitRead.
+ * @arg fifo The FIFO queue.
+ * @arg data A pointer set to the start of the span.
+ * @return Returns the number of bytes in the span.
+ */
+UINT16 FIFO_PeekRead(FIFO* fifo, const BYTE** data)
+{
+    UINT16 head = fifo->head;
+    UINT16 index = head & fifo->mask;
+    UINT16 count = (UINT16)(fifo->tail - head);
+    UINT16 span = (fifo->mask + 1) - index;
+    
+    FIFO_BARRIER();
+    *data = &fifo->buffer[index];
+    return (count < span) ? count : span;
+}
+
+/**
+ * @brief Removes bytes read from the span at the head.
+ * @arg fifo The FIFO queue.
+ * @arg count The number of bytes read, at most the span returned by 
+ * FIFO_PeekRead.
+ * @return Void
+ */
+void FIFO_CommitRead(FIFO* fifo, UINT16 count)
+{
+    FIFO_BARRIER();
+    fifo->head += count;
+}
+
+/**
+ * @brief Returns the number of bytes in the FIFO queue.
+ * @arg fifo The FIFO queue.
+ * @return Returns the number of bytes queued.
+ */
+UINT16 FIFO_GetCount(FIFO* fifo)
+{
+    return (UINT16)(fifo->tail - fifo->head);
+}
+
+/**
+ * @brief Returns the free space in the FIFO queue.
+ * @arg fifo The FIFO queue.
+ * @return Returns the number of bytes that can be pushed without loss.
+ */
+UINT16 FIFO_GetFree(FIFO* fifo)
+{
+    return (fifo->mask + 1) - FIFO_GetCount(fifo);
+}
+
+/**
+ * @brief Checks if the FIFO queue is empty.
+ * @arg fifo The FIFO queue.
+ * @return Returns a boolean indicating if the queue is empty.
+ */
+BOOL FIFO_IsEmpty(FIFO* fifo)
+{
+    return (fifo->head == fifo->tail);
+}
+
+/**
+ * @brief Returns the number of bytes dropped.
+ * @arg fifo The FIFO queue.
+ * @return Returns the number of bytes dropped while the queue was full.
+ */
+UINT32 FIFO_GetDrops(FIFO* fifo)
+{
+    return fifo->drops;
+}
+
+/**
+ * @brief Clears the number of bytes dropped.
+ * @remarks A drop counted by the producer while clearing may be lost.
+ * @arg fifo The FIFO queue.
+ * @return Void
+ */
+void FIFO_ClearDrops(FIFO* fifo)
+{
+    fifo->drops = 0;
+}
@@ -11,26 +11,45 @@
 extern "C" {
 #endif
 
-/**@def MON_BUFFERSIZE 
- * Defines the buffer size used for the FIFO queue. */
+#include "STDDEF.h"
+
+/**@def MON_BUFFERSIZE
+ * Defines the buffer size used for the monitor FIFO queues, must be a power of 2. */
 #define MON_BUFFERSIZE  1024
 
 /**
- * @brief MON_FIFO data structure.
- * @details The FIFO data structure is used to create and store a FIFO queue.
+ * @brief FIFO data structure.
+ * @details The FIFO data structure is used to create and store a FIFO queue
+ * shared by one producer and one consumer, which may run in an interrupt. The
+ * producer only writes the tail and the consumer only writes the head, so
+ * neither needs to disable interrupts. The indices run freely and are masked
+ * into the buffer, the number of bytes queued is their difference.
  */
-typedef struct MON_FIFO
+typedef struct FIFO
 {
     /**@{*/
-    char buffer[MON_BUFFERSIZE];    /**< Variable used to store the FIFO data. */
-    UINT16  headPtr;               /**< Variable used to point to the front of the queue. */
-    UINT16  tailPtr;               /**< Variable used to point to the back of the queue. */
-    UINT16  bufferSize;            /**< Variable used to stores the queue size. */
+    BYTE* buffer;                   /**< Variable used to point to the FIFO data. */
+    UINT16 mask;                    /**< Variable used to store the buffer size less one. */
+    volatile UINT16 head;           /**< Variable used to store the index of the next byte read, written by the consumer. */
+    volatile UINT16 tail;           /**< Variable used to store the index of the next byte written, written by the producer. */
+    volatile UINT32 drops;          /**< Variable used to store the number of bytes dropped while full, written by the producer. */
     /**@}*/
-}MON_FIFO;
-
-char FIFO_MonPop(MON_FIFO* fifo);
-BOOL FIFO_MonPush(MON_FIFO* fifo, char ch);
+}FIFO;
+
+BOOL FIFO_Init(FIFO* fifo, BYTE* buffer, UINT16 size);
+BOOL FIFO_Push(FIFO* fifo, BYTE data);
+BOOL FIFO_Pop(FIFO* fifo, BYTE* data);
+UINT16 FIFO_Write(FIFO* fifo, const BYTE* data, UINT16 count);
+UINT16 FIFO_Read(FIFO* fifo, BYTE* data, UINT16 count);
+UINT16 FIFO_PeekWrite(FIFO* fifo, BYTE** data);
+void FIFO_CommitWrite(FIFO* fifo, UINT16 count);
+UINT16 FIFO_PeekRead(FIFO* fifo, const BYTE** data);
+void FIFO_CommitRead(FIFO* fifo, UINT16 count);
+UINT16 FIFO_GetCount(FIFO* fifo);
+UINT16 FIFO_GetFree(FIFO* fifo);
+BOOL FIFO_IsEmpty(FIFO* fifo);
+UINT32 FIFO_GetDrops(FIFO* fifo);
+void FIFO_ClearDrops(FIFO* fifo);
 
 #ifdef	__cplusplus
 }
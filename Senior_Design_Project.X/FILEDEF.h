@@ -8,7 +8,7 @@
 #define _FILEDEF_H
 
 /** @def MAX_NUM_OF_FILES 
- * Defines the max number of audio files to be open. */
+ * Defines the number of notes, one per fret, played by each string. */
 #define MAX_NUM_OF_FILES        21
 
 /** @def FILE_0 
@@ -75,157 +75,49 @@
  * Defines file index 20. */
 #define FILE_20      20
 
+/** @def NUM_OF_ROOTS 
+ * Defines the number of recorded root samples that are opened. */
+#define NUM_OF_ROOTS    5
+
+/** @var rootFrets 
+ * Stores the fret each root sample was recorded at. */
+const UINT8 rootFrets[NUM_OF_ROOTS] = {FILE_0, FILE_5, FILE_10, FILE_15, FILE_20};
+
+/** @var fretRoots 
+ * Stores the root sample that is resampled to play each fret. Each root serves
+ * the frets within two semitones of it. */
+const UINT8 fretRoots[MAX_NUM_OF_FILES] = 
+{
+    0, 0, 0,            // FILE_0 to FILE_2
+    1, 1, 1, 1, 1,      // FILE_3 to FILE_7
+    2, 2, 2, 2, 2,      // FILE_8 to FILE_12
+    3, 3, 3, 3, 3,      // FILE_13 to FILE_17
+    4, 4, 4             // FILE_18 to FILE_20
+};
+
 /** @var PIC1 
  * Defines the selected PIC. */
 #define PIC1
 
-/** @var fileNames 
- * Stores the list of audio file names. */
-const char* fileNames[MAX_NUM_OF_FILES] = 
+/** @def PACK_FILE_NAME 
+ * Defines the name of the sample pack that holds the notes of every string. */
+#define PACK_FILE_NAME  "NOTES.PAK"
+
+/** @def PACK_STRING 
+ * Defines the string played by the selected PIC. The notes of the string are 
+ * found in the sample pack by PACK_MAKE_NOTE_ID(PACK_STRING, fret). */
 #ifdef PIC1
-{
-    "S1_0.wav",
-    "S1_1.wav",
-    "S1_2.wav",
-    "S1_3.wav",
-    "S1_4.wav",
-    "S1_5.wav",
-    "S1_6.wav",
-    "S1_7.wav",
-    "S1_8.wav",
-    "S1_9.wav",
-    "S1_10.wav",
-    "S1_11.wav",
-    "S1_12.wav",
-    "S1_13.wav",
-    "S1_14.wav",
-    "S1_15.wav",
-    "S1_16.wav",
-    "S1_17.wav",
-    "S1_18.wav",
-    "S1_19.wav",
-    "S1_20.wav"
-};
-#elif PIC2
-{
-    "S2_0.wav",
-    "S2_1.wav",
-    "S2_2.wav",
-    "S2_3.wav",
-    "S2_4.wav",
-    "S2_5.wav",
-    "S2_6.wav",
-    "S2_7.wav",
-    "S2_8.wav",
-    "S2_9.wav",
-    "S2_10.wav",
-    "S2_11.wav",
-    "S2_12.wav",
-    "S2_13.wav",
-    "S2_14.wav",
-    "S2_15.wav",
-    "S2_16.wav",
-    "S2_17.wav",
-    "S2_18.wav",
-    "S2_19.wav",
-    "S2_20.wav"
-};
-#elif PIC3
-{
-    "S3_0.wav",
-    "S3_1.wav",
-    "S3_2.wav",
-    "S3_3.wav",
-    "S3_4.wav",
-    "S3_5.wav",
-    "S3_6.wav",
-    "S3_7.wav",
-    "S3_8.wav",
-    "S3_9.wav",
-    "S3_10.wav",
-    "S3_11.wav",
-    "S3_12.wav",
-    "S3_13.wav",
-    "S3_14.wav",
-    "S3_15.wav",
-    "S3_16.wav",
-    "S3_17.wav",
-    "S3_18.wav",
-    "S3_19.wav",
-    "S3_20.wav"
-}
-#elif PIC4
-{
-    "S4_0.wav",
-    "S4_1.wav",
-    "S4_2.wav",
-    "S4_3.wav",
-    "S4_4.wav",
-    "S4_5.wav",
-    "S4_6.wav",
-    "S4_7.wav",
-    "S4_8.wav",
-    "S4_9.wav",
-    "S4_10.wav",
-    "S4_11.wav",
-    "S4_12.wav",
-    "S4_13.wav",
-    "S4_14.wav",
-    "S4_15.wav",
-    "S4_16.wav",
-    "S4_17.wav",
-    "S4_18.wav",
-    "S4_19.wav",
-    "S4_20.wav"
-}
-#elif PIC5
-{
-    "S5_0.wav",
-    "S5_1.wav",
-    "S5_2.wav",
-    "S5_3.wav",
-    "S5_4.wav",
-    "S5_5.wav",
-    "S5_6.wav",
-    "S5_7.wav",
-    "S5_8.wav",
-    "S5_9.wav",
-    "S5_10.wav",
-    "S5_11.wav",
-    "S5_12.wav",
-    "S5_13.wav",
-    "S5_14.wav",
-    "S5_15.wav",
-    "S5_16.wav",
-    "S5_17.wav",
-    "S5_18.wav",
-    "S5_19.wav",
-    "S5_20.wav"
-};
+#define PACK_STRING     1
+#elif defined(PIC2)
+#define PACK_STRING     2
+#elif defined(PIC3)
+#define PACK_STRING     3
+#elif defined(PIC4)
+#define PACK_STRING     4
+#elif defined(PIC5)
+#define PACK_STRING     5
 #else
-{
-    "S6_0.wav",
-    "S6_1.wav",
-    "S6_2.wav",
-    "S6_3.wav",
-    "S6_4.wav",
-    "S6_5.wav",
-    "S6_6.wav",
-    "S6_7.wav",
-    "S6_8.wav",
-    "S6_9.wav",
-    "S6_10.wav",
-    "S6_11.wav",
-    "S6_12.wav",
-    "S6_13.wav",
-    "S6_14.wav",
-    "S6_15.wav",
-    "S6_16.wav",
-    "S6_17.wav",
-    "S6_18.wav",
-    "S6_19.wav",
-    "S6_20.wav"
-};
+#define PACK_STRING     6
 #endif
 
 #ifdef __cplusplus
@@ -3,38 +3,337 @@
  * @author Kue Yang
  * @date 11/22/2016
  * @details The FILES module will handle all file related tasks. Tasks includes:
- * opening and closing files, searching for files and reading files. This module
- * requires the Fatfs File System Library.
+ * opening and closing files, searching for files and reading files. The notes 
+ * are read from a single sample pack that is opened once. When the pack is 
+ * contiguous on the card, whole sectors are read straight from the card at an
+ * LBA computed from the note offset. The decoder borrows the pack a sector at a
+ * time from a window the sectors are read into. The card is brought up and
+ * recovered by a state machine run from the main loop, a card error or a card
+ * pulled out of the socket is retried without blocking until the pack can be 
+ * opened again. This module requires the Fatfs File System Library.
  */
 
 #include <p32xxxx.h>
 #include <stdio.h>
+#include <string.h>
 #include "STDDEF.h"
+#include "TIMER.h"
+#include "UART.h"
 #include "./fatfs/diskio.h"
 #include "./fatfs/ffconf.h"
 #include "./fatfs/ff.h"
+#include "PACKDEF.h"
 #include "FILES.h"
 
+/** @def FILES_LINKMAP_SIZE 
+ * Defines the size of the cluster link map of the sample pack. A pack split 
+ * into more than 15 fragments is read without fast seek. */
+#define FILES_LINKMAP_SIZE      32
+/** @def FILES_CONTIGUOUS_MAP 
+ * Defines the size of the cluster link map of a pack with a single fragment. */
+#define FILES_CONTIGUOUS_MAP    4
+/** @def FILES_NO_SECTOR 
+ * Defines the pack window index used when the window holds no sector. */
+#define FILES_NO_SECTOR         0xFFFFFFFF
+/** @def FILES_CARD_NONE 
+ * Defines the card state where no card is in the socket. */
+#define FILES_CARD_NONE         0
+/** @def FILES_CARD_INIT 
+ * Defines the card state where the card is initialized once the retry delay 
+ * has passed. */
+#define FILES_CARD_INIT         1
+/** @def FILES_CARD_WAKE 
+ * Defines the card state where the card is polled until it leaves idle state. */
+#define FILES_CARD_WAKE         2
+/** @def FILES_CARD_MOUNT 
+ * Defines the card state where the volume is mounted. */
+#define FILES_CARD_MOUNT        3
+/** @def FILES_CARD_MOUNTED 
+ * Defines the card state where the volume is mounted and the pack is waiting
+ * to be opened. */
+#define FILES_CARD_MOUNTED      4
+/** @def FILES_CARD_NO_PACK 
+ * Defines the card state where the volume is mounted but the pack is missing
+ * or invalid. The pack is opened again after an upload or a new card. */
+#define FILES_CARD_NO_PACK      5
+/** @def FILES_CARD_READY 
+ * Defines the card state where the pack is open and notes can be read. */
+#define FILES_CARD_READY        6
+/** @def FILES_INSERT_MS 
+ * Defines the time a card is left to power up once it is inserted in ms. */
+#define FILES_INSERT_MS         100
+/** @def FILES_RETRY_MIN_MS 
+ * Defines the delay before the first retry of a failed card in ms. */
+#define FILES_RETRY_MIN_MS      10
+/** @def FILES_RETRY_MAX_MS 
+ * Defines the longest delay between retries of a failed card in ms, the delay
+ * doubles after every failed retry. */
+#define FILES_RETRY_MAX_MS      1000
+
+BOOL FILES_ReadNote(UINT16 index, UINT16* noteId, AUDIOINFO* info, UINT32* dataOffset);
+UINT32 FILES_GetDword(BYTE* bytes);
+void FILES_RetryCard(UINT32 now);
+FRESULT FILES_CheckResult(FRESULT res);
+
 /**  
  * @privatesection
  * @{
  */
 FATFS FatFs;			/* File system object */
+FIL packFile;                           /* Sample pack file object */
+DWORD packLinkMap[FILES_LINKMAP_SIZE];  /* Cluster link map of the sample pack */
+DWORD packSector;                       /* First sector of a contiguous pack, 0 if fragmented */
+UINT16 packNumOfNotes;                  /* Number of notes in the sample pack */
+BYTE packWindow[PACK_SECTOR_SIZE];      /* Sector of the pack lent to the decoder */
+UINT32 packWindowIndex;                 /* Index of the pack sector in the window */
+UINT16 packWindowSize;                  /* Number of pack bytes in the window */
+UINT32 packReads;                       /* Number of reads of the pack that reached the card */
+UINT8 cardState;                        /* State of the card, see FILES_CARD_NONE */
+UINT32 cardNextMs;                      /* Millisecond count the card is next initialized at */
+UINT32 cardRetryMs;                     /* Delay before the next retry of the card in ms */
+BOOL isCardRecovering;                  /* The card is recovering from a fault */
+UINT32 cardFaultMs;                     /* Millisecond count of the last fault */
+UINT32 cardFaults;                      /* Number of card errors and removals */
+UINT32 cardRetries;                     /* Number of failed initializations and mounts */
+UINT32 cardRecoveries;                  /* Number of faults recovered from */
+UINT32 cardLastMs;                      /* Time taken by the last recovery in ms */
+UINT32 cardMaxMs;                       /* Longest recovery in ms */
+UINT32 cardTotalMs;                     /* Time taken by every recovery in ms */
 /** @} */
 
 /**
  * @brief Initializes the FILES module.
- * @details Initializes Microchip MDD File System library. Updates the file attributes
- * that will be used for file related operations. 
+ * @details The card is initialized and mounted by FILES_Process, so the 
+ * initialization doesn't wait for a card to be inserted.
  * @remark Requires Fatfs File System library.
  * @return Void
  */
 void FILES_Init(void)
 {
-    // Initialize the sd card to logical drive 0
-    while(disk_initialize(0));
-    // Mounts the sd card to logical drive 0
-    while(f_mount(&FatFs, "", 0));
+    cardState = FILES_CARD_INIT;
+    cardRetryMs = FILES_RETRY_MIN_MS;
+    cardNextMs = TIMER_GetMSecond();
+    isCardRecovering = FALSE;
+    FILES_ClearCard();
+    // The pack window is empty until the pack is lent.
+    packWindowIndex = FILES_NO_SECTOR;
+}
+
+/**
+ * @brief Runs the card state machine.
+ * @details Takes one step towards a mounted card each call, a card that fails
+ * to initialize or mount is retried with a delay that doubles up to 
+ * FILES_RETRY_MAX_MS. The card detect switch is read by the disk timer, a card
+ * pulled out is waited for. Run by the card task of the main loop.
+ * @return Void
+ */
+void FILES_Process(void)
+{
+    DSTATUS status = disk_status(0);
+    UINT32 now = TIMER_GetMSecond();
+    DRESULT res;
+    
+    if(status & STA_NODISK)
+    {
+        if(cardState != FILES_CARD_NONE)
+        {
+            FILES_SetCardFault();
+            cardState = FILES_CARD_NONE;
+        }
+        return;
+    }
+    
+    switch(cardState)
+    {
+        case FILES_CARD_NONE:
+            // Lets the inserted card power up.
+            cardState = FILES_CARD_INIT;
+            cardRetryMs = FILES_RETRY_MIN_MS;
+            cardNextMs = now + FILES_INSERT_MS;
+            break;
+        case FILES_CARD_INIT:
+            if((INT32)(now - cardNextMs) >= 0)
+            {
+                disk_initialize_start(0);
+                cardState = FILES_CARD_WAKE;
+            }
+            break;
+        case FILES_CARD_WAKE:
+            // The card is polled once per step until it leaves idle state.
+            res = disk_initialize_poll(0);
+            if(res == RES_OK)
+            {
+                cardState = FILES_CARD_MOUNT;
+            }
+            else if(res != RES_NOTRDY)
+            {
+                FILES_RetryCard(now);
+            }
+            break;
+        case FILES_CARD_MOUNT:
+            // Mounts now, not on the first access, so a bad volume is retried.
+            if(f_mount(&FatFs, "", 1) == FR_OK)
+            {
+                cardState = FILES_CARD_MOUNTED;
+            }
+            else
+            {
+                FILES_RetryCard(now);
+            }
+            break;
+        case FILES_CARD_NO_PACK:
+        case FILES_CARD_READY:
+            // A card that lost its initialization is brought up again.
+            if(status & STA_NOINIT)
+            {
+                FILES_SetCardFault();
+            }
+            break;
+        default:
+            // The mounted card waits for the pack to be opened.
+            break;
+    }
+}
+
+/**
+ * @brief Retries a card that failed to initialize or mount.
+ * @arg now The millisecond count.
+ * @return Void
+ */
+void FILES_RetryCard(UINT32 now)
+{
+    cardRetries++;
+    cardState = FILES_CARD_INIT;
+    cardNextMs = now + cardRetryMs;
+    cardRetryMs = ((cardRetryMs*2) > FILES_RETRY_MAX_MS) ? FILES_RETRY_MAX_MS : (cardRetryMs*2);
+}
+
+/**
+ * @brief Checks if notes can be read from the pack.
+ * @return Returns a boolean indicating if the card is up and the pack is open.
+ */
+BOOL FILES_IsReady(void)
+{
+    return (cardState == FILES_CARD_READY);
+}
+
+/**
+ * @brief Checks if the pack needs to be opened.
+ * @return Returns a boolean indicating if the card has been mounted since the
+ * pack was last opened.
+ */
+BOOL FILES_NeedsPack(void)
+{
+    return (cardState == FILES_CARD_MOUNTED);
+}
+
+/**
+ * @brief Starts recovering the card.
+ * @details Called when the card fails to read or is pulled out, and from the 
+ * monitor to inject a fault. The pack can't be read until the card has been 
+ * initialized and mounted again and the pack has been reopened. The time the 
+ * recovery takes is measured from the first fault.
+ * @return Void
+ */
+void FILES_SetCardFault(void)
+{
+    UINT32 now = TIMER_GetMSecond();
+    
+    if(cardState >= FILES_CARD_MOUNTED)
+    {
+        cardFaults++;
+        if(!isCardRecovering)
+        {
+            isCardRecovering = TRUE;
+            cardFaultMs = now;
+        }
+    }
+    packWindowIndex = FILES_NO_SECTOR;
+    cardState = FILES_CARD_INIT;
+    cardRetryMs = FILES_RETRY_MIN_MS;
+    cardNextMs = now;
+}
+
+/**
+ * @brief Checks the result of a pack access.
+ * @details A disk error starts the recovery of the card. The first access of 
+ * the pack that reaches a mounted card ends the recovery. A pack that is 
+ * missing or invalid is a pack fault, the card isn't ready and the recovery
+ * isn't over until a pack is opened.
+ * @arg res The result of the access.
+ * @return Returns the result.
+ */
+FRESULT FILES_CheckResult(FRESULT res)
+{
+    UINT32 ms = 0;
+    
+    if((res == FR_DISK_ERR) || (res == FR_NOT_READY) || (res == FR_INT_ERR))
+    {
+        FILES_SetCardFault();
+    }
+    else if((res != FR_OK) && (cardState == FILES_CARD_MOUNTED))
+    {
+        cardState = FILES_CARD_NO_PACK;
+    }
+    else if(cardState == FILES_CARD_MOUNTED)
+    {
+        cardState = FILES_CARD_READY;
+        cardRetryMs = FILES_RETRY_MIN_MS;
+        if(isCardRecovering)
+        {
+            isCardRecovering = FALSE;
+            ms = TIMER_GetMSecond() - cardFaultMs;
+            cardRecoveries++;
+            cardLastMs = ms;
+            cardTotalMs += ms;
+            if(ms > cardMaxMs)
+            {
+                cardMaxMs = ms;
+            }
+        }
+    }
+    return res;
+}
+
+/**
+ * @brief Displays the card statistics.
+ * @details Displays the state of the card, the number of faults and failed 
+ * retries and the time taken to recover. A recovery lasts from the fault until
+ * the pack is reopened, including any time the card was out of the socket.
+ * @arg reset Clears the statistics after they are displayed.
+ * @return Void
+ */
+void FILES_ShowCard(BOOL reset)
+{
+    char buf[96];
+    
+    snprintf(&buf[0], 96, "Card: %s, %u faults, %u retries, %u recoveries", 
+            (cardState == FILES_CARD_READY) ? "ready" : ((cardState == FILES_CARD_NONE) ? "no card" : 
+            ((cardState == FILES_CARD_NO_PACK) ? "no pack" : "recovering")),
+            cardFaults, cardRetries, cardRecoveries);
+    MON_SendString(&buf[0]);
+    snprintf(&buf[0], 96, "Recovery: last %u ms, mean %u ms, max %u ms", cardLastMs,
+            (cardRecoveries > 0) ? cardTotalMs/cardRecoveries : 0, cardMaxMs);
+    MON_SendString(&buf[0]);
+    
+    if(reset)
+    {
+        FILES_ClearCard();
+    }
+}
+
+/**
+ * @brief Clears the card statistics.
+ * @return Void
+ */
+void FILES_ClearCard(void)
+{
+    cardFaults = 0;
+    cardRetries = 0;
+    cardRecoveries = 0;
+    cardLastMs = 0;
+    cardMaxMs = 0;
+    cardTotalMs = 0;
 }
 
 /**
@@ -141,3 +440,300 @@ FRESULT FILES_ReadFile(FIL* file, BYTE* buffer, UINT16 bytes, UINT16* ptr)
 {
      return f_read(file, buffer, bytes, ptr);
 }
+
+/**
+ * @brief Moves the file pointer
+ * @details Moves the file pointer of a specific file
+ * @arg file The file data structure 
+ * @arg offset The offset from the beginning of the file
+ * @return Returns a code indicating if the file pointer successfully moved or not.
+ */
+FRESULT FILES_SeekFile(FIL* file, DWORD offset)
+{
+     return f_lseek(file, offset);
+}
+
+
+/**
+ * @brief Opens the sample pack
+ * @details Opens the sample pack and verifies its header. A cluster link map 
+ * is created so seeking within the pack doesn't read the FAT. If the pack is a 
+ * single fragment, the sector the pack starts at is stored so notes can be read
+ * by LBA.
+ * @arg fileName The name of the sample pack
+ * @return Returns a code indicating if the pack successfully opens or not.
+ */
+FRESULT FILES_OpenPack(const char* fileName)
+{
+    BYTE header[PACK_HEADER_SIZE];
+    UINT16 readPtr = 0;
+    FRESULT res;
+    
+    // Closes the pack so it is read again after an upload.
+    f_close(&packFile);
+    packNumOfNotes = 0;
+    packSector = 0;
+    packWindowIndex = FILES_NO_SECTOR;
+    
+    if(cardState < FILES_CARD_MOUNTED)
+    {
+        return FR_NOT_READY;
+    }
+    // Notes can't be read until the pack is open again.
+    cardState = FILES_CARD_MOUNTED;
+    
+    res = f_open(&packFile, fileName, FA_READ);
+    if(res != FR_OK)
+    {
+        return FILES_CheckResult(res);
+    }
+    
+    // Verifies the header.
+    res = f_read(&packFile, &header[0], PACK_HEADER_SIZE, &readPtr);
+    if(res != FR_OK)
+    {
+        return FILES_CheckResult(res);
+    }
+    if((readPtr != PACK_HEADER_SIZE) ||
+            (memcmp(&header[PACK_MAGIC], "SPAK", 4) != 0) ||
+            (header[PACK_VERSION] != PACK_VERSION_1))
+    {
+        return FILES_CheckResult(FR_NO_FILE);
+    }
+    packNumOfNotes = (header[PACK_NUM_OF_NOTES+1] << 8) | header[PACK_NUM_OF_NOTES];
+    
+    // Creates the cluster link map, a badly fragmented pack uses normal seeks.
+    packFile.cltbl = &packLinkMap[0];
+    packLinkMap[0] = FILES_LINKMAP_SIZE;
+    if(f_lseek(&packFile, CREATE_LINKMAP) != FR_OK)
+    {
+        packFile.cltbl = NULL;
+    }
+    else if(packLinkMap[0] == FILES_CONTIGUOUS_MAP)
+    {
+        // The pack starts at the first sector of its first cluster.
+        packSector = FatFs.database + (packLinkMap[2] - 2)*FatFs.csize;
+    }
+    return FILES_CheckResult(FR_OK);
+}
+
+/**
+ * @brief Returns the number of reads of the sample pack
+ * @details Lending a sector already in the pack window doesn't read the card
+ * and isn't counted.
+ * @return Returns the number of reads that reached the card since startup.
+ */
+UINT32 FILES_GetPackReads(void)
+{
+    return packReads;
+}
+
+/**
+ * @brief Returns the first sector of the sample pack
+ * @return Returns the LBA the pack starts at, 0 if the pack isn't contiguous.
+ */
+DWORD FILES_GetPackSector(void)
+{
+    return packSector;
+}
+
+/**
+ * @brief Returns the size of the sample pack in sectors
+ * @return Returns the number of sectors that can be read or written by LBA, 0 
+ * if the pack isn't contiguous or the card isn't ready.
+ */
+UINT32 FILES_GetPackSectors(void)
+{
+    if((packSector == 0) || (cardState != FILES_CARD_READY))
+    {
+        return 0;
+    }
+    return f_size(&packFile)/PACK_SECTOR_SIZE;
+}
+
+/**
+ * @brief Finds a note in the sample pack
+ * @details Searches the note table for the note and stores its audio header 
+ * data. The file name is set to the name of the WAV file the note was built 
+ * from.
+ * @arg noteId The note to find, see PACK_MAKE_NOTE_ID.
+ * @arg info The audio header data of the note.
+ * @arg dataOffset The offset of the audio data in the pack.
+ * @return Returns a boolean indicating if the note is found.
+ */
+BOOL FILES_FindNote(UINT16 noteId, AUDIOINFO* info, UINT32* dataOffset)
+{
+    UINT16 index = 0, id = 0;
+    
+    for(index = 0; index < packNumOfNotes; index++)
+    {
+        if(FILES_ReadNote(index, &id, info, dataOffset) && (id == noteId))
+        {
+            return TRUE;
+        }
+    }
+    
+    memset(info, 0, sizeof(AUDIOINFO));
+    *dataOffset = 0;
+    return FALSE;
+}
+
+/**
+ * @brief Displays the notes in the sample pack
+ * @details Displays the list of notes and indicates which note is selected.
+ * @arg selectedName The file name of the selected note.
+ * @return Returns a boolean indicating if the list of notes is found.
+ */
+BOOL FILES_ListNotes(const char* selectedName)
+{
+    char buf[128];
+    AUDIOINFO info;
+    UINT32 dataOffset = 0;
+    UINT16 index = 0, id = 0;
+    
+    if(packNumOfNotes == 0)
+    {
+        return FALSE;
+    }
+    
+    snprintf(&buf[0], 128, "Showing all %u notes in the sample pack (%s):", packNumOfNotes, 
+            (packSector != 0) ? "contiguous" : "fragmented");
+    MON_SendString(&buf[0]);
+    
+    for(index = 0; index < packNumOfNotes; index++)
+    {
+        if(!FILES_ReadNote(index, &id, &info, &dataOffset))
+        {
+            return FALSE;
+        }
+        snprintf(&buf[0], 128, "%s\t%u KB %u%s%s", info.fileName, info.dataSize/1000, index,
+                (info.loopLength > 0) ? " loop" : "",
+                MON_stringsMatch(selectedName, &info.fileName[0]) ? " ***" : "");
+        MON_SendString(&buf[0]);
+    }
+    return TRUE;
+}
+
+/**
+ * @brief Reads a note table entry
+ * @arg index The index of the entry.
+ * @arg noteId The note ID of the entry.
+ * @arg info The audio header data of the note.
+ * @arg dataOffset The offset of the audio data in the pack.
+ * @return Returns a boolean indicating if the entry was read.
+ */
+BOOL FILES_ReadNote(UINT16 index, UINT16* noteId, AUDIOINFO* info, UINT32* dataOffset)
+{
+    BYTE entry[PACK_ENTRY_SIZE];
+    UINT16 readPtr = 0;
+    
+    if(FILES_ReadPack(PACK_HEADER_SIZE + (UINT32)index*PACK_ENTRY_SIZE, &entry[0], PACK_ENTRY_SIZE, &readPtr) != FR_OK ||
+            readPtr != PACK_ENTRY_SIZE)
+    {
+        return FALSE;
+    }
+    
+    *noteId = (entry[PACK_NOTE_ID+1] << 8) | entry[PACK_NOTE_ID];
+    *dataOffset = FILES_GetDword(&entry[PACK_NOTE_OFFSET]);
+    info->numOfChannels = entry[PACK_NOTE_CHANNELS];
+    info->bitsPerSample = entry[PACK_NOTE_BITS];
+    info->sampleRate = (UINT16)FILES_GetDword(&entry[PACK_NOTE_SAMPLE_RATE]);
+    info->blockAlign = (entry[PACK_NOTE_BLOCK_ALIGN+1] << 8) | entry[PACK_NOTE_BLOCK_ALIGN];
+    info->dataSize = FILES_GetDword(&entry[PACK_NOTE_LENGTH]);
+    info->loopStart = FILES_GetDword(&entry[PACK_NOTE_LOOP_START]);
+    info->loopLength = FILES_GetDword(&entry[PACK_NOTE_LOOP_LENGTH]);
+    info->startFrame = FILES_GetDword(&entry[PACK_NOTE_START]);
+    snprintf(&info->fileName[0], sizeof(info->fileName), "S%u_%u.wav", 
+            PACK_NOTE_STRING(*noteId), PACK_NOTE_FRET(*noteId));
+    return TRUE;
+}
+
+/**
+ * @brief Reads the sample pack
+ * @details Reads whole sectors of a contiguous pack straight from the card. 
+ * Other reads go through the file system. A disk error starts the recovery of
+ * the card, the pack isn't read until the card is mounted again.
+ * @arg offset The offset from the beginning of the pack
+ * @arg buffer The buffer to store the bytes read.
+ * @arg bytes The number of bytes to read
+ * @arg ptr A pointer to the number of bytes read
+ * @return Returns a code indicating if the pack successfully read or not.
+ */
+FRESULT FILES_ReadPack(UINT32 offset, BYTE* buffer, UINT16 bytes, UINT16* ptr)
+{
+    FRESULT res;
+    
+    if(cardState < FILES_CARD_MOUNTED)
+    {
+        *ptr = 0;
+        return FR_NOT_READY;
+    }
+    
+    packReads++;
+    if((packSector != 0) && (bytes > 0) && (offset % PACK_SECTOR_SIZE) == 0 && (bytes % PACK_SECTOR_SIZE) == 0)
+    {
+        if(disk_read(0, buffer, packSector + offset/PACK_SECTOR_SIZE, bytes/PACK_SECTOR_SIZE) != RES_OK)
+        {
+            *ptr = 0;
+            return FILES_CheckResult(FR_DISK_ERR);
+        }
+        *ptr = bytes;
+        return FR_OK;
+    }
+    
+    res = f_lseek(&packFile, offset);
+    if(res == FR_OK)
+    {
+        res = f_read(&packFile, buffer, bytes, ptr);
+    }
+    return FILES_CheckResult(res);
+}
+
+/**
+ * @brief Lends the sample pack without copying it.
+ * @details Reads the sector holding the offset into the pack window, unless it
+ * is already there, and points at the offset within it. The whole sector is read
+ * straight into the window by the card or the file system, so the data isn't 
+ * copied again before it is decoded.
+ * @remarks The data is valid until the pack is lent or opened again.
+ * @arg offset The offset from the beginning of the pack
+ * @arg bytes The most bytes wanted
+ * @arg data A pointer to the pointer set to the data
+ * @arg ptr A pointer to the number of bytes lent, up to the end of the sector
+ * @return Returns a code indicating if the pack successfully read or not.
+ */
+FRESULT FILES_LendPack(UINT32 offset, UINT16 bytes, const BYTE** data, UINT16* ptr)
+{
+    UINT32 index = offset/PACK_SECTOR_SIZE;
+    UINT16 start = offset%PACK_SECTOR_SIZE;
+    FRESULT res;
+    
+    *ptr = 0;
+    if(index != packWindowIndex)
+    {
+        packWindowIndex = FILES_NO_SECTOR;
+        res = FILES_ReadPack(index*PACK_SECTOR_SIZE, &packWindow[0], PACK_SECTOR_SIZE, &packWindowSize);
+        if(res != FR_OK)
+        {
+            return res;
+        }
+        packWindowIndex = index;
+    }
+    
+    if(start < packWindowSize)
+    {
+        *data = &packWindow[start];
+        *ptr = ((packWindowSize - start) < bytes) ? (packWindowSize - start) : bytes;
+    }
+    return FR_OK;
+}
+
+/**
+ * @brief Returns a little endian 32-bit value.
+ * @arg bytes The bytes of the value.
+ * @return Returns the value.
+ */
+UINT32 FILES_GetDword(BYTE* bytes)
+{
+    return ((UINT32)bytes[3] << 24) | ((UINT32)bytes[2] << 16) | ((UINT32)bytes[1] << 8) | bytes[0];
+}
\ No newline at end of file
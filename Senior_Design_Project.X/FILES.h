@@ -26,32 +26,51 @@ typedef struct AUDIOINFO
     UINT16  sampleRate;         /**< Variable used to store the sample rate. */
     UINT16  blockAlign;         /**< Variable used to store the block align. */
     UINT32  dataSize;           /**< Variable used to store the size of the file data. */
+    UINT32  loopStart;          /**< Variable used to store the first sample frame of the sustain loop. */
+    UINT32  loopLength;         /**< Variable used to store the sample frames in the sustain loop, 0 if none. */
+    UINT32  startFrame;         /**< Variable used to store the first sample frame played, 0 if untrimmed. */
     char fileName[16];          /**< Variable used to store the file name. */
     /**@}*/
 }AUDIOINFO;
 
 /**
  * @brief FILES data structure.
- * @details The FILES data structure is used to store the file data used in
- * conjunction with the Fatfs File System Library. The structure also stores the
- * audio header data corresponding to the specified file.
+ * @details The FILES data structure is used to store the location of a note in
+ * the sample pack. The structure also stores the audio header data 
+ * corresponding to the specified note.
  */
 typedef struct FILES
 {
     /**@{*/
-    FIL File;			/* File objects */
-    FSIZE_t startPtr;
-    DWORD cluster;
-    DWORD sector;
+    UINT32 dataOffset;          /**< Variable used to store the offset of the audio data in the sample pack. */
     AUDIOINFO audioInfo;
+    const BYTE* attackData;     /**< Variable used to point to the attack held in program flash. */
+    UINT32 attackSize;          /**< Variable used to store the size of the attack, 0 if none. */
+    UINT32 startOffset;         /**< Variable used to store the offset of the first byte played in the audio data. */
     /**@}*/
 }FILES;
 
+void FILES_Init(void);
+void FILES_Process(void);
+BOOL FILES_IsReady(void);
+BOOL FILES_NeedsPack(void);
+void FILES_SetCardFault(void);
+void FILES_ShowCard(BOOL reset);
+void FILES_ClearCard(void);
 FRESULT FILES_ReadFile(FIL* file, BYTE* buffer, UINT16 bytes, UINT16* ptr);
+FRESULT FILES_SeekFile(FIL* file, DWORD offset);
 FRESULT FILES_FindFile(DIR* dir, FILINFO* fileInfo, const char* fileName);
 BOOL FILES_ListFiles(const char* selectedName);
 FRESULT FILES_CloseFile(FIL* file);
 FRESULT FILES_OpenFile(FIL* file, const char* fileName, int mode);
+FRESULT FILES_OpenPack(const char* fileName);
+BOOL FILES_FindNote(UINT16 noteId, AUDIOINFO* info, UINT32* dataOffset);
+BOOL FILES_ListNotes(const char* selectedName);
+FRESULT FILES_ReadPack(UINT32 offset, BYTE* buffer, UINT16 bytes, UINT16* ptr);
+FRESULT FILES_LendPack(UINT32 offset, UINT16 bytes, const BYTE** data, UINT16* ptr);
+UINT32 FILES_GetPackReads(void);
+DWORD FILES_GetPackSector(void);
+UINT32 FILES_GetPackSectors(void);
 
 #ifdef	__cplusplus
 }
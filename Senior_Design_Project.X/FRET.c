@@ -0,0 +1,428 @@
+/**
+ * @file FRET.c
+ * @author Kue Yang
+ * @date 10/19/2026
+ * @details The FRET module finds the finger position on each string from its
+ * resistive position sensor. The sensors are converted by the ADC in the same
+ * scan as the strumming sensors and every reading is smoothed as it arrives.
+ * The fret task maps the smoothed reading of each string to a fret through a
+ * table of the reading at the center of every fret, with hysteresis so a
+ * finger resting on a fret wire doesn't flicker between two notes, and to a
+ * fractional position between the fret centers used to bend fretless notes.
+ * @remarks The table follows the fret spacing, which shrinks by the twelfth
+ * root of 2 every fret, through the lowest and highest calibrated frets. The
+ * calibration is kept until the next reset.
+ */
+
+#include <p32xxxx.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "STDDEF.h"
+#include "UART.h"
+#include "FRET.h"
+
+/** @def FRET_READING_Q
+ * Defines the number of fractional bits of a smoothed reading. */
+#define FRET_READING_Q          4
+/** @def FRET_FILTER_SHIFT
+ * Defines the time constant of the smoothing, 2^3 scans. */
+#define FRET_FILTER_SHIFT       3
+/** @def FRET_MAX_READING
+ * Defines the largest ADC reading. */
+#define FRET_MAX_READING        1023
+/** @def FRET_NO_TOUCH
+ * Defines the reading below which a string isn't touched until calibrated. */
+#define FRET_NO_TOUCH           32
+/** @def FRET_NO_TOUCH_MARGIN
+ * Defines the margin kept above the reading of an untouched string. */
+#define FRET_NO_TOUCH_MARGIN    24
+/** @def FRET_DEFAULT_LOW
+ * Defines the reading at the center of fret 1 until calibrated. */
+#define FRET_DEFAULT_LOW        96
+/** @def FRET_DEFAULT_HIGH
+ * Defines the reading at the center of the highest fret until calibrated. */
+#define FRET_DEFAULT_HIGH       960
+/** @def FRET_HYSTERESIS_DIV
+ * Defines the hysteresis, the reading has to pass the boundary between two
+ * frets by 1/FRET_HYSTERESIS_DIV of the fret width to change fret. */
+#define FRET_HYSTERESIS_DIV     4
+
+/** @var fretSpacing
+ * The distance of each fret center from the nut as a share of the scale
+ * length, 1 - 2^(-(fret - 0.5)/12) in Q15. The open string has no center. */
+const INT16 fretSpacing[FRET_NUM_OF_FRETS + 1] = {
+    0, 933, 2720, 4406, 5998, 7500, 8919, 10257, 11521, 12713, 13839,
+    14901, 15904, 16850, 17744, 18587, 19383, 20134, 20843, 21513, 22144
+};
+/** @var fretFiltered
+ * The smoothed reading of each string, FRET_READING_Q fractional bits, 0 while
+ * the string isn't touched. */
+volatile UINT32 fretFiltered[FRET_NUM_OF_STRINGS];
+/** @var fretRaw
+ * The last reading of each string. */
+volatile UINT16 fretRaw[FRET_NUM_OF_STRINGS];
+/** @var fretNoTouch
+ * The reading below which each string isn't touched. */
+UINT16 fretNoTouch[FRET_NUM_OF_STRINGS];
+/** @var fretCenters
+ * The reading at the center of each fret of each string. */
+UINT16 fretCenters[FRET_NUM_OF_STRINGS][FRET_NUM_OF_FRETS + 1];
+/** @var fretCalReadings
+ * The reading measured at the center of each calibrated fret. */
+UINT16 fretCalReadings[FRET_NUM_OF_STRINGS][FRET_NUM_OF_FRETS + 1];
+/** @var fretCalMask
+ * The calibrated frets of each string, bit n is set if fret n is calibrated. */
+UINT32 fretCalMask[FRET_NUM_OF_STRINGS];
+/** @var fretCurrent
+ * The fret pressed on each string, 0 if open. */
+int fretCurrent[FRET_NUM_OF_STRINGS];
+/** @var fretPosition
+ * The finger position on each string in frets, FRET_POSITION_Q fractional bits. */
+INT32 fretPosition[FRET_NUM_OF_STRINGS];
+/** @var fretChanges
+ * The number of fret changes of each string. */
+UINT32 fretChanges[FRET_NUM_OF_STRINGS];
+
+void FRET_ClearString(int string);
+void FRET_BuildTable(int string);
+INT32 FRET_GetModel(int fret, int loFret, INT32 loReading, int hiFret, INT32 hiReading);
+void FRET_Resolve(int string);
+INT32 FRET_GetHysteresis(int string, int fret, int nextFret);
+INT32 FRET_Interpolate(int string, int fret, INT32 reading);
+
+/**
+ * @brief Initializes the FRET module.
+ * @details The strings start open with the default table.
+ * @return Void
+ */
+void FRET_Init(void)
+{
+    int i = 0;
+    
+    for(i = 0; i < FRET_NUM_OF_STRINGS; i++)
+    {
+        FRET_ClearString(i);
+    }
+}
+
+/**
+ * @brief Clears the state and calibration of a string.
+ * @arg string The string.
+ * @return Void
+ */
+void FRET_ClearString(int string)
+{
+    fretFiltered[string] = 0;
+    fretRaw[string] = 0;
+    fretNoTouch[string] = FRET_NO_TOUCH;
+    fretCalMask[string] = 0;
+    fretCurrent[string] = 0;
+    fretPosition[string] = 0;
+    fretChanges[string] = 0;
+    FRET_BuildTable(string);
+}
+
+/**
+ * @brief Adds a scan of the position sensors.
+ * @details Called by the ADC interrupt with one reading per string. A reading
+ * below the untouched level releases the string at once and the first reading
+ * of a touch is taken as is, so the smoothing never slides across the frets
+ * between the nut and the finger.
+ * @arg readings The reading of each string.
+ * @return Void
+ */
+void FRET_AddReadings(const UINT16* readings)
+{
+    int i = 0;
+    
+    for(i = 0; i < FRET_NUM_OF_STRINGS; i++)
+    {
+        fretRaw[i] = readings[i];
+        if(readings[i] < fretNoTouch[i])
+        {
+            fretFiltered[i] = 0;
+        }
+        else if(fretFiltered[i] == 0)
+        {
+            fretFiltered[i] = (UINT32)readings[i] << FRET_READING_Q;
+        }
+        else
+        {
+            fretFiltered[i] += (((INT32)readings[i] << FRET_READING_Q) - (INT32)fretFiltered[i]) >> FRET_FILTER_SHIFT;
+        }
+    }
+}
+
+/**
+ * @brief Finds the fret and position of every string.
+ * @details Run by the fret task of the main loop.
+ * @return Void
+ */
+void FRET_Process(void)
+{
+    int i = 0;
+    
+    for(i = 0; i < FRET_NUM_OF_STRINGS; i++)
+    {
+        FRET_Resolve(i);
+    }
+}
+
+/**
+ * @brief Finds the fret and position of a string.
+ * @details The fret is the one whose center is closest to the reading, unless
+ * the fret that is pressed is within the hysteresis.
+ * @arg string The string.
+ * @return Void
+ */
+void FRET_Resolve(int string)
+{
+    INT32 reading = (INT32)fretFiltered[string];
+    INT32 distance = 0, nearest = 0;
+    int fret = 0, nearestFret = 0;
+    
+    if(reading == 0)
+    {
+        fretCurrent[string] = 0;
+        fretPosition[string] = 0;
+        return;
+    }
+    
+    for(fret = 1; fret <= FRET_NUM_OF_FRETS; fret++)
+    {
+        distance = abs(reading - ((INT32)fretCenters[string][fret] << FRET_READING_Q));
+        if((fret == 1) || (distance < nearest))
+        {
+            nearest = distance;
+            nearestFret = fret;
+        }
+    }
+    
+    // Stays on the pressed fret until the reading is past the boundary by the hysteresis
+    fret = fretCurrent[string];
+    if((fret > 0) && (nearestFret != fret))
+    {
+        distance = abs(reading - ((INT32)fretCenters[string][fret] << FRET_READING_Q));
+        if((distance - nearest) < FRET_GetHysteresis(string, fret, nearestFret))
+        {
+            nearestFret = fret;
+        }
+    }
+    
+    if(nearestFret != fretCurrent[string])
+    {
+        fretChanges[string]++;
+    }
+    fretCurrent[string] = nearestFret;
+    fretPosition[string] = FRET_Interpolate(string, nearestFret, reading);
+}
+
+/**
+ * @brief Returns the hysteresis of a fret.
+ * @details The difference between the distances of the reading to two fret
+ * centers grows twice as fast as the reading moves past their boundary.
+ * @arg string The string.
+ * @arg fret The fret that is pressed.
+ * @arg nextFret The fret closest to the reading.
+ * @return Returns the hysteresis as a difference of distances, FRET_READING_Q
+ * fractional bits.
+ */
+INT32 FRET_GetHysteresis(int string, int fret, int nextFret)
+{
+    int neighbor = (nextFret > fret) ? (fret + 1) : (fret - 1);
+    INT32 width = abs((INT32)fretCenters[string][fret] - (INT32)fretCenters[string][neighbor]);
+    
+    return (2*(width << FRET_READING_Q))/FRET_HYSTERESIS_DIV;
+}
+
+/**
+ * @brief Returns the position of a reading between two fret centers.
+ * @details The reading is interpolated towards the neighboring center on its
+ * side. The position stops at the centers of the first and highest frets.
+ * @arg string The string.
+ * @arg fret The fret that is pressed.
+ * @arg reading The smoothed reading.
+ * @return Returns the position in frets, FRET_POSITION_Q fractional bits.
+ */
+INT32 FRET_Interpolate(int string, int fret, INT32 reading)
+{
+    INT32 center = (INT32)fretCenters[string][fret] << FRET_READING_Q;
+    INT32 offset = reading - center;
+    INT32 span = 0;
+    BOOL isRising = (fretCenters[string][FRET_NUM_OF_FRETS] >= fretCenters[string][1]);
+    int neighbor = ((offset > 0) == isRising) ? (fret + 1) : (fret - 1);
+    
+    if(neighbor < 1 || neighbor > FRET_NUM_OF_FRETS)
+    {
+        return (INT32)fret << FRET_POSITION_Q;
+    }
+    
+    span = ((INT32)fretCenters[string][neighbor] << FRET_READING_Q) - center;
+    if(span == 0)
+    {
+        return (INT32)fret << FRET_POSITION_Q;
+    }
+    return ((INT32)fret << FRET_POSITION_Q) + (neighbor - fret)*((offset << FRET_POSITION_Q)/span);
+}
+
+/**
+ * @brief Builds the fret table of a string.
+ * @details The centers follow the fret spacing through the lowest and highest
+ * calibrated frets. A single calibrated fret shifts the default table through
+ * it. The calibrated frets keep their measured readings.
+ * @arg string The string.
+ * @return Void
+ */
+void FRET_BuildTable(int string)
+{
+    int loFret = 1, hiFret = FRET_NUM_OF_FRETS, fret = 0, count = 0;
+    INT32 loReading = FRET_DEFAULT_LOW, hiReading = FRET_DEFAULT_HIGH, center = 0;
+    
+    for(fret = 1; fret <= FRET_NUM_OF_FRETS; fret++)
+    {
+        if(fretCalMask[string] & (1UL << fret))
+        {
+            if(count == 0)
+            {
+                loFret = fret;
+                loReading = fretCalReadings[string][fret];
+            }
+            hiFret = fret;
+            hiReading = fretCalReadings[string][fret];
+            count++;
+        }
+    }
+    
+    if(count < 2)
+    {
+        center = (count == 1) ? (loReading - FRET_GetModel(loFret, 1, FRET_DEFAULT_LOW,
+                FRET_NUM_OF_FRETS, FRET_DEFAULT_HIGH)) : 0;
+        loFret = 1;
+        hiFret = FRET_NUM_OF_FRETS;
+        loReading = FRET_DEFAULT_LOW + center;
+        hiReading = FRET_DEFAULT_HIGH + center;
+    }
+    
+    fretCenters[string][0] = 0;
+    for(fret = 1; fret <= FRET_NUM_OF_FRETS; fret++)
+    {
+        if(fretCalMask[string] & (1UL << fret))
+        {
+            fretCenters[string][fret] = fretCalReadings[string][fret];
+            continue;
+        }
+    
+        center = FRET_GetModel(fret, loFret, loReading, hiFret, hiReading);
+        if(center < 0)
+        {
+            center = 0;
+        }
+        else if(center > FRET_MAX_READING)
+        {
+            center = FRET_MAX_READING;
+        }
+        fretCenters[string][fret] = center;
+    }
+}
+
+/**
+ * @brief Returns the reading at the center of a fret following the fret spacing.
+ * @arg fret The fret.
+ * @arg loFret The lower fret the spacing goes through.
+ * @arg loReading The reading at the center of the lower fret.
+ * @arg hiFret The higher fret the spacing goes through.
+ * @arg hiReading The reading at the center of the higher fret.
+ * @return Returns the reading at the center of the fret.
+ */
+INT32 FRET_GetModel(int fret, int loFret, INT32 loReading, int hiFret, INT32 hiReading)
+{
+    return loReading + ((hiReading - loReading)*(fretSpacing[fret] - fretSpacing[loFret]))/
+            (fretSpacing[hiFret] - fretSpacing[loFret]);
+}
+
+/**
+ * @brief Returns the fret pressed on a string.
+ * @arg string The string.
+ * @return Returns the fret, 0 if the string is open.
+ */
+int FRET_GetFret(int string)
+{
+    return fretCurrent[string];
+}
+
+/**
+ * @brief Returns the finger position on a string.
+ * @details The center of each fret is a whole fret, so a finger resting on the
+ * center of a fret plays its note and a finger between two centers bends
+ * between their notes.
+ * @arg string The string.
+ * @return Returns the position in frets, FRET_POSITION_Q fractional bits, 0 if
+ * the string is open.
+ */
+INT32 FRET_GetPosition(int string)
+{
+    return fretPosition[string];
+}
+
+/**
+ * @brief Calibrates a fret of a string.
+ * @details Fret 0 is calibrated while the string isn't touched and sets the
+ * untouched level above the reading. Any other fret is calibrated while it is
+ * pressed and stores the reading as its center.
+ * @arg string The string.
+ * @arg fret The fret.
+ * @return Returns a boolean indicating if the fret was calibrated.
+ */
+BOOL FRET_Calibrate(int string, int fret)
+{
+    if(string < 0 || string >= FRET_NUM_OF_STRINGS || fret < 0 || fret > FRET_NUM_OF_FRETS)
+    {
+        return FALSE;
+    }
+    
+    if(fret == 0)
+    {
+        fretNoTouch[string] = fretRaw[string] + FRET_NO_TOUCH_MARGIN;
+        return TRUE;
+    }
+    
+    if(fretFiltered[string] == 0)
+    {
+        return FALSE;
+    }
+    fretCalReadings[string][fret] = (fretFiltered[string] + (1 << (FRET_READING_Q - 1))) >> FRET_READING_Q;
+    fretCalMask[string] |= 1UL << fret;
+    FRET_BuildTable(string);
+    return TRUE;
+}
+
+/**
+ * @brief Displays the position and fret table of a string.
+ * @arg string The string.
+ * @arg reset Clears the calibration of the string if set to TRUE.
+ * @return Void
+ */
+void FRET_ShowStats(int string, BOOL reset)
+{
+    char buf[128];
+    INT32 position = fretPosition[string];
+    int fret = 0, length = 0;
+    
+    snprintf(&buf[0], 128, "String %d: reading %u, fret %d, position %d.%02d, open below %u, %u fret changes",
+            string, fretRaw[string], fretCurrent[string], position >> FRET_POSITION_Q,
+            ((position & ((1 << FRET_POSITION_Q) - 1))*100) >> FRET_POSITION_Q, fretNoTouch[string],
+            fretChanges[string]);
+    MON_SendString(&buf[0]);
+    
+    length = snprintf(&buf[0], 128, "Calibrated 0x%06X, centers:", fretCalMask[string]);
+    for(fret = 1; fret <= FRET_NUM_OF_FRETS; fret++)
+    {
+        length += snprintf(&buf[length], 128 - length, " %u", fretCenters[string][fret]);
+    }
+    MON_SendString(&buf[0]);
+    
+    if(reset == TRUE)
+    {
+        FRET_ClearString(string);
+    }
+}
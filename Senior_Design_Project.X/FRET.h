@@ -0,0 +1,39 @@
+/**
+ * @file FRET.h
+ * @author Kue Yang
+ * @date 10/19/2026
+ */
+
+#ifndef FRET_H
+#define	FRET_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include "STDDEF.h"
+
+/** @def FRET_NUM_OF_STRINGS
+ * Defines the number of strings, one position sensor per string. */
+#define FRET_NUM_OF_STRINGS     4
+/** @def FRET_NUM_OF_FRETS
+ * Defines the highest fret, one note per fret is played above the open string. */
+#define FRET_NUM_OF_FRETS       20
+/** @def FRET_POSITION_Q
+ * Defines the number of fractional bits of a position, in frets. */
+#define FRET_POSITION_Q         8
+
+void FRET_Init(void);
+void FRET_AddReadings(const UINT16* readings);
+void FRET_Process(void);
+int FRET_GetFret(int string);
+INT32 FRET_GetPosition(int string);
+BOOL FRET_Calibrate(int string, int fret);
+void FRET_ShowStats(int string, BOOL reset);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* FRET_H */
+
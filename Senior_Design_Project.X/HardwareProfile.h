@@ -20,5 +20,14 @@
 /**@def CLEAR_WATCHDOG_TIMER 
  * Clears the watchdog timer. */
 #define CLEAR_WATCHDOG_TIMER    WDTCONbits.WDTCLR = 0x01;
+/**@def SD_CARD_DETECT 
+ * Defines if the SD socket's card detect switch is read on RB8, 0 treats the 
+ * card as always in. Set to 1 once the switch and its level are confirmed on 
+ * the board, a wrong level leaves the card out for good. */
+#define SD_CARD_DETECT          0
+/**@def SD_CARD_DETECT_LEVEL 
+ * Defines the level of RB8 with a card in. The switch is assumed to ground the
+ * pin, set to 1 for a switch that pulls the pin up. */
+#define SD_CARD_DETECT_LEVEL    0
 
 #endif
\ No newline at end of file
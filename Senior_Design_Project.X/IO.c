@@ -5,23 +5,23 @@
  * @details The IO module will handle all IO related tasks. The module will be
  * initialize both the analog and digital IOs for all other modules (e.g. UART). 
  * The process of checking for finger placement for each frets is handled in 
- * this module.
+ * this module, from the position sensors read by the FRET module.
  */
 
 #include <p32xxxx.h>
 #include <stdio.h>
 #include "HardwareProfile.h"
 #include "STDDEF.h"
+#include "ADC.h"
+#include "FRET.h"
 #include "IO.h"
 
-/** @def FRET_GROUP_COUNT 
- * Defines the number of fret groups. */
-#define FRET_GROUP_COUNT    4
-/** @def FRETS_PER_GROUP 
- * Defines the number of frets per group. */
-#define FRETS_PER_GROUP     5
-
-void IO_setGroupOutput(int group);
+/** @var scannedFret 
+ * The fret found by the last fret scan of the main loop. */
+volatile int scannedFret;
+/** @var scannedPosition 
+ * The finger position found by the last fret scan of the main loop. */
+volatile INT32 scannedPosition;
 
 /**
  * @brief Initializes the IO module.
@@ -40,20 +40,6 @@ void IO_Init(void)
     TRISEbits.TRISE3 = 0;   // LED, ERROR
     TRISEbits.TRISE4 = 0;   // LED, INITIALIZATION
     
-    // Fret
-    TRISGbits.TRISG1 = 1;   // Fret 5
-    TRISGbits.TRISG0 = 1;   // Fret 4
-    TRISAbits.TRISA6 = 1;   // Fret 3
-    TRISAbits.TRISA7 = 1;   // Fret 2
-    TRISEbits.TRISE0 = 1;   // Fret 1
-    
-    // Frets Groups
-    TRISEbits.TRISE1 = 0;   // Group 4
-    TRISGbits.TRISG14 = 0;  // Group 3
-//    TRISGbits.TRISG12 = 0;  // Group 2
-    TRISDbits.TRISD4 = 0;   // Group 2
-    TRISGbits.TRISG13 = 0;  // Group 1
-    
     // UART IO
     TRISCbits.TRISC1 = 1;   // U1RX
     TRISEbits.TRISE5 = 0;   // U1TX
@@ -67,13 +53,34 @@ void IO_Init(void)
     // SPI IO, SD Card
     TRISBbits.TRISB11 = 0;  // CS
     TRISBbits.TRISB8 = 1;   // CD
+#if SD_CARD_DETECT && (SD_CARD_DETECT_LEVEL == 0)
+    CNPUBbits.CNPUB8 = 1;   // CD pull-up, the switch grounds CD with a card in
+#elif SD_CARD_DETECT
+    CNPDBbits.CNPDB8 = 1;   // CD pull-down, the switch pulls CD up with a card in
+#endif
     TRISBbits.TRISB9 = 1;   // SD_SDI3
     TRISBbits.TRISB10 = 0;  // SD_SDO3
     TRISFbits.TRISF13 = 0;  // SD_CLK3
     
-    // ADC 
+    // ADC, strumming sensors
     TRISGbits.TRISG15 = 1;   // set RG15 as an input
-    ANSELGbits.ANSG15 = 1;   // set RG15 (AN28) to analog
+    ANSELGbits.ANSG15 = 1;   // set RG15 (AN28) to analog, string 1
+    TRISBbits.TRISB2 = 1;    // set RB2 as an input
+    ANSELBbits.ANSB2 = 1;    // set RB2 (AN2) to analog, string 2
+    TRISBbits.TRISB3 = 1;    // set RB3 as an input
+    ANSELBbits.ANSB3 = 1;    // set RB3 (AN3) to analog, string 3
+    TRISBbits.TRISB4 = 1;    // set RB4 as an input
+    ANSELBbits.ANSB4 = 1;    // set RB4 (AN4) to analog, string 4
+    
+    // ADC, position sensors
+    TRISBbits.TRISB15 = 1;   // set RB15 as an input
+    ANSELBbits.ANSB15 = 1;   // set RB15 (AN15) to analog, string 1
+    TRISBbits.TRISB14 = 1;   // set RB14 as an input
+    ANSELBbits.ANSB14 = 1;   // set RB14 (AN14) to analog, string 2
+    TRISBbits.TRISB13 = 1;   // set RB13 as an input
+    ANSELBbits.ANSB13 = 1;   // set RB13 (AN13) to analog, string 3
+    TRISBbits.TRISB12 = 1;   // set RB12 as an input
+    ANSELBbits.ANSB12 = 1;   // set RB12 (AN12) to analog, string 4
     
     // Clears All Digital IO
     PORTACLR = 0xFFFF; PORTBCLR = 0xFFFF; PORTCCLR = 0xFFFF;
@@ -83,96 +90,57 @@ void IO_Init(void)
     ON_LED = 0;                 // ON LED
     ERROR_LED = 1;              // ERROR LED
     INITIALIZE_LED = 0;         // INITIALIZATION LED
+    
+    scannedFret = 0;
+    scannedPosition = 0;
 }
 
 /**
- * @brief Scans a selection of frets.
- * @details Scans all frets groups to determine which fret was pressed. Sets the
- * currently selected fret to the fret that is pressed. Defaults to an open fret.
+ * @brief Scans the frets from the main loop.
+ * @details The frets of every string are found from the position sensors in 
+ * the main loop, the interrupts use the fret found by the last scan so they 
+ * never interrupt a scan.
  * @return Void
  */
+void IO_Process(void)
+{
+    FRET_Process();
+    scannedFret = FRET_GetFret(ADC_LOCAL_STRING);
+    scannedPosition = FRET_GetPosition(ADC_LOCAL_STRING);
+}
+
+/**
+ * @brief Returns the fret found by the last fret scan.
+ * @return Returns the fret that is pressed.
+ */
+int IO_getFret(void)
+{
+    return scannedFret;
+}
+
+/**
+ * @brief Returns the finger position found by the last fret scan.
+ * @return Returns the position in frets, FRET_POSITION_Q fractional bits, 0 if
+ * the string is open.
+ */
+INT32 IO_getPosition(void)
+{
+    return scannedPosition;
+}
+
+/**
+ * @brief Scans a selection of frets.
+ * @details Returns the fret found by the last fret scan and displays the 
+ * selected fret. Defaults to an open fret.
+ * @return Returns the fret that is pressed.
+ */
 int IO_scanFrets(void)
 {
-    int groupIndex = 0;
-    int fretFound = 0;
-    int currentFret = 0;
-    
-    /* Scans through all the fret groups. */
-    for(groupIndex = 1; groupIndex <= FRET_GROUP_COUNT; groupIndex++)
-    {
-        /* Selects the fret group. */
-        IO_setGroupOutput(groupIndex);
-        
-        /* Scans through the five fret inputs. */
-        if(FRET1 == 1) {fretFound = 1;}
-        else if(FRET2 == 1) {fretFound = 2;}
-        else if(FRET3 == 1) {fretFound = 3;}
-        else if(FRET4 == 1) {fretFound = 4;}
-        else if(FRET5 == 1) {fretFound = 5;}
-        
-        /* Turn off all output pins. */
-        IO_setGroupOutput(0);
-        
-        /* Checks if any frets were pressed. */
-        if(fretFound > 0)
-        {
-            /* Calculates the fret that is selected*/
-            currentFret = (groupIndex-1)*FRETS_PER_GROUP + fretFound;
-            break;
-        }
-    }
+    int currentFret = IO_getFret();
     
     char buf[32];
     snprintf(&buf[0] ,32 ,"Fret Selected: %d", currentFret);
     MON_SendString(&buf[0]);
     
     return currentFret;
-}
-
-/**
- * @brief Sets the fret group to be scan.
- * @arg group The fret group to be scan.
- * @return Void
- */
-void IO_setGroupOutput(int group)
-{
-    switch(group)
-    {
-        case 1:
-            GROUP1_OUT = 1;
-            GROUP2_OUT = 0;
-            GROUP3_OUT = 0;
-            GROUP4_OUT = 0;
-            break;
-        case 2:
-            GROUP1_OUT = 0;
-            GROUP2_OUT = 1;
-            GROUP3_OUT = 0;
-            GROUP4_OUT = 0;
-            break;
-        case 3:
-            GROUP1_OUT = 0;
-            GROUP2_OUT = 0;
-            GROUP3_OUT = 1;
-            GROUP4_OUT = 0;
-            break;
-        case 4:
-            GROUP1_OUT = 0;
-            GROUP2_OUT = 0;
-            GROUP3_OUT = 0;
-            GROUP4_OUT = 1;
-            break;
-        case 5:
-            GROUP1_OUT = 1;
-            GROUP2_OUT = 1;
-            GROUP3_OUT = 1;
-            GROUP4_OUT = 1;
-            break;
-        default:
-            GROUP1_OUT = 0;
-            GROUP2_OUT = 0;
-            GROUP3_OUT = 0;
-            GROUP4_OUT = 0;
-            break;
-    }
 }
\ No newline at end of file
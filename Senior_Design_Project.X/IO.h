@@ -10,37 +10,8 @@
 #ifdef	__cplusplus
 extern "C" {
 #endif
-    
-/* Group Output Pins. */
-/** @def GROUP4_OUT 
- * Defines the output PORT for Group 4 */
-#define GROUP4_OUT  PORTEbits.RE1
-/** @def GROUP3_OUT 
- * Defines the output PORT for Group 3 */
-#define GROUP3_OUT  PORTGbits.RG14   
-/** @def GROUP2_OUT 
- * Defines the output PORT for Group 2 */
-#define GROUP2_OUT  PORTDbits.RD4  
-/** @def GROUP1_OUT 
- * Defines the output PORT for Group 1 */
-#define GROUP1_OUT  PORTGbits.RG13   
-    
-/* Fret Pins */
-/** @def FRET5 
- * Defines the input PORT for Fret 5 */
-#define FRET5       PORTGbits.RG1
-/** @def FRET4 
- * Defines the input PORT for Fret 4 */
-#define FRET4       PORTGbits.RG0
-/** @def FRET3 
- * Defines the input PORT for Fret 3 */
-#define FRET3       PORTAbits.RA6
-/** @def FRET2 
- * Defines the input PORT for Fret 2 */
-#define FRET2       PORTAbits.RA7
-/** @def FRET1 
- * Defines the input PORT for Fret 1 */
-#define FRET1       PORTEbits.RE0
+
+#include "STDDEF.h"
 
 /** @def ON_LED 
  * Defines the LED for ON. */
@@ -54,6 +25,9 @@ extern "C" {
     
 void IO_Init(void);
 int IO_scanFrets(void);
+void IO_Process(void);
+int IO_getFret(void);
+INT32 IO_getPosition(void);
 
 #ifdef	__cplusplus
 }
@@ -0,0 +1,273 @@
+/**
+ * @file JITTER.c
+ * @author Kue Yang
+ * @date 10/19/2026
+ * @details The JITTER module records every DAC frame written by the Timer 3
+ * interrupt into a RAM ring. Each entry holds the core timer count of the 
+ * write, the audio buffer fill level and whether the buffer was empty. The ring
+ * is summarized through the monitor as percentiles of the deviation from the 
+ * Timer 3 period and as bursts of underruns, which tells late interrupts apart
+ * from empty buffers.
+ * @remarks The capture ring is only built if JITTER_CAPTURE is set to 1. The 
+ * underrun totals are kept since the last reset, the rest covers the ring.
+ */
+
+#include <p32xxxx.h>
+#include <stdio.h>
+#include "HardwareProfile.h"
+#include "STDDEF.h"
+#include "TIMER.h"
+#include "UART.h"
+#include "AUDIO.h"
+#include "JITTER.h"
+
+/** @def JITTER_NUM_OF_BINS
+ * Defines the number of histogram bins, bin n counts deviations of n core timer
+ * ticks and the last bin counts every longer deviation. */
+#define JITTER_NUM_OF_BINS      128
+/** @def JITTER_NS_PER_TICK
+ * Defines the length of a core timer tick in ns. */
+#define JITTER_NS_PER_TICK      50
+
+#if JITTER_CAPTURE
+/** @var jitterRing
+ * The capture ring. */
+UINT32 jitterRing[JITTER_SIZE];
+/** @var jitterHead
+ * The index of the next entry to be written. */
+UINT16 jitterHead;
+/** @var jitterFilled
+ * The number of valid entries in the capture ring. */
+UINT16 jitterFilled;
+/** @var jitterPaused
+ * Stores boolean indicating the capture ring is being summarized. */
+volatile BOOL jitterPaused;
+/** @var jitterStart
+ * Stores boolean indicating the next frame is the first after the output starts. */
+BOOL jitterStart;
+/** @var jitterFrames
+ * The number of DAC frames since the last reset. */
+UINT32 jitterFrames;
+/** @var jitterUnderruns
+ * The number of underrun frames since the last reset. */
+UINT32 jitterUnderruns;
+/** @var jitterBursts
+ * The number of underrun bursts since the last reset. */
+UINT32 jitterBursts;
+/** @var jitterLongestBurst
+ * The longest underrun burst since the last reset, in frames. */
+UINT32 jitterLongestBurst;
+/** @var jitterBurst
+ * The length of the current underrun burst, in frames. */
+UINT32 jitterBurst;
+/** @var jitterBins
+ * The histogram of the deviation from the Timer 3 period. */
+UINT16 jitterBins[JITTER_NUM_OF_BINS];
+
+UINT32 JITTER_GetPercentile(UINT32 count, UINT16 permille);
+#endif
+
+/**
+ * @brief Initializes the JITTER module.
+ * @return Void
+ */
+void JITTER_Init(void)
+{
+#if JITTER_CAPTURE
+    jitterPaused = TRUE;
+    jitterHead = 0;
+    jitterFilled = 0;
+    jitterStart = TRUE;
+    jitterFrames = 0;
+    jitterUnderruns = 0;
+    jitterBursts = 0;
+    jitterLongestBurst = 0;
+    jitterBurst = 0;
+    jitterPaused = FALSE;
+#endif
+}
+
+#if JITTER_CAPTURE
+/**
+ * @brief Records a DAC frame.
+ * @details Called from the Timer 3 interrupt for every frame once the note has
+ * been read, including the frames where the audio buffer was empty.
+ * @arg ticks The core timer count before the frame was written.
+ * @arg fill The number of frames in the audio buffer.
+ * @arg isUnderrun Indicates if the audio buffer was empty and nothing was written.
+ * @return Void
+ */
+void JITTER_AddFrame(UINT32 ticks, UINT16 fill, BOOL isUnderrun)
+{
+    UINT32 entry = (ticks & JITTER_TICKS_MASK) | ((UINT32)(fill & JITTER_FILL_MASK) << JITTER_FILL_SHIFT);
+    
+    jitterFrames++;
+    if(isUnderrun)
+    {
+        entry |= JITTER_UNDERRUN_FLAG;
+        jitterUnderruns++;
+        if(jitterBurst++ == 0)
+        {
+            jitterBursts++;
+        }
+        if(jitterBurst > jitterLongestBurst)
+        {
+            jitterLongestBurst = jitterBurst;
+        }
+    }
+    else
+    {
+        jitterBurst = 0;
+    }
+    
+    if(jitterPaused)
+    {
+        return;
+    }
+    if(jitterStart)
+    {
+        entry |= JITTER_START_FLAG;
+        jitterStart = FALSE;
+    }
+    
+    jitterRing[jitterHead] = entry;
+    jitterHead = (jitterHead + 1) & (JITTER_SIZE - 1);
+    if(jitterFilled < JITTER_SIZE)
+    {
+        jitterFilled++;
+    }
+}
+
+/**
+ * @brief Marks the next frame as the first after the output starts.
+ * @details The time the output was off isn't counted as jitter.
+ * @return Void
+ */
+void JITTER_Restart(void)
+{
+    jitterStart = TRUE;
+    jitterBurst = 0;
+}
+
+/**
+ * @brief Returns a percentile of the deviation from the Timer 3 period.
+ * @arg count The number of deviations in the histogram.
+ * @arg permille The percentile in tenths of a percent.
+ * @return Returns the deviation in ns.
+ */
+UINT32 JITTER_GetPercentile(UINT32 count, UINT16 permille)
+{
+    UINT32 target = (count*permille + 999)/1000;
+    UINT32 sum = 0;
+    int i = 0;
+    
+    for(i = 0; i < JITTER_NUM_OF_BINS - 1; i++)
+    {
+        sum += jitterBins[i];
+        if(sum >= target)
+        {
+            break;
+        }
+    }
+    return i*JITTER_NS_PER_TICK;
+}
+#endif
+
+/**
+ * @brief Displays the DAC frame jitter and underruns.
+ * @details Recording into the capture ring is paused while it is summarized.
+ * The jitter is the difference between the time between two frames and the 
+ * Timer 3 period.
+ * @arg reset Clears the capture ring and the underrun totals if set to TRUE.
+ * @return Void
+ */
+void JITTER_ShowStats(BOOL reset)
+{
+#if JITTER_CAPTURE
+    char buf[128];
+    UINT32 period = ((PR3 + 1)*((SYS_FREQ/2)/1000000))/(GetPeripheralClock()/1000000);
+    UINT32 oldest, entry, last = 0, deviation, maxDeviation = 0, count = 0;
+    UINT32 fillSum = 0, minFill = JITTER_FILL_MASK, fill;
+    UINT32 underruns = 0, bursts = 0, burst = 0, longestBurst = 0;
+    int i = 0;
+    
+    jitterPaused = TRUE;
+    for(i = 0; i < JITTER_NUM_OF_BINS; i++)
+    {
+        jitterBins[i] = 0;
+    }
+    
+    oldest = (jitterFilled < JITTER_SIZE) ? 0 : jitterHead;
+    for(i = 0; i < jitterFilled; i++)
+    {
+        entry = jitterRing[(oldest + i) & (JITTER_SIZE - 1)];
+        
+        // The first frame after the output starts has no interval.
+        if(i > 0 && !(entry & JITTER_START_FLAG))
+        {
+            deviation = ((entry - last) & JITTER_TICKS_MASK);
+            deviation = (deviation > period) ? deviation - period : period - deviation;
+            jitterBins[(deviation < JITTER_NUM_OF_BINS) ? deviation : JITTER_NUM_OF_BINS - 1]++;
+            if(deviation > maxDeviation)
+            {
+                maxDeviation = deviation;
+            }
+            count++;
+        }
+        last = entry;
+        
+        fill = (entry >> JITTER_FILL_SHIFT) & JITTER_FILL_MASK;
+        fillSum += fill;
+        if(fill < minFill)
+        {
+            minFill = fill;
+        }
+        
+        if(entry & JITTER_UNDERRUN_FLAG)
+        {
+            underruns++;
+            if(burst++ == 0)
+            {
+                bursts++;
+            }
+            if(burst > longestBurst)
+            {
+                longestBurst = burst;
+            }
+        }
+        else
+        {
+            burst = 0;
+        }
+    }
+    
+    snprintf(&buf[0], 128, "DAC frames: %u, %u in the ring, period %u ns",
+            jitterFrames, jitterFilled, period*JITTER_NS_PER_TICK);
+    MON_SendString(&buf[0]);
+    if(count > 0)
+    {
+        snprintf(&buf[0], 128, "Jitter: p50 %u ns, p90 %u ns, p99 %u ns, p99.9 %u ns, max %u ns",
+                JITTER_GetPercentile(count, 500), JITTER_GetPercentile(count, 900),
+                JITTER_GetPercentile(count, 990), JITTER_GetPercentile(count, 999),
+                maxDeviation*JITTER_NS_PER_TICK);
+        MON_SendString(&buf[0]);
+    }
+    if(jitterFilled > 0)
+    {
+        snprintf(&buf[0], 128, "Fill: min %u, mean %u of %u frames",
+                minFill, fillSum/jitterFilled, AUDIO_BUF_SIZE);
+        MON_SendString(&buf[0]);
+    }
+    snprintf(&buf[0], 128, "Underruns: %u frames in %u bursts, longest %u frames (ring: %u in %u, longest %u)",
+            jitterUnderruns, jitterBursts, jitterLongestBurst, underruns, bursts, longestBurst);
+    MON_SendString(&buf[0]);
+    
+    if(reset == TRUE)
+    {
+        JITTER_Init();
+    }
+    jitterPaused = FALSE;
+#else
+    MON_SendString("The DAC capture ring isn't built, build with -DJITTER_CAPTURE=1.");
+#endif
+}
@@ -0,0 +1,57 @@
+/**
+ * @file JITTER.h
+ * @author Kue Yang
+ * @date 10/19/2026
+ */
+
+#ifndef JITTER_H
+#define	JITTER_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include "STDDEF.h"
+
+/** @def JITTER_CAPTURE
+ * Defines if every DAC frame is recorded in the capture ring. The ring is a 
+ * diagnostic left out of the build by default, build with -DJITTER_CAPTURE=1 
+ * to record the frames. */
+#ifndef JITTER_CAPTURE
+#define JITTER_CAPTURE          0
+#endif
+/** @def JITTER_SIZE
+ * Defines the number of DAC frames held by the capture ring, must be a power of 2. */
+#define JITTER_SIZE             2048
+/** @def JITTER_TICKS_MASK
+ * Defines the bits of a capture entry that store the core timer count. */
+#define JITTER_TICKS_MASK       0x000FFFFF
+/** @def JITTER_FILL_SHIFT
+ * Defines the position of the audio buffer fill level in a capture entry. */
+#define JITTER_FILL_SHIFT       20
+/** @def JITTER_FILL_MASK
+ * Defines the size of the audio buffer fill level in a capture entry. */
+#define JITTER_FILL_MASK        0x03FF
+/** @def JITTER_START_FLAG
+ * Defines the bit of a capture entry set on the first frame after the output starts. */
+#define JITTER_START_FLAG       0x40000000
+/** @def JITTER_UNDERRUN_FLAG
+ * Defines the bit of a capture entry set when the audio buffer was empty. */
+#define JITTER_UNDERRUN_FLAG    0x80000000
+
+void JITTER_Init(void);
+void JITTER_ShowStats(BOOL reset);
+#if JITTER_CAPTURE
+void JITTER_AddFrame(UINT32 ticks, UINT16 fill, BOOL isUnderrun);
+void JITTER_Restart(void);
+#else
+#define JITTER_AddFrame(ticks, fill, isUnderrun)
+#define JITTER_Restart()
+#endif
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* JITTER_H */
+
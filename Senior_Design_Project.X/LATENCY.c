@@ -0,0 +1,192 @@
+/**
+ * @file LATENCY.c
+ * @author Kue Yang
+ * @date 10/19/2026
+ * @details The LATENCY module measures the strum to sound latency. Core timer
+ * timestamps are recorded when the strumming sensor crosses the strum threshold,
+ * when the strum is handled, when the new tone is set, when the first block of
+ * the tone is read and when its first non-zero sample is written to the DAC.
+ * The time between each stage and the total latency are collected into
+ * histograms that are displayed through the monitor.
+ * @remarks Stages are only recorded in order, so playback that was not started
+ * by a strum is ignored.
+ */
+
+#include <p32xxxx.h>
+#include <stdio.h>
+#include "STDDEF.h"
+#include "TIMER.h"
+#include "UART.h"
+#include "LATENCY.h"
+
+/** @def LATENCY_TOTAL
+ * Defines the statistics row used for the total latency. */
+#define LATENCY_TOTAL           0
+
+/**
+ * @brief LATENCY_STATS data structure.
+ * @details The LATENCY_STATS data structure stores the latency statistics of
+ * one stage.
+ */
+typedef struct LATENCY_STATS
+{
+    /**@{*/
+    UINT32 count;                           /**< Variable used to store the number of measurements. */
+    UINT32 sum;                             /**< Variable used to store the sum of the latencies in us. */
+    UINT32 min;                             /**< Variable used to store the minimum latency in us. */
+    UINT32 max;                             /**< Variable used to store the maximum latency in us. */
+    UINT16 bins[LATENCY_NUM_OF_BINS];       /**< Variable used to store the latency histogram. */
+    /**@}*/
+}LATENCY_STATS;
+
+/** @var latencyNames
+ * The names of the statistics rows. */
+const char* latencyNames[LATENCY_NUM_OF_STAGES] = {
+    "Onset to DAC", "Onset to decision", "Decision to tone",
+    "Tone to SD block", "SD block to DAC"
+};
+/** @var latencyTicks
+ * The timestamps of each stage of the current strum. */
+volatile UINT32 latencyTicks[LATENCY_NUM_OF_STAGES];
+/** @var latencyStage
+ * The next stage to be recorded, LATENCY_NUM_OF_STAGES if none is pending. */
+volatile UINT8 latencyStage;
+/** @var latencyStats
+ * The latency statistics, the total followed by the time between each stage. */
+LATENCY_STATS latencyStats[LATENCY_NUM_OF_STAGES];
+
+void LATENCY_AddSample(LATENCY_STATS* stats, UINT32 ticks);
+
+/**
+ * @brief Initializes the LATENCY module.
+ * @details Clears all the latency statistics.
+ * @return Void
+ */
+void LATENCY_Init(void)
+{
+    int i = 0, j = 0;
+
+    latencyStage = LATENCY_NUM_OF_STAGES;
+    for(i = 0; i < LATENCY_NUM_OF_STAGES; i++)
+    {
+        latencyStats[i].count = 0;
+        latencyStats[i].sum = 0;
+        latencyStats[i].min = 0xFFFFFFFF;
+        latencyStats[i].max = 0;
+        for(j = 0; j < LATENCY_NUM_OF_BINS; j++)
+        {
+            latencyStats[i].bins[j] = 0;
+        }
+    }
+}
+
+/**
+ * @brief Starts measuring the latency of a new strum.
+ * @details A strum that arrives before the previous strum reached the DAC
+ * replaces it.
+ * @arg onsetTicks The core timer count when the strum threshold was crossed.
+ * @return Void
+ */
+void LATENCY_Start(UINT32 onsetTicks)
+{
+    latencyTicks[LATENCY_ONSET] = onsetTicks;
+    latencyStage = LATENCY_DECISION;
+}
+
+/**
+ * @brief Records the timestamp of a stage.
+ * @details The stage is only recorded if it is the next stage of the current
+ * strum. The statistics are updated once the last stage is recorded.
+ * @arg stage The stage that has been reached.
+ * @return Void
+ */
+void LATENCY_Mark(UINT8 stage)
+{
+    int i = 0;
+
+    if(stage != latencyStage)
+    {
+        return;
+    }
+
+    latencyTicks[stage] = TIMER_GetCoreTicks();
+    latencyStage++;
+
+    if(latencyStage == LATENCY_NUM_OF_STAGES)
+    {
+        LATENCY_AddSample(&latencyStats[LATENCY_TOTAL],
+                latencyTicks[LATENCY_DAC] - latencyTicks[LATENCY_ONSET]);
+        for(i = 1; i < LATENCY_NUM_OF_STAGES; i++)
+        {
+            LATENCY_AddSample(&latencyStats[i], latencyTicks[i] - latencyTicks[i-1]);
+        }
+    }
+}
+
+/**
+ * @brief Adds a latency to the statistics.
+ * @arg stats The statistics to update.
+ * @arg ticks The latency in core timer ticks.
+ * @return Void
+ */
+void LATENCY_AddSample(LATENCY_STATS* stats, UINT32 ticks)
+{
+    UINT32 us = ticks/TIMER_TICKS_PER_US;
+    UINT32 bin = 0;
+
+    stats->count++;
+    stats->sum += us;
+    if(us < stats->min)
+    {
+        stats->min = us;
+    }
+    if(us > stats->max)
+    {
+        stats->max = us;
+    }
+
+    // Finds the power of two bin, the last bin holds everything larger.
+    while((us >> (bin + 1)) != 0 && bin < (LATENCY_NUM_OF_BINS - 1))
+    {
+        bin++;
+    }
+    stats->bins[bin]++;
+}
+
+/**
+ * @brief Displays the latency statistics.
+ * @details Displays the count, minimum, mean and maximum latency of each stage
+ * followed by the non-empty histogram bins as lowerBound:count.
+ * @return Void
+ */
+void LATENCY_ShowStats(void)
+{
+    char buf[128];
+    int i = 0, j = 0, length = 0;
+
+    for(i = 0; i < LATENCY_NUM_OF_STAGES; i++)
+    {
+        if(latencyStats[i].count == 0)
+        {
+            snprintf(&buf[0], 128, "%s: no strums", latencyNames[i]);
+            MON_SendString(&buf[0]);
+            continue;
+        }
+
+        snprintf(&buf[0], 128, "%s: n %u, min %u us, mean %u us, max %u us",
+                latencyNames[i], latencyStats[i].count, latencyStats[i].min,
+                latencyStats[i].sum/latencyStats[i].count, latencyStats[i].max);
+        MON_SendString(&buf[0]);
+
+        length = 0;
+        for(j = 0; j < LATENCY_NUM_OF_BINS && length < 128; j++)
+        {
+            if(latencyStats[i].bins[j] > 0)
+            {
+                length += snprintf(&buf[length], 128 - length, " %u:%u",
+                        (j == 0) ? 0 : (1 << j), latencyStats[i].bins[j]);
+            }
+        }
+        MON_SendString(&buf[0]);
+    }
+}
@@ -0,0 +1,48 @@
+/**
+ * @file LATENCY.h
+ * @author Kue Yang
+ * @date 10/19/2026
+ */
+
+#ifndef LATENCY_H
+#define	LATENCY_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include "STDDEF.h"
+
+/** @def LATENCY_ONSET
+ * Defines the stage where the strumming sensor crossed the strum threshold. */
+#define LATENCY_ONSET           0
+/** @def LATENCY_DECISION
+ * Defines the stage where the ADC interrupt handles the strum. */
+#define LATENCY_DECISION        1
+/** @def LATENCY_TONE
+ * Defines the stage where the new tone has been set. */
+#define LATENCY_TONE            2
+/** @def LATENCY_SD_BLOCK
+ * Defines the stage where the first block of the new tone is read. */
+#define LATENCY_SD_BLOCK        3
+/** @def LATENCY_DAC
+ * Defines the stage where the first non-zero sample is written to the DAC. */
+#define LATENCY_DAC             4
+/** @def LATENCY_NUM_OF_STAGES
+ * Defines the number of latency stages. */
+#define LATENCY_NUM_OF_STAGES   5
+/** @def LATENCY_NUM_OF_BINS
+ * Defines the number of histogram bins, bin n counts latencies of 2^n us. */
+#define LATENCY_NUM_OF_BINS     16
+
+void LATENCY_Init(void);
+void LATENCY_Start(UINT32 onsetTicks);
+void LATENCY_Mark(UINT8 stage);
+void LATENCY_ShowStats(void);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* LATENCY_H */
+
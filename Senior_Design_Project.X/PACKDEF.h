@@ -0,0 +1,87 @@
+/**
+ * @file PACKDEF.h
+ * @author Kue Yang
+ * @date 10/19/2026
+ * @details Defines the layout of the sample pack. The pack is a single file
+ * that starts with a header followed by a table of note entries. The audio data
+ * of each note starts on a sector boundary so whole sectors can be read from
+ * the card without going through the file system. All values are little endian.
+ */
+
+#ifndef PACKDEF_H
+#define	PACKDEF_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+/** @def PACK_SECTOR_SIZE
+ * Defines the size of a sector, every note starts on a sector boundary. */
+#define PACK_SECTOR_SIZE        512
+/** @def PACK_MAGIC
+ * Defines the index of the pack ID, "SPAK". */
+#define PACK_MAGIC              0
+/** @def PACK_VERSION
+ * Defines the index of the pack version. */
+#define PACK_VERSION            4
+/** @def PACK_NUM_OF_NOTES
+ * Defines the index of the number of notes in the pack. */
+#define PACK_NUM_OF_NOTES       6
+/** @def PACK_HEADER_SIZE
+ * Defines the size of the pack header, the note table follows it. */
+#define PACK_HEADER_SIZE        8
+/** @def PACK_VERSION_1
+ * Defines the pack version supported. */
+#define PACK_VERSION_1          1
+
+/** @def PACK_ENTRY_SIZE
+ * Defines the size of a note table entry. */
+#define PACK_ENTRY_SIZE         32
+/** @def PACK_NOTE_ID
+ * Defines the index of the note ID within an entry. */
+#define PACK_NOTE_ID            0
+/** @def PACK_NOTE_CHANNELS
+ * Defines the index of the number of channels within an entry. */
+#define PACK_NOTE_CHANNELS      2
+/** @def PACK_NOTE_BITS
+ * Defines the index of the bits per sample within an entry. */
+#define PACK_NOTE_BITS          3
+/** @def PACK_NOTE_SAMPLE_RATE
+ * Defines the index of the sample rate within an entry. */
+#define PACK_NOTE_SAMPLE_RATE   4
+/** @def PACK_NOTE_BLOCK_ALIGN
+ * Defines the index of the block align within an entry. */
+#define PACK_NOTE_BLOCK_ALIGN   8
+/** @def PACK_NOTE_OFFSET
+ * Defines the index of the offset of the audio data from the start of the pack. */
+#define PACK_NOTE_OFFSET        12
+/** @def PACK_NOTE_LENGTH
+ * Defines the index of the size of the audio data within an entry. */
+#define PACK_NOTE_LENGTH        16
+/** @def PACK_NOTE_LOOP_START
+ * Defines the index of the first sample frame of the sustain loop. */
+#define PACK_NOTE_LOOP_START    20
+/** @def PACK_NOTE_LOOP_LENGTH
+ * Defines the index of the sample frames in the sustain loop, 0 if none. */
+#define PACK_NOTE_LOOP_LENGTH   24
+/** @def PACK_NOTE_START
+ * Defines the index of the first sample frame played, the silence before the 
+ * pluck is skipped. 0 if the note isn't trimmed. */
+#define PACK_NOTE_START         28
+
+/** @def PACK_MAKE_NOTE_ID
+ * Defines the note ID of a string and fret. */
+#define PACK_MAKE_NOTE_ID(string, fret)     ((UINT16)(((string) << 8) | (fret)))
+/** @def PACK_NOTE_STRING
+ * Defines the string of a note ID. */
+#define PACK_NOTE_STRING(noteId)            ((noteId) >> 8)
+/** @def PACK_NOTE_FRET
+ * Defines the fret of a note ID. */
+#define PACK_NOTE_FRET(noteId)              ((noteId) & 0xFF)
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* PACKDEF_H */
+
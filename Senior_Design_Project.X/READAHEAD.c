@@ -0,0 +1,221 @@
+/**
+ * @file READAHEAD.c
+ * @author Kue Yang
+ * @date 10/19/2026
+ * @details The READAHEAD module sizes how far the audio is decoded ahead of the
+ * DAC. The time of every card read made by the refill is collected into a
+ * histogram that forgets older reads, and the read-ahead depth is set in
+ * sectors to cover the read time that all but READAHEAD_UNDERRUN_PERMILLE of
+ * the reads stay under. A fast card keeps the audio buffers shallow, a slow
+ * card fills them deeper. The depth and the read time percentiles are
+ * displayed through the monitor.
+ * @remarks The audio buffers are allocated for READAHEAD_MAX_SECTORS, the
+ * deepest read-ahead asked for is displayed so AUDIO_BUF_SIZE can be sized to
+ * the card.
+ */
+
+#include <p32xxxx.h>
+#include <stdio.h>
+#include "STDDEF.h"
+#include "TIMER.h"
+#include "UART.h"
+#include "READAHEAD.h"
+
+/** @def READAHEAD_BIN_US
+ * Defines the width of a histogram bin in us. */
+#define READAHEAD_BIN_US            128
+/** @def READAHEAD_SLACK_US
+ * Defines the time the refill may wait for the main loop once the read-ahead
+ * runs low, the deadline of the refill task. */
+#define READAHEAD_SLACK_US          2000
+/** @def READAHEAD_MIN_READS
+ * Defines the number of reads made before the depth is tuned, the read-ahead
+ * is kept at its deepest until then. */
+#define READAHEAD_MIN_READS         64
+/** @def READAHEAD_WINDOW
+ * Defines the number of reads in the histogram before the counts are halved. */
+#define READAHEAD_WINDOW            1024
+/** @def READAHEAD_UPDATE_MASK
+ * Defines the reads between two updates of the depth less one, must be a power
+ * of 2 less one. */
+#define READAHEAD_UPDATE_MASK       15
+
+/** @var aheadBins
+ * The histogram of the card read times. */
+UINT16 aheadBins[READAHEAD_NUM_OF_BINS];
+/** @var aheadCount
+ * The number of reads counted in the histogram. */
+UINT32 aheadCount;
+/** @var aheadReads
+ * The number of reads since the last reset. */
+UINT32 aheadReads;
+/** @var aheadMaxTicks
+ * The longest read since the last reset in core timer ticks. */
+UINT32 aheadMaxTicks;
+/** @var aheadSectors
+ * The read-ahead depth in sectors. */
+UINT8 aheadSectors;
+/** @var aheadPeakSectors
+ * The deepest read-ahead asked for since the last reset, in sectors. */
+UINT8 aheadPeakSectors;
+/** @var aheadLimited
+ * The number of updates that asked for more than READAHEAD_MAX_SECTORS. */
+UINT32 aheadLimited;
+
+void READAHEAD_Update(UINT16 sampleRate);
+UINT32 READAHEAD_GetPercentile(UINT16 permille);
+
+/**
+ * @brief Initializes the READAHEAD module.
+ * @details The read-ahead starts at its deepest until the card has been timed.
+ * @return Void
+ */
+void READAHEAD_Init(void)
+{
+    int i = 0;
+    
+    for(i = 0; i < READAHEAD_NUM_OF_BINS; i++)
+    {
+        aheadBins[i] = 0;
+    }
+    aheadCount = 0;
+    aheadReads = 0;
+    aheadMaxTicks = 0;
+    aheadSectors = READAHEAD_MAX_SECTORS;
+    aheadPeakSectors = 0;
+    aheadLimited = 0;
+}
+
+/**
+ * @brief Records the time of a card read.
+ * @details Called by the refill for every read that reached the card. The
+ * counts are halved every READAHEAD_WINDOW reads so the depth follows the card.
+ * @arg ticks The core timer ticks the read took.
+ * @arg sampleRate The sample rate of the note being played.
+ * @return Void
+ */
+void READAHEAD_AddRead(UINT32 ticks, UINT16 sampleRate)
+{
+    UINT32 bin = (ticks/TIMER_TICKS_PER_US)/READAHEAD_BIN_US;
+    int i = 0;
+    
+    aheadBins[(bin < READAHEAD_NUM_OF_BINS) ? bin : READAHEAD_NUM_OF_BINS - 1]++;
+    aheadCount++;
+    aheadReads++;
+    if(ticks > aheadMaxTicks)
+    {
+        aheadMaxTicks = ticks;
+    }
+    
+    if(aheadCount >= READAHEAD_WINDOW)
+    {
+        aheadCount = 0;
+        for(i = 0; i < READAHEAD_NUM_OF_BINS; i++)
+        {
+            aheadBins[i] >>= 1;
+            aheadCount += aheadBins[i];
+        }
+    }
+    
+    if((aheadReads & READAHEAD_UPDATE_MASK) == 0)
+    {
+        READAHEAD_Update(sampleRate);
+    }
+}
+
+/**
+ * @brief Updates the read-ahead depth.
+ * @details The depth covers the read time percentile set by the underrun bound
+ * and the time the refill may wait, in frames at the sample rate, rounded up to
+ * whole sectors.
+ * @arg sampleRate The sample rate of the note being played.
+ * @return Void
+ */
+void READAHEAD_Update(UINT16 sampleRate)
+{
+    UINT32 us = 0, frames = 0, sectors = 0;
+    
+    if(aheadReads < READAHEAD_MIN_READS)
+    {
+        return;
+    }
+    
+    us = READAHEAD_GetPercentile(1000 - READAHEAD_UNDERRUN_PERMILLE) + READAHEAD_SLACK_US;
+    frames = (us*sampleRate)/1000000;
+    sectors = (frames + READAHEAD_SECTOR_FRAMES - 1)/READAHEAD_SECTOR_FRAMES;
+    if(sectors < 1)
+    {
+        sectors = 1;
+    }
+    
+    if(sectors > aheadPeakSectors)
+    {
+        aheadPeakSectors = sectors;
+    }
+    if(sectors > READAHEAD_MAX_SECTORS)
+    {
+        aheadLimited++;
+        sectors = READAHEAD_MAX_SECTORS;
+    }
+    aheadSectors = sectors;
+}
+
+/**
+ * @brief Returns the read-ahead depth.
+ * @return Returns the number of frames the audio buffers are filled to.
+ */
+UINT16 READAHEAD_GetFrames(void)
+{
+    return aheadSectors*READAHEAD_SECTOR_FRAMES;
+}
+
+/**
+ * @brief Returns a percentile of the card read time.
+ * @arg permille The percentile in tenths of a percent.
+ * @return Returns the upper bound of the bin holding the percentile in us, or
+ * the longest read if shorter.
+ */
+UINT32 READAHEAD_GetPercentile(UINT16 permille)
+{
+    UINT32 target = (aheadCount*permille + 999)/1000;
+    UINT32 sum = 0, maxUs = aheadMaxTicks/TIMER_TICKS_PER_US;
+    int i = 0;
+    
+    for(i = 0; i < READAHEAD_NUM_OF_BINS - 1; i++)
+    {
+        sum += aheadBins[i];
+        if(sum >= target)
+        {
+            break;
+        }
+    }
+    return (((i + 1)*READAHEAD_BIN_US) < maxUs) ? ((i + 1)*READAHEAD_BIN_US) : maxUs;
+}
+
+/**
+ * @brief Displays the read-ahead depth and the card read times.
+ * @arg reset Clears the statistics and restarts the tuning if set to TRUE.
+ * @return Void
+ */
+void READAHEAD_ShowStats(BOOL reset)
+{
+    char buf[112];
+    
+    snprintf(&buf[0], 112, "Read-ahead: %u sectors (%u frames) of %u, peak %u, limited %u times, bound %u permille",
+            aheadSectors, READAHEAD_GetFrames(), READAHEAD_MAX_SECTORS, aheadPeakSectors, aheadLimited,
+            READAHEAD_UNDERRUN_PERMILLE);
+    MON_SendString(&buf[0]);
+    if(aheadCount > 0)
+    {
+        snprintf(&buf[0], 112, "SD reads: %u, p50 %u us, p90 %u us, p99 %u us, p99.9 %u us, max %u us",
+                aheadReads, READAHEAD_GetPercentile(500), READAHEAD_GetPercentile(900),
+                READAHEAD_GetPercentile(990), READAHEAD_GetPercentile(999),
+                aheadMaxTicks/TIMER_TICKS_PER_US);
+        MON_SendString(&buf[0]);
+    }
+    
+    if(reset == TRUE)
+    {
+        READAHEAD_Init();
+    }
+}
@@ -0,0 +1,43 @@
+/**
+ * @file READAHEAD.h
+ * @author Kue Yang
+ * @date 10/19/2026
+ */
+
+#ifndef READAHEAD_H
+#define	READAHEAD_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include "STDDEF.h"
+#include "AUDIO.h"
+
+/** @def READAHEAD_UNDERRUN_PERMILLE
+ * Defines the bound on the share of card reads, in tenths of a percent, that
+ * may take longer than the audio read ahead of the DAC lasts. */
+#define READAHEAD_UNDERRUN_PERMILLE 1
+/** @def READAHEAD_SECTOR_FRAMES
+ * Defines the number of frames decoded from a sector at the root pitch. */
+#define READAHEAD_SECTOR_FRAMES     (REC_BUF_SIZE/4)
+/** @def READAHEAD_MAX_SECTORS
+ * Defines the deepest read-ahead in sectors. The audio buffers keep room for a
+ * rendered block above the depth. */
+#define READAHEAD_MAX_SECTORS       ((AUDIO_BUF_SIZE - AUDIO_BLOCK_FRAMES)/READAHEAD_SECTOR_FRAMES)
+/** @def READAHEAD_NUM_OF_BINS
+ * Defines the number of histogram bins, bin n counts reads of n bin widths and
+ * the last bin counts every longer read. */
+#define READAHEAD_NUM_OF_BINS       64
+
+void READAHEAD_Init(void);
+void READAHEAD_AddRead(UINT32 ticks, UINT16 sampleRate);
+UINT16 READAHEAD_GetFrames(void);
+void READAHEAD_ShowStats(BOOL reset);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* READAHEAD_H */
+
@@ -0,0 +1,210 @@
+/**
+ * @file RESAMPLE.c
+ * @author Kue Yang
+ * @date 10/19/2026
+ * @details The RESAMPLE module changes the pitch of a recorded note. A phase
+ * accumulator steps through the source samples at the pitch ratio and each
+ * output sample is interpolated between the neighbouring source samples using
+ * linear or cubic (Catmull-Rom) interpolation. Source samples are pushed one at
+ * a time so the resampler can run on the blocks read from the SD card. The step
+ * can glide to a new pitch while the note plays, so the pitch bends smoothly.
+ * @remarks The module does not access any hardware registers so it can be built
+ * and benchmarked on a host.
+ */
+
+#include "STDDEF.h"
+#include "RESAMPLE.h"
+
+/** @def RESAMPLE_CUBIC_Q
+ * Defines the fractional bits of the cubic interpolation position. The products
+ * of the cubic terms stay within 32 bits at this precision. */
+#define RESAMPLE_CUBIC_Q        10
+
+/** @var resampleSteps
+ * The step of each pitch shift from -12 to +12 semitones, 2^(n/12) in Q16. */
+const UINT32 resampleSteps[2*RESAMPLE_MAX_SEMITONES + 1] = {
+    32768, 34716, 36781, 38968, 41285, 43740, 46341, 49097, 52016, 55109, 58386, 61858,
+    65536,
+    69433, 73562, 77936, 82570, 87480, 92682, 98193, 104032, 110218, 116772, 123715, 131072
+};
+
+INT16 RESAMPLE_Interpolate(RESAMPLE* resample);
+
+/**
+ * @brief Initializes a resampler.
+ * @details Clears the history so the note starts from silence.
+ * @arg resample The resampler to initialize.
+ * @arg step The source samples per output sample, RESAMPLE_Q fractional bits.
+ * @arg mode The interpolation mode, RESAMPLE_LINEAR or RESAMPLE_CUBIC.
+ * @return Void
+ */
+void RESAMPLE_Init(RESAMPLE* resample, UINT32 step, UINT8 mode)
+{
+    resample->phase = 0;
+    resample->step = step;
+    resample->targetStep = step;
+    resample->history[0] = 0;
+    resample->history[1] = 0;
+    resample->history[2] = 0;
+    resample->history[3] = 0;
+    resample->mode = mode;
+}
+
+/**
+ * @brief Sets the step of a resampler without restarting it.
+ * @arg resample The resampler.
+ * @arg step The source samples per output sample, RESAMPLE_Q fractional bits.
+ * @return Void
+ */
+void RESAMPLE_SetStep(RESAMPLE* resample, UINT32 step)
+{
+    resample->step = step;
+    resample->targetStep = step;
+}
+
+/**
+ * @brief Glides the step of a resampler to a new step.
+ * @details The step moves toward the new step by 1/2^RESAMPLE_GLIDE_SHIFT of the
+ * difference every source sample, so the pitch bends without a click.
+ * @arg resample The resampler.
+ * @arg step The new source samples per output sample, RESAMPLE_Q fractional bits.
+ * @return Void
+ */
+void RESAMPLE_GlideTo(RESAMPLE* resample, UINT32 step)
+{
+    resample->targetStep = step;
+}
+
+/**
+ * @brief Returns the step used to shift the pitch by a number of semitones.
+ * @arg semitones The pitch shift, limited to +/-RESAMPLE_MAX_SEMITONES.
+ * @return Returns the step, RESAMPLE_Q fractional bits.
+ */
+UINT32 RESAMPLE_GetSemitoneStep(int semitones)
+{
+    if(semitones > RESAMPLE_MAX_SEMITONES)
+    {
+        semitones = RESAMPLE_MAX_SEMITONES;
+    }
+    else if(semitones < -RESAMPLE_MAX_SEMITONES)
+    {
+        semitones = -RESAMPLE_MAX_SEMITONES;
+    }
+    return resampleSteps[semitones + RESAMPLE_MAX_SEMITONES];
+}
+
+/**
+ * @brief Returns the step used to bend the pitch by a fraction of a semitone.
+ * @details The step is interpolated between the steps of the two semitones 
+ * around the bend, which stays within a cent of the exact pitch.
+ * @arg bend The pitch shift in semitones, RESAMPLE_BEND_Q fractional bits, 
+ * limited to +/-RESAMPLE_MAX_SEMITONES.
+ * @return Returns the step, RESAMPLE_Q fractional bits.
+ */
+UINT32 RESAMPLE_GetBendStep(INT32 bend)
+{
+    INT32 semitones = bend >> RESAMPLE_BEND_Q;
+    UINT32 fraction = bend & ((1 << RESAMPLE_BEND_Q) - 1);
+    UINT32 low = 0, high = 0;
+    
+    if(semitones >= RESAMPLE_MAX_SEMITONES)
+    {
+        return RESAMPLE_GetSemitoneStep(RESAMPLE_MAX_SEMITONES);
+    }
+    else if(semitones < -RESAMPLE_MAX_SEMITONES)
+    {
+        return RESAMPLE_GetSemitoneStep(-RESAMPLE_MAX_SEMITONES);
+    }
+    
+    low = resampleSteps[semitones + RESAMPLE_MAX_SEMITONES];
+    high = resampleSteps[semitones + RESAMPLE_MAX_SEMITONES + 1];
+    return low + (((high - low)*fraction) >> RESAMPLE_BEND_Q);
+}
+
+/**
+ * @brief Pushes a source sample through the resampler.
+ * @details Produces every output sample that falls before the new source
+ * sample. A step below RESAMPLE_ONE produces more output than source samples.
+ * @arg resample The resampler.
+ * @arg sample The source sample.
+ * @arg out The buffer used to store the output samples.
+ * @arg maxOut The size of the output buffer.
+ * @return Returns the number of output samples produced.
+ */
+UINT16 RESAMPLE_Process(RESAMPLE* resample, INT16 sample, INT16* out, UINT16 maxOut)
+{
+    UINT16 count = 0;
+    INT32 glide;
+
+    // Glides the step, finishing once the difference is too small to move it.
+    if(resample->step != resample->targetStep)
+    {
+        glide = ((INT32)(resample->targetStep - resample->step)) >> RESAMPLE_GLIDE_SHIFT;
+        if(glide == 0 || glide == -1)
+        {
+            resample->step = resample->targetStep;
+        }
+        else
+        {
+            resample->step += glide;
+        }
+    }
+
+    resample->history[0] = resample->history[1];
+    resample->history[1] = resample->history[2];
+    resample->history[2] = resample->history[3];
+    resample->history[3] = sample;
+
+    while(resample->phase < RESAMPLE_ONE)
+    {
+        if(count >= maxOut)
+        {
+            // Drops the output that doesn't fit.
+            resample->phase = RESAMPLE_ONE;
+            break;
+        }
+        out[count++] = RESAMPLE_Interpolate(resample);
+        resample->phase += resample->step;
+    }
+    resample->phase -= RESAMPLE_ONE;
+
+    return count;
+}
+
+/**
+ * @brief Interpolates between the two middle history samples.
+ * @arg resample The resampler.
+ * @return Returns the sample at the current phase.
+ */
+INT16 RESAMPLE_Interpolate(RESAMPLE* resample)
+{
+    INT32 p0 = resample->history[0];
+    INT32 p1 = resample->history[1];
+    INT32 p2 = resample->history[2];
+    INT32 p3 = resample->history[3];
+    INT32 t, y;
+
+    if(resample->mode == RESAMPLE_LINEAR)
+    {
+        t = resample->phase >> (RESAMPLE_Q - 15);
+        return (INT16)(p1 + (((p2 - p1)*t) >> 15));
+    }
+
+    // Catmull-Rom: y = p1 + t*(c + t*(b + t*a))/2
+    t = resample->phase >> (RESAMPLE_Q - RESAMPLE_CUBIC_Q);
+    y = ((3*(p1 - p2) + p3 - p0)*t) >> RESAMPLE_CUBIC_Q;
+    y = ((y + 2*p0 - 5*p1 + 4*p2 - p3)*t) >> RESAMPLE_CUBIC_Q;
+    y = ((y + p2 - p0)*t) >> RESAMPLE_CUBIC_Q;
+    y = p1 + (y >> 1);
+
+    // The cubic can overshoot the source samples.
+    if(y > 32767)
+    {
+        y = 32767;
+    }
+    else if(y < -32768)
+    {
+        y = -32768;
+    }
+    return (INT16)y;
+}
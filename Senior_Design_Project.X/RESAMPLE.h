@@ -0,0 +1,67 @@
+/**
+ * @file RESAMPLE.h
+ * @author Kue Yang
+ * @date 10/19/2026
+ */
+
+#ifndef RESAMPLE_H
+#define	RESAMPLE_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include "STDDEF.h"
+
+/** @def RESAMPLE_Q
+ * Defines the number of fractional bits of the phase and step. */
+#define RESAMPLE_Q              16
+/** @def RESAMPLE_ONE
+ * Defines a step of one source sample per output sample. */
+#define RESAMPLE_ONE            (1UL << RESAMPLE_Q)
+/** @def RESAMPLE_MAX_SEMITONES
+ * Defines the largest pitch shift, in semitones, in either direction. */
+#define RESAMPLE_MAX_SEMITONES  12
+/** @def RESAMPLE_GLIDE_SHIFT
+ * Defines the time constant of a step change, 2^8 source samples. */
+#define RESAMPLE_GLIDE_SHIFT    8
+/** @def RESAMPLE_BEND_Q
+ * Defines the number of fractional bits of a bend in semitones. */
+#define RESAMPLE_BEND_Q         8
+/** @def RESAMPLE_LINEAR
+ * Defines the linear interpolation mode. */
+#define RESAMPLE_LINEAR         0
+/** @def RESAMPLE_CUBIC
+ * Defines the cubic (Catmull-Rom) interpolation mode. */
+#define RESAMPLE_CUBIC          1
+
+/**
+ * @brief RESAMPLE data structure.
+ * @details The RESAMPLE data structure stores the state of one resampled
+ * channel. The phase is the position of the next output sample between the two
+ * middle history samples.
+ */
+typedef struct RESAMPLE
+{
+    /**@{*/
+    UINT32  phase;              /**< Variable used to store the output phase, RESAMPLE_Q fractional bits. */
+    UINT32  step;               /**< Variable used to store the source samples per output sample. */
+    UINT32  targetStep;         /**< Variable used to store the step the resampler glides to. */
+    INT16   history[4];         /**< Variable used to store the last four source samples, oldest first. */
+    UINT8   mode;               /**< Variable used to store the interpolation mode. */
+    /**@}*/
+}RESAMPLE;
+
+void RESAMPLE_Init(RESAMPLE* resample, UINT32 step, UINT8 mode);
+void RESAMPLE_SetStep(RESAMPLE* resample, UINT32 step);
+void RESAMPLE_GlideTo(RESAMPLE* resample, UINT32 step);
+UINT32 RESAMPLE_GetSemitoneStep(int semitones);
+UINT32 RESAMPLE_GetBendStep(INT32 bend);
+UINT16 RESAMPLE_Process(RESAMPLE* resample, INT16 sample, INT16* out, UINT16 maxOut);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* RESAMPLE_H */
+
@@ -0,0 +1,281 @@
+/**
+ * @file SCHED.c
+ * @author Kue Yang
+ * @date 10/19/2026
+ * @details The SCHED module runs the work of the main loop as registered tasks.
+ * Each pass of the main loop runs the due task with the highest priority, tasks
+ * of the same priority run in the order they became due. Every run is timed
+ * with the core timer and counted as a deadline miss when the task waited
+ * longer than its deadline. The statistics are displayed through the monitor,
+ * once or every second by the telemetry task.
+ * @remarks The tasks are never preempted by each other, a task should return
+ * after a bounded amount of work.
+ */
+
+#include <p32xxxx.h>
+#include <stdio.h>
+#include "HardwareProfile.h"
+#include "STDDEF.h"
+#include "TIMER.h"
+#include "UART.h"
+#include "SCHED.h"
+
+/** @var tasks
+ * The registered tasks. */
+SCHED_TASK tasks[SCHED_MAX_TASKS];
+/** @var numOfTasks
+ * The number of registered tasks. */
+UINT8 numOfTasks;
+/** @var isTelemetry
+ * Stores boolean indicating the statistics are sent by the telemetry task. */
+BOOL isTelemetry;
+
+void SCHED_UpdateDue(SCHED_TASK* task, UINT32 now);
+UINT8 SCHED_GetPriority(SCHED_TASK* task);
+void SCHED_RunTask(SCHED_TASK* task);
+void SCHED_ClearStats(void);
+
+/**
+ * @brief Initializes the SCHED module.
+ * @return Void
+ */
+void SCHED_Init(void)
+{
+    numOfTasks = 0;
+    isTelemetry = FALSE;
+}
+
+/**
+ * @brief Registers a task.
+ * @details The first run of a periodic task is due one period after it is
+ * registered.
+ * @arg name The name of the task.
+ * @arg process The function that runs the task.
+ * @arg isReady The function that checks if the task has work, NULL if always.
+ * @arg getPriority The function that sets the priority, NULL if fixed.
+ * @arg priority The fixed priority.
+ * @arg periodMs The period in ms, 0 if the task runs whenever it is ready.
+ * @arg deadlineMs The time the task may wait once due in ms.
+ * @return Returns a boolean indicating if the task was registered.
+ */
+BOOL SCHED_AddTask(const char* name, void (*process)(void), BOOL (*isReady)(void),
+        UINT8 (*getPriority)(void), UINT8 priority, UINT16 periodMs, UINT16 deadlineMs)
+{
+    SCHED_TASK* task = NULL;
+    
+    if(numOfTasks >= SCHED_MAX_TASKS)
+    {
+        return FALSE;
+    }
+    
+    task = &tasks[numOfTasks];
+    task->name = name;
+    task->process = process;
+    task->isReady = isReady;
+    task->getPriority = getPriority;
+    task->priority = priority;
+    task->periodTicks = (UINT32)periodMs*TIMER_TICKS_PER_MS;
+    task->deadlineTicks = (UINT32)deadlineMs*TIMER_TICKS_PER_MS;
+    task->nextTicks = TIMER_GetCoreTicks() + task->periodTicks;
+    task->isDue = FALSE;
+    task->runs = 0;
+    task->misses = 0;
+    task->totalTicks = 0;
+    task->maxTicks = 0;
+    numOfTasks++;
+    return TRUE;
+}
+
+/**
+ * @brief Runs one pass of the scheduler.
+ * @details Marks the tasks that have become due and runs the one with the
+ * highest priority. Called from the main loop.
+ * @return Void
+ */
+void SCHED_Run(void)
+{
+    SCHED_TASK* next = NULL;
+    UINT32 now = TIMER_GetCoreTicks();
+    UINT8 priority = 0, nextPriority = 0;
+    int i = 0;
+    
+    for(i = 0; i < numOfTasks; i++)
+    {
+        SCHED_UpdateDue(&tasks[i], now);
+        if(!tasks[i].isDue)
+        {
+            continue;
+        }
+        
+        // Tasks of the same priority run in the order they became due.
+        priority = SCHED_GetPriority(&tasks[i]);
+        if((next == NULL) || (priority > nextPriority) ||
+                ((priority == nextPriority) && ((INT32)(tasks[i].dueTicks - next->dueTicks) < 0)))
+        {
+            next = &tasks[i];
+            nextPriority = priority;
+        }
+    }
+    
+    if(next != NULL)
+    {
+        SCHED_RunTask(next);
+    }
+}
+
+/**
+ * @brief Checks if a task has become due.
+ * @details A periodic task is due once its period has passed and a task with a
+ * period of 0 is due once it is ready. A periodic task that isn't ready skips
+ * the period.
+ * @arg task The task.
+ * @arg now The core timer count.
+ * @return Void
+ */
+void SCHED_UpdateDue(SCHED_TASK* task, UINT32 now)
+{
+    if(task->isDue)
+    {
+        return;
+    }
+    
+    if(task->periodTicks == 0)
+    {
+        if((task->isReady == NULL) || task->isReady())
+        {
+            task->isDue = TRUE;
+            task->dueTicks = now;
+        }
+    }
+    else if((INT32)(now - task->nextTicks) >= 0)
+    {
+        if((task->isReady == NULL) || task->isReady())
+        {
+            task->isDue = TRUE;
+            task->dueTicks = task->nextTicks;
+        }
+        else
+        {
+            task->nextTicks += task->periodTicks;
+        }
+    }
+}
+
+/**
+ * @brief Returns the priority of a task.
+ * @arg task The task.
+ * @return Returns the priority set by the task, or its fixed priority.
+ */
+UINT8 SCHED_GetPriority(SCHED_TASK* task)
+{
+    if(task->getPriority != NULL)
+    {
+        return task->getPriority();
+    }
+    return task->priority;
+}
+
+/**
+ * @brief Runs a task.
+ * @details Times the run and checks the time the task waited against its
+ * deadline. A periodic task that fell more than a period behind is resynced
+ * instead of running the missed periods back to back.
+ * @arg task The task.
+ * @return Void
+ */
+void SCHED_RunTask(SCHED_TASK* task)
+{
+    UINT32 startTicks = TIMER_GetCoreTicks();
+    UINT32 ticks = 0;
+    
+    if((startTicks - task->dueTicks) > task->deadlineTicks)
+    {
+        task->misses++;
+    }
+    
+    task->process();
+    
+    ticks = TIMER_GetCoreTicks() - startTicks;
+    task->runs++;
+    task->totalTicks += ticks;
+    if(ticks > task->maxTicks)
+    {
+        task->maxTicks = ticks;
+    }
+    
+    task->isDue = FALSE;
+    if(task->periodTicks > 0)
+    {
+        task->nextTicks += task->periodTicks;
+        if((INT32)(startTicks - task->nextTicks) >= 0)
+        {
+            task->nextTicks = startTicks + task->periodTicks;
+        }
+    }
+}
+
+/**
+ * @brief Displays the task statistics.
+ * @details Displays the number of runs, the mean and longest run and the
+ * deadline misses of every task.
+ * @arg reset Clears the statistics after they are displayed.
+ * @return Void
+ */
+void SCHED_ShowStats(BOOL reset)
+{
+    char buf[96];
+    int i = 0;
+    
+    for(i = 0; i < numOfTasks; i++)
+    {
+        snprintf(&buf[0], 96, "%s: %u runs, mean %u us, max %u us, %u deadline misses", tasks[i].name,
+                tasks[i].runs, (tasks[i].runs > 0) ? (tasks[i].totalTicks/TIMER_TICKS_PER_US)/tasks[i].runs : 0,
+                tasks[i].maxTicks/TIMER_TICKS_PER_US, tasks[i].misses);
+        MON_SendString(&buf[0]);
+    }
+    
+    if(reset)
+    {
+        SCHED_ClearStats();
+    }
+}
+
+/**
+ * @brief Clears the task statistics.
+ * @return Void
+ */
+void SCHED_ClearStats(void)
+{
+    int i = 0;
+    
+    for(i = 0; i < numOfTasks; i++)
+    {
+        tasks[i].runs = 0;
+        tasks[i].misses = 0;
+        tasks[i].totalTicks = 0;
+        tasks[i].maxTicks = 0;
+    }
+}
+
+/**
+ * @brief Enables or disables the telemetry.
+ * @arg isEnabled Sends the statistics every telemetry period (TRUE/FALSE).
+ * @return Void
+ */
+void SCHED_SetTelemetry(BOOL isEnabled)
+{
+    isTelemetry = isEnabled;
+}
+
+/**
+ * @brief Runs the telemetry task.
+ * @details Sends the task statistics if the telemetry is enabled.
+ * @return Void
+ */
+void SCHED_SendTelemetry(void)
+{
+    if(isTelemetry)
+    {
+        SCHED_ShowStats(FALSE);
+    }
+}
@@ -0,0 +1,59 @@
+/**
+ * @file SCHED.h
+ * @author Kue Yang
+ * @date 10/19/2026
+ */
+
+#ifndef SCHED_H
+#define	SCHED_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include "STDDEF.h"
+
+/** @def SCHED_MAX_TASKS
+ * Defines the number of tasks that can be registered. */
+#define SCHED_MAX_TASKS         10
+
+/**
+ * @brief SCHED_TASK data structure.
+ * @details The SCHED_TASK data structure stores a task run by the main loop,
+ * when it is due and how long it has run. A task with a period of 0 is due
+ * whenever it is ready. Higher priorities run first, like interrupt priorities.
+ */
+typedef struct SCHED_TASK
+{
+    /**@{*/
+    const char* name;               /**< Variable used to store the name of the task. */
+    void (*process)(void);          /**< Variable used to point to the function that runs the task. */
+    BOOL (*isReady)(void);          /**< Variable used to point to the function that checks for work, NULL if always ready. */
+    UINT8 (*getPriority)(void);     /**< Variable used to point to the function that sets the priority, NULL if fixed. */
+    UINT8 priority;                 /**< Variable used to store the fixed priority. */
+    UINT32 periodTicks;             /**< Variable used to store the period in core timer ticks, 0 if run when ready. */
+    UINT32 deadlineTicks;           /**< Variable used to store the core timer ticks the task may wait once due. */
+    UINT32 nextTicks;               /**< Variable used to store the core timer count the periodic task is next due. */
+    UINT32 dueTicks;                /**< Variable used to store the core timer count the task became due. */
+    BOOL isDue;                     /**< Variable used to store boolean indicating the task is waiting to run. */
+    UINT32 runs;                    /**< Variable used to store the number of runs. */
+    UINT32 misses;                  /**< Variable used to store the number of runs that started after the deadline. */
+    UINT32 totalTicks;              /**< Variable used to store the core timer ticks spent running. */
+    UINT32 maxTicks;                /**< Variable used to store the longest run in core timer ticks. */
+    /**@}*/
+}SCHED_TASK;
+
+void SCHED_Init(void);
+BOOL SCHED_AddTask(const char* name, void (*process)(void), BOOL (*isReady)(void),
+        UINT8 (*getPriority)(void), UINT8 priority, UINT16 periodMs, UINT16 deadlineMs);
+void SCHED_Run(void);
+void SCHED_ShowStats(BOOL reset);
+void SCHED_SetTelemetry(BOOL isEnabled);
+void SCHED_SendTelemetry(void);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* SCHED_H */
+
@@ -16,6 +16,8 @@ BYTE SPI1_ReadWrite(BYTE);
 BYTE SPI2_ReadWrite(BYTE);
 void SPI3_Init(int clk);
 BYTE SPI3_ReadWrite(BYTE ch);
+void SPI3_MultiWrite(const BYTE* buff, UINT16 cnt);
+void SPI3_MultiRead(BYTE* buff, UINT16 cnt);
 
 #ifdef	__cplusplus
 }
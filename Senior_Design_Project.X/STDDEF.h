@@ -25,15 +25,33 @@ extern "C" {
 typedef unsigned char       UINT8;
 /** @brief Typedef definition for UINT16. */
 typedef unsigned short      UINT16;
-/** @brief Typedef definition for UINT32. */
+/** @brief Typedef definition for UINT32, long is 64 bits on an LP64 host. */
+#ifdef __LP64__
+typedef unsigned int        UINT32;
+#else
 typedef unsigned long       UINT32;
+#endif
+/** @brief Typedef definition for UINT64. */
+typedef unsigned long long  UINT64;
+/** @brief Typedef definition for INT16. */
+typedef signed short        INT16;
+/** @brief Typedef definition for INT32. */
+#ifdef __LP64__
+typedef signed int          INT32;
+#else
+typedef signed long         INT32;
+#endif
 
 /** @brief Typedef definition for BYTE datatype. */
 typedef unsigned char       BYTE;   // 8-bits
 /** @brief Typedef definition for WORD datatype. */
 typedef unsigned short      WORD;   // 16-bits
 /** @brief Typedef definition for DWORD datatype. */
+#ifdef __LP64__
+typedef unsigned int        DWORD;  // 32-bits
+#else
 typedef unsigned long       DWORD;  // 32-bits
+#endif
 
 /** @def INT32_MAX_NUM 
  * Defines the max value for a 32-bit variable. */
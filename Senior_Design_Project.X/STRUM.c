@@ -0,0 +1,178 @@
+/**
+ * @file STRUM.c
+ * @author Kue Yang
+ * @date 10/19/2026
+ * @details The STRUM module detects strums from the raw strumming sensor
+ * samples. Each sample updates a running DC estimate, a fast attack/slow release
+ * envelope of the rectified signal and a noise floor that follows the envelope
+ * down immediately and up slowly. A strum is detected as soon as the envelope
+ * rises a margin above the noise floor, so detection fires within a few samples
+ * of the onset and also works on a string that is still ringing. The strum 
+ * velocity is the envelope peak over the STRUM_VELOCITY_WINDOW samples after 
+ * the onset, the envelope is still rising when the strum is detected.
+ * @remarks The module does not access any hardware registers so it can be built
+ * and run against recorded ADC traces on a host.
+ */
+
+#include "STDDEF.h"
+#include "STRUM.h"
+
+/**
+ * @brief Initializes a strum detector.
+ * @arg strum The strum detector to initialize.
+ * @arg midRail The expected resting ADC reading of the sensor.
+ * @return Void
+ */
+void STRUM_Init(STRUM* strum, UINT16 midRail)
+{
+    strum->dcLevel = ((INT32)midRail) << STRUM_Q;
+    strum->envelope = 0;
+    strum->noiseFloor = 0;
+    strum->peak = 0;
+    strum->velocity = 0;
+    strum->holdOff = 0;
+    strum->age = 0xFFFF;
+    strum->isArmed = TRUE;
+}
+
+/**
+ * @brief Processes one sample through the strum detector.
+ * @arg strum The strum detector.
+ * @arg sample The raw ADC sample.
+ * @return Returns a boolean indicating if a strum has been detected.
+ * @retval TRUE if the sample starts a new strum.
+ * @retval FALSE if no strum has been detected.
+ */
+BOOL STRUM_Detect(STRUM* strum, UINT16 sample)
+{
+    INT32 level = ((INT32)sample) << STRUM_Q;
+    INT32 delta;
+
+    if(strum->age < 0xFFFF)
+    {
+        strum->age++;
+    }
+
+    // Tracks the DC level and rectifies the signal around it.
+    strum->dcLevel += (level - strum->dcLevel) >> STRUM_DC_SHIFT;
+    delta = level - strum->dcLevel;
+    if(delta < 0)
+    {
+        delta = -delta;
+    }
+
+    // Fast attack, slow release envelope follower.
+    if(delta > strum->envelope)
+    {
+        strum->envelope += (delta - strum->envelope) >> STRUM_ATTACK_SHIFT;
+    }
+    else
+    {
+        strum->envelope -= strum->envelope >> STRUM_RELEASE_SHIFT;
+    }
+
+    // Noise floor drops with the envelope and rises slowly.
+    if(strum->envelope < strum->noiseFloor)
+    {
+        strum->noiseFloor = strum->envelope;
+    }
+    else
+    {
+        strum->noiseFloor += (strum->envelope - strum->noiseFloor) >> STRUM_FLOOR_SHIFT;
+    }
+
+    if(strum->isArmed)
+    {
+        // Fires once the envelope rises above 1.5x the floor plus a margin.
+        if(strum->envelope > (strum->noiseFloor + (strum->noiseFloor >> 1) + (STRUM_MIN_MARGIN << STRUM_Q)))
+        {
+            strum->isArmed = FALSE;
+            strum->holdOff = STRUM_HOLDOFF;
+            strum->peak = strum->envelope;
+            strum->age = 0;
+            return TRUE;
+        }
+    }
+    else
+    {
+        // Re-arms after the hold off once the envelope falls to half its peak.
+        if(strum->envelope > strum->peak)
+        {
+            strum->peak = strum->envelope;
+        }
+        if(strum->age == STRUM_VELOCITY_WINDOW)
+        {
+            strum->velocity = (UINT16)(strum->peak >> STRUM_Q);
+        }
+
+        if(strum->holdOff > 0)
+        {
+            strum->holdOff--;
+        }
+        else if(strum->envelope < (strum->peak >> 1))
+        {
+            strum->isArmed = TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/**
+ * @brief Processes a block of samples through the strum detector.
+ * @details Every sample in the block is processed so the detector state stays
+ * current even if a strum is detected early in the block.
+ * @arg strum The strum detector.
+ * @arg samples The raw ADC samples, oldest first.
+ * @arg count The number of samples in the block.
+ * @return Returns a boolean indicating if a strum has been detected.
+ * @retval TRUE if a new strum started within the block.
+ * @retval FALSE if no strum has been detected.
+ */
+BOOL STRUM_DetectBlock(STRUM* strum, const UINT16* samples, UINT16 count)
+{
+    BOOL isStrum = FALSE;
+    UINT16 i = 0;
+    
+    for(i = 0; i < count; i++)
+    {
+        if(STRUM_Detect(strum, samples[i]))
+        {
+            isStrum = TRUE;
+        }
+    }
+    return isStrum;
+}
+
+/**
+ * @brief Returns the strength of the last settled strum.
+ * @details The velocity of a strum settles STRUM_VELOCITY_WINDOW samples after
+ * it is detected, until then the velocity of the previous strum is returned.
+ * @arg strum The strum detector.
+ * @return Returns the envelope peak of the strum in ADC counts.
+ */
+UINT16 STRUM_GetVelocity(STRUM* strum)
+{
+    return strum->velocity;
+}
+
+/**
+ * @brief Checks if the velocity of the last strum has just settled.
+ * @arg strum The strum detector.
+ * @arg count The number of samples processed since the last check.
+ * @return Returns a boolean indicating if the velocity settled within the last
+ * count samples.
+ */
+BOOL STRUM_HasSettled(STRUM* strum, UINT16 count)
+{
+    return (strum->age >= STRUM_VELOCITY_WINDOW) && (strum->age < STRUM_VELOCITY_WINDOW + count);
+}
+
+/**
+ * @brief Returns the age of the last detected strum.
+ * @arg strum The strum detector.
+ * @return Returns the number of samples processed since the last strum.
+ */
+UINT16 STRUM_GetAge(STRUM* strum)
+{
+    return strum->age;
+}
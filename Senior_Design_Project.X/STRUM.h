@@ -0,0 +1,79 @@
+/**
+ * @file STRUM.h
+ * @author Kue Yang
+ * @date 10/19/2026
+ */
+
+#ifndef STRUM_H
+#define	STRUM_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include "STDDEF.h"
+
+/** @def STRUM_Q
+ * Defines the number of fractional bits used by the detector levels. */
+#define STRUM_Q                 8
+/** @def STRUM_DC_SHIFT
+ * Defines the DC estimate time constant, 2^11 samples (~420 ms). Each string 
+ * is sampled every 204.8 us. */
+#define STRUM_DC_SHIFT          11
+/** @def STRUM_ATTACK_SHIFT
+ * Defines the envelope attack time constant, 2^1 samples (~0.4 ms). */
+#define STRUM_ATTACK_SHIFT      1
+/** @def STRUM_RELEASE_SHIFT
+ * Defines the envelope release time constant, 2^8 samples (~52 ms). */
+#define STRUM_RELEASE_SHIFT     8
+/** @def STRUM_FLOOR_SHIFT
+ * Defines the rise time constant of the noise floor, 2^9 samples (~105 ms). */
+#define STRUM_FLOOR_SHIFT       9
+/** @def STRUM_MIN_MARGIN
+ * Defines the minimum envelope rise above the noise floor, in ADC counts. */
+#define STRUM_MIN_MARGIN        24
+/** @def STRUM_HOLDOFF
+ * Defines the number of samples the detector stays disarmed after a strum 
+ * (~3.3 ms). */
+#define STRUM_HOLDOFF           16
+/** @def STRUM_VELOCITY_WINDOW
+ * Defines the number of samples after a strum the envelope peak is tracked 
+ * for before it is taken as the strum velocity (~3.3 ms). */
+#define STRUM_VELOCITY_WINDOW   16
+
+#if STRUM_VELOCITY_WINDOW > STRUM_HOLDOFF
+#error "STRUM_VELOCITY_WINDOW must not outlast STRUM_HOLDOFF, the detector could re-arm within it."
+#endif
+
+/**
+ * @brief STRUM data structure.
+ * @details The STRUM data structure stores the state of one strum detector. All
+ * levels are ADC counts in fixed point with STRUM_Q fractional bits.
+ */
+typedef struct STRUM
+{
+    /**@{*/
+    INT32   dcLevel;            /**< Variable used to store the running DC estimate. */
+    INT32   envelope;           /**< Variable used to store the rectified signal envelope. */
+    INT32   noiseFloor;         /**< Variable used to store the adaptive noise floor. */
+    INT32   peak;               /**< Variable used to store the envelope peak since the last strum. */
+    UINT16  velocity;           /**< Variable used to store the envelope peak of the last settled strum. */
+    UINT16  holdOff;            /**< Variable used to count down the re-arm hold off. */
+    UINT16  age;                /**< Variable used to count the samples since the last strum. */
+    BOOL    isArmed;            /**< Variable used to indicate a strum can be detected. */
+    /**@}*/
+}STRUM;
+
+void STRUM_Init(STRUM* strum, UINT16 midRail);
+BOOL STRUM_Detect(STRUM* strum, UINT16 sample);
+BOOL STRUM_DetectBlock(STRUM* strum, const UINT16* samples, UINT16 count);
+UINT16 STRUM_GetVelocity(STRUM* strum);
+BOOL STRUM_HasSettled(STRUM* strum, UINT16 count);
+UINT16 STRUM_GetAge(STRUM* strum);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* STRUM_H */
+
@@ -3,38 +3,65 @@
  * @author Kue Yang
  * @date 11/22/2016
  * @details The TIMER module will handle timers and delays used in the 
- * application. 
+ * application. Time is kept by a 64-bit timebase built on the core timer, the
+ * 32-bit CP0 Count register extended by counting its half wraps. The core 
+ * timer interrupt fires as the count crosses each half wrap, about every 
+ * 107 s, and is the only writer of the count of half wraps, so the timebase 
+ * is read without disabling interrupts.
  */
 
 #include <p32xxxx.h>
+#include <stdio.h>
 #include "plib/plib.h"
 #include "HardwareProfile.h"
 #include "STDDEF.h"
-#include "./fatfs/diskio.h"
 #include "AUDIO.h"
+#include "UART.h"
+#include "JITTER.h"
 #include "TIMER.h"
 
 /**  
  * @privatesection
  * @{
  */
-/** @def ONE_MS_PERIOD 
- * Timer 1 Period for one ms. */
-#define ONE_MS_PERIOD           40000
+/** @def TIMER_HALF_WRAP 
+ * Core timer ticks between two core timer interrupts, half a wrap of the count. */
+#define TIMER_HALF_WRAP         0x80000000
+/** @def TIMER3_INIT_PERIOD 
+ * Timer 3 period before a sample rate is set, 1 ms at a 40 MHz peripheral clock. */
+#define TIMER3_INIT_PERIOD      40000
 
-/**@var ms_TICK 
- * Millisecond counter. */
-UINT32 ms_TICK;
-/**@var Timer1_ON 
- * Boolean used to indicated if Timer 1 is on/off. */
-BOOL Timer1_ON;
+/**@var coreHalves 
+ * The number of half wraps of the core timer counted by the core timer 
+ * interrupt. Its lowest bit matches the top bit of the count once counted. */
+volatile UINT32 coreHalves;
 /**@var Timer3_ON 
  * Boolean used to indicated if Timer 3 is on/off. */
 BOOL Timer3_ON;
+/**@var t3Count 
+ * The number of Timer 3 interrupts measured. */
+UINT32 t3Count;
+/**@var t3LatencySum 
+ * The sum of the Timer 3 interrupt latencies, in peripheral clocks. */
+UINT32 t3LatencySum;
+/**@var t3LatencyMax 
+ * The longest Timer 3 interrupt latency, in peripheral clocks. */
+UINT32 t3LatencyMax;
+/**@var t3LastTicks 
+ * The core timer count of the last Timer 3 interrupt. */
+UINT32 t3LastTicks;
+/**@var t3IntervalMin 
+ * The shortest time between two Timer 3 interrupts, in core timer ticks. */
+UINT32 t3IntervalMin;
+/**@var t3IntervalMax 
+ * The longest time between two Timer 3 interrupts, in core timer ticks. */
+UINT32 t3IntervalMax;
 /** @} */
 
-void TIMER1_Init(void);
+void TIMER_CoreInit(void);
 void TIMER3_Init(void);
+void TIMER3_AddJitter(UINT32 latency, UINT32 ticks);
+void TIMER3_ClearJitter(void);
 
 /**
  * @brief Initializes all timer modules.
@@ -42,9 +69,7 @@ void TIMER3_Init(void);
  */
 void TIMER_Init(void)
 {
-    ms_TICK = 0;
-    
-    TIMER1_Init();
+    TIMER_CoreInit();
     TIMER3_Init();
 }
 
@@ -61,59 +86,51 @@ void TIMER_Process(void)
 }
 
 /**
- * @brief Initializes Timer 1 module.
+ * @brief Initializes the timebase.
+ * @details The core timer interrupt is only used to count the half wraps of 
+ * the count.
  * @return Void
  */
-void TIMER1_Init(void)
+void TIMER_CoreInit(void)
 {
-    T1CONbits.ON = 0;           // Disable Timer 1
-    T1CONbits.SIDL = 0;         // Disables sleep on idle
-    T1CONbits.TGATE = 0;        // Gated time accumulation is disabled
-    T1CONbits.TCKPS = 0b000;    // Timer 1 Pre-Scalar = 1
-    T1CONbits.TCS = 0;
-    
-    PR1 = ONE_MS_PERIOD;        // Sets Timer 1 Period to 1 ms
-    TMR1 = 0;                   // Clears Timer 1 counter
+    coreHalves = (_CP0_GET_COUNT() & TIMER_HALF_WRAP) ? 1 : 0;
     
-    T1CONbits.ON = 1;           // Enable Timer 1
-    
-    /* Sets up the Timer 1 interrupts. */
-    IFS0bits.T1IF = 0;          // Clears Timer 1 Interrupt Flag
-    IEC0bits.T1IE = 1;          // Enables Timer 1 Interrupt
-    IPC1bits.T1IP = 2;          // Sets Timer 1 Interrupt Priority 2
-    IPC1bits.T1IS = 0;          // Sets Timer 1 Interrupt Sub-Priority 0
+    /* Sets up the core timer interrupt at the next half wrap. */
+    _CP0_SET_COMPARE((coreHalves & 1) ? 0 : TIMER_HALF_WRAP);
+    IFS0bits.CTIF = 0;          // Clears Core Timer Interrupt Flag
+    IPC0bits.CTIP = 1;          // Sets Core Timer Interrupt Priority 1
+    IPC0bits.CTIS = 0;          // Sets Core Timer Interrupt Sub-Priority 0
+    IEC0bits.CTIE = 1;          // Enables Core Timer Interrupt
 }
 
 /**
- * @brief Checks if Timer 1 is on/off.
- * @return Returns a boolean indicating if Timer 1 is on/off.
- * @retval TRUE Timer 1 is on.
- * @retval FALSE Timer 1 is off.
+ * @brief Returns the timebase.
+ * @details Extends the core timer count to 64 bits without disabling 
+ * interrupts, so reading it never delays the audio output. The half wraps are
+ * read before the count. If the count has crossed a half wrap the core timer 
+ * interrupt hasn't counted yet, the top bit of the count no longer matches the
+ * lowest bit of the half wraps and the crossing is added.
+ * @return Returns the core timer ticks since startup.
  */
-BOOL TIMER1_IsON(void)
+UINT64 TIMER_GetTicks(void)
 {
-    return Timer1_ON;
+    UINT32 halves = coreHalves;
+    UINT32 count = _CP0_GET_COUNT();
+    
+    if(((count & TIMER_HALF_WRAP) ? 1 : 0) != (halves & 1))
+    {
+        halves++;
+    }
+    return ((UINT64)(halves >> 1) << 32) | count;
 }
 
 /**
- * @brief Toggles on/off Timer 1.
- * @arg ON Toggles the timer on/off (TRUE/FALSE).
- * @return Void
+ * @brief Returns the time in microseconds.
+ * @return Returns the microseconds since startup.
  */
-void TIMER1_ON(BOOL ON)
+UINT64 TIMER_GetMicros(void)
 {
-    if(ON == TRUE)
-    {
-        T1CONbits.ON = 1;
-        Timer1_ON = TRUE;
-        IFS0bits.T1IF = 0;
-    }
-    else
-    {
-        T1CONbits.ON = 0;
-        Timer1_ON = FALSE;
-        IFS0bits.T1IF = 0;
-    }
+    return TIMER_GetTicks()/TIMER_TICKS_PER_US;
 }
 
 /**
@@ -123,8 +140,9 @@ void TIMER1_ON(BOOL ON)
  */
 void TIMER_MSecondDelay(int timeDelay)
 {
-    int msTick = TIMER_GetMSecond();
-    while ((ms_TICK-msTick) <= timeDelay);
+    UINT64 end = TIMER_GetTicks() + (UINT64)timeDelay*1000*TIMER_TICKS_PER_US;
+    
+    while(TIMER_GetTicks() < end);
 }
 
 /**
@@ -133,32 +151,32 @@ void TIMER_MSecondDelay(int timeDelay)
  */
 UINT32 TIMER_GetMSecond(void)
 {
-    return ms_TICK;
+    return (UINT32)(TIMER_GetTicks()/(1000*TIMER_TICKS_PER_US));
+}
+
+/**
+ * @brief Returns the core timer count.
+ * @details The core timer increments once every two system clocks (20 MHz).
+ * @return Returns the CP0 Count register.
+ */
+UINT32 TIMER_GetCoreTicks(void)
+{
+    return _CP0_GET_COUNT();
 }
 
 /**
- * @brief Timer 1 Interrupt Service Routine.
- * @details The interrupt service routine is used to increment the millisecond
- * counter used for the timer.
+ * @brief Core Timer Interrupt Service Routine.
+ * @details Counts the half wrap the count has crossed and sets the next 
+ * interrupt at the following half wrap.
  * @return Void.
  */
-void __ISR(_TIMER_1_VECTOR, IPL2AUTO) Timer1Handler(void)
+void __ISR(_CORE_TIMER_VECTOR, IPL1AUTO) CoreTimerHandler(void)
 {
-    // Increments the millisecond counter.
-    ms_TICK++;
-    
-    // Resets the ms tick if overflows
-    if(ms_TICK >= INT32_MAX_NUM)
-    {
-        ms_TICK = 0;
-    }
-    
-    CLEAR_WATCHDOG_TIMER       // Clears the watchdog timer flag.
-	disk_timerproc();	/* Drive timer procedure of low level disk I/O module */
-    CLEAR_WATCHDOG_TIMER       // Clears the watchdog timer flag.
+    coreHalves++;
+    _CP0_SET_COMPARE((coreHalves & 1) ? 0 : TIMER_HALF_WRAP);
     
     // Clear the interrupt flag
-    IFS0bits.T1IF = 0;
+    IFS0bits.CTIF = 0;
 }
 
 /**
@@ -173,7 +191,7 @@ void TIMER3_Init(void)
     T3CONbits.TCKPS = 0b000;    // Timer 3 Pre-Scalar = 1
     T3CONbits.TCS = 0;
     
-    PR3 = ONE_MS_PERIOD;        // Sets Timer 3 Period to 1 ms
+    PR3 = TIMER3_INIT_PERIOD;   // Sets Timer 3 Period to 1 ms
     TMR3 = 0;                   // Clears Timer 3 counter
     
     T3CONbits.ON = 0;           // Disable Timer 3
@@ -181,10 +199,11 @@ void TIMER3_Init(void)
     /* Sets up the Timer 1 interrupts. */
     IFS0bits.T3IF = 0;          // Clears Timer 3 interrupt flag
     IEC0bits.T3IE = 1;          // Enables Timer 3 interrupt
-    IPC3bits.T3IP = 2;          // Sets Timer 3 priority to 2
-    IPC3bits.T3IS = 2;          // Sets Timer 3 sub-priority to 2
+    IPC3bits.T3IP = 7;          // Sets Timer 3 priority to 7, uses the shadow register set
+    IPC3bits.T3IS = 3;          // Sets Timer 3 sub-priority to 3
     
     Timer3_ON = FALSE;
+    TIMER3_ClearJitter();
 }
 
 /**
@@ -219,6 +238,8 @@ void TIMER3_ON(BOOL ON)
 {
     if(ON == TRUE)
     {
+        t3LastTicks = 0;
+        JITTER_Restart();
         TMR3 = 0;
         T3CONbits.ON = 1;
         Timer3_ON = TRUE;
@@ -233,20 +254,106 @@ void TIMER3_ON(BOOL ON)
     }
 }
 
+/**
+ * @brief Records the timing of a Timer 3 interrupt.
+ * @arg latency The Timer 3 count at the start of the interrupt.
+ * @arg ticks The core timer count at the start of the interrupt.
+ * @return Void
+ */
+void TIMER3_AddJitter(UINT32 latency, UINT32 ticks)
+{
+    UINT32 interval = ticks - t3LastTicks;
+    
+    t3Count++;
+    t3LatencySum += latency;
+    if(latency > t3LatencyMax)
+    {
+        t3LatencyMax = latency;
+    }
+    
+    // The first interrupt after the timer is turned on has no interval.
+    if(t3LastTicks != 0)
+    {
+        if(interval < t3IntervalMin)
+        {
+            t3IntervalMin = interval;
+        }
+        if(interval > t3IntervalMax)
+        {
+            t3IntervalMax = interval;
+        }
+    }
+    t3LastTicks = (ticks != 0) ? ticks : 1;
+}
+
+/**
+ * @brief Displays the timing of the Timer 3 interrupts.
+ * @details The latency is the time from the period match to the start of the
+ * interrupt. The interval is the time between two DAC writes, which should be 
+ * one Timer 3 period.
+ * @arg reset Clears the timing after it is displayed if set to TRUE.
+ * @return Void
+ */
+void TIMER3_ShowJitter(BOOL reset)
+{
+    char buf[96];
+    UINT32 pbClocksPerUs = GetPeripheralClock()/1000000;
+    
+    if(t3Count > 0)
+    {
+        snprintf(&buf[0], 96, "Timer 3: %u interrupts, latency avg %u ns, max %u ns",
+                t3Count, (t3LatencySum/t3Count)*1000/pbClocksPerUs, t3LatencyMax*1000/pbClocksPerUs);
+        MON_SendString(&buf[0]);
+    }
+    if(t3IntervalMax > 0)
+    {
+        // The core timer ticks every 50 ns.
+        snprintf(&buf[0], 96, "Period %u ns, interval min %u ns, max %u ns",
+                (PR3 + 1)*1000/pbClocksPerUs, t3IntervalMin*50, t3IntervalMax*50);
+        MON_SendString(&buf[0]);
+    }
+    
+    if(reset == TRUE)
+    {
+        TIMER3_ClearJitter();
+    }
+}
+
+/**
+ * @brief Clears the timing of the Timer 3 interrupts.
+ * @return Void
+ */
+void TIMER3_ClearJitter(void)
+{
+    t3Count = 0;
+    t3LatencySum = 0;
+    t3LatencyMax = 0;
+    t3IntervalMin = 0xFFFFFFFF;
+    t3IntervalMax = 0;
+}
+
 /**
  * @brief Timer 3 Interrupt Service Routine.
  * @details The interrupt service routine is used to write audio data to the 
- * DAC in a set interval.
+ * DAC in a set interval. It runs at the highest priority with the shadow 
+ * register set, so the DAC writes don't wait for the other interrupts and the
+ * registers don't need to be saved.
  * @return Void.
  */
-void __ISR(_TIMER_3_VECTOR, IPL2AUTO) Timer3Handler(void)
+void __ISR(_TIMER_3_VECTOR, IPL7SRS) Timer3Handler(void)
 {
+    // Timer 3 restarts from zero on the period match.
+    UINT32 latency = TMR3;
+    UINT32 ticks = TIMER_GetCoreTicks();
+    
+
     /* 
      * Checks if the bytes written is greater than the buffer size. If so, 
      * starts reading from memory again to fill in the buffer. Otherwise, write
      * data to the DAC.
      */
     AUDIO_WriteDataToDAC();
+    TIMER3_AddJitter(latency, ticks);
     
     // Clear the interrupt flag
     IFS0bits.T3IF = 0;
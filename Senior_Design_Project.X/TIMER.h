@@ -12,18 +12,27 @@ extern "C" {
 #endif
 
 #include "STDDEF.h"
+
+/** @def TIMER_TICKS_PER_US
+ * Defines the number of core timer ticks per microsecond. */
+#define TIMER_TICKS_PER_US      20
+/** @def TIMER_TICKS_PER_MS
+ * Defines the number of core timer ticks per millisecond. */
+#define TIMER_TICKS_PER_MS      (1000*TIMER_TICKS_PER_US)
     
 void TIMER_Init(void);
 void TIMER_Process(void);
 
+UINT64 TIMER_GetTicks(void);
+UINT64 TIMER_GetMicros(void);
 UINT32 TIMER_GetMSecond(void);
+UINT32 TIMER_GetCoreTicks(void);
 void TIMER_MSecondDelay(int);
-BOOL TIMER1_IsON(void);
-void TIMER1_ON(BOOL ON);
 
 BOOL TIMER3_IsON(void);
 void TIMER3_ON(BOOL ON);
 void TIMER3_SetSampleRate(UINT16 sampleRate);
+void TIMER3_ShowJitter(BOOL reset);
 
 #ifdef	__cplusplus
 }
@@ -17,11 +17,16 @@
 #include "FIFO.h"
 #include "DAC.h"
 #include "AUDIO.h"
+#include "ADC.h"
+#include "CAPTURE.h"
+#include "LATENCY.h"
+#include "JITTER.h"
+#include "READAHEAD.h"
+#include "FRET.h"
+#include "SCHED.h"
+#include "UPLOAD.h"
 #include "UART.h"
 
-/** @def DESIRED_BAUDRATE 
- * The desired UART baud rate. */
-#define DESIRED_BAUDRATE        (19200)     //The desired BaudRate
 /** @def WRITE_BUFFER_SIZE 
  * The buffer size for writing. */
 #define WRITE_BUFFER_SIZE       128
@@ -31,18 +36,32 @@
 /** @def DESCRIPTION_SIZE 
  * The size of command description string. */
 #define DESCRIPTION_SIZE        (WRITE_BUFFER_SIZE-CMD_SIZE)
+/** @def UART_TX_IPL 
+ * The priority of the interrupts that send to the monitor, they share the 
+ * transmit buffer with the main loop. */
+#define UART_TX_IPL             2
+/** @def UART_BENCHMARK_BYTES 
+ * The number of bytes moved through a FIFO queue by the FIFO benchmark. */
+#define UART_BENCHMARK_BYTES    16384
+/** @def UART_BENCHMARK_CHUNK 
+ * The number of bytes per bulk copy in the FIFO benchmark. */
+#define UART_BENCHMARK_CHUNK    64
 
 /** UART Helper Functions. */
 int UART_GetBaudRate(int desireBaud);
 
 /** FIFO helper functions. */
-BOOL UART_isBufferEmpty(MON_FIFO* buffer);
-char UART_getNextChar(MON_FIFO* buffer);
-void UART_putNextChar(MON_FIFO* buffer, char ch);
+BOOL UART_isBufferEmpty(FIFO* buffer);
+char UART_getNextChar(FIFO* buffer);
+void UART_putNextChar(FIFO* buffer, char ch);
+void UART_SendBytes(const char* data, UINT16 count, BOOL isNewLine);
+UINT32 UART_LockTx(void);
+void UART_UnlockTx(UINT32 status);
+void UART_BenchmarkFifo(void);
 
 /** Command Helper Functions. */
 void UART_processCommand(void);
-int MON_parseCommand(COMMANDSTR* cmd, MON_FIFO* buffer);
+int MON_parseCommand(COMMANDSTR* cmd, FIFO* buffer);
 COMMANDS MON_getCommand(const char* cmdName);
 
 /** Commands Handlers. */
@@ -64,18 +83,51 @@ void MON_Timer_ON_OFF(void);
 void MON_Timer_Get_PS(void);
 void MON_Timer_Set_PS(void);
 
+/* Audio related commands. */
+void MON_Resample_Benchmark(void);
+void MON_Decode_Benchmark(void);
+void MON_Slide_Mode(void);
+
+/* ADC related commands. */
+void MON_Strum_Stats(void);
+void MON_Capture_Start(void);
+void MON_Capture_Dump(void);
+void MON_Capture_Replay(void);
+void MON_Latency_Stats(void);
+void MON_Jitter_Stats(void);
+void MON_Prefetch_Stats(void);
+void MON_Block_Stats(void);
+void MON_Sched_Stats(void);
+void MON_Card_Stats(void);
+void MON_Readahead_Stats(void);
+void MON_Fret_Stats(void);
+void MON_Fret_Calibrate(void);
+void MON_Fifo_Stats(void);
+
+/* SD card related commands. */
+void MON_Upload(void);
+
 /** @var cmdStr 
  * The command string. */
 COMMANDSTR cmdStr;
 /** @var rxBuffer 
  * The UART receive buffer. */
-MON_FIFO rxBuffer;
+FIFO rxBuffer;
 /** @var txBuffer 
  * The UART transmit buffer. */
-MON_FIFO txBuffer;
-/** @var cmdReady 
- * The UART command receive flag. */
-BOOL cmdReady;
+FIFO txBuffer;
+/** @var rxBufferData 
+ * The data of the UART receive buffer. */
+BYTE rxBufferData[MON_BUFFERSIZE];
+/** @var txBufferData 
+ * The data of the UART transmit buffer. */
+BYTE txBufferData[MON_BUFFERSIZE];
+/** @var cmdsReceived 
+ * Counts the commands received, written by the UART interrupt only. */
+volatile UINT8 cmdsReceived;
+/** @var cmdsRun 
+ * Counts the commands run, written by the monitor task only. */
+UINT8 cmdsRun;
 /** @var actualBaudRate 
  * The configured UART baud rate. */
 UINT16 actualBaudRate;
@@ -96,6 +148,24 @@ COMMANDS MON_COMMANDS[] = {
     {"TONE", " Toggles on/off the Audio Timer. ", MON_Timer_ON_OFF},
     {"PDG", " Get the current period set on timer 3. FORMAT: PDG.", MON_Timer_Get_PS},
     {"PDS", " Configures the timer period. FORMAT: PDS period .", MON_Timer_Set_PS},
+    {"RESAMPLE", " Benchmarks the resampler against the Timer 3 period. ", MON_Resample_Benchmark},
+    {"DECODE", " Benchmarks decoding from a copy against decoding in place once the note has finished. ", MON_Decode_Benchmark},
+    {"SLIDE", " Ringing notes follow fret changes if mode is set to 1, bend with the finger position if mode is set to 2. FORMAT: SLIDE mode.", MON_Slide_Mode},
+    {"STRUM", " Displays strum counts, velocities, strum detector cost and the ADC interrupt rate. ", MON_Strum_Stats},
+    {"CAPTURE", " Captures the raw samples of a string. FORMAT: CAPTURE string.", MON_Capture_Start},
+    {"DUMP", " Stops the capture and sends the captured samples. ", MON_Capture_Dump},
+    {"REPLAY", " Stops the capture and replays it through the strum detector. ", MON_Capture_Replay},
+    {"LATENCY", " Displays the strum to sound latency. Clears the latency if reset is set to 1. FORMAT: LATENCY reset.", MON_Latency_Stats},
+    {"JITTER", " Displays audio interrupt timing, DAC jitter and underruns. Clears them if reset is 1. FORMAT: JITTER reset.", MON_Jitter_Stats},
+    {"PREFETCH", " Displays the fret prefetch hit rate and the latency saved. Clears them if reset is 1. FORMAT: PREFETCH reset.", MON_Prefetch_Stats},
+    {"BLOCKS", " Displays the cycles per frame spent rendering audio blocks and copying frames to the DACs. Clears them if reset is 1. FORMAT: BLOCKS reset.", MON_Block_Stats},
+    {"SCHED", " Displays the main loop task runtimes and deadline misses. Clears them if reset is 1, sends them every second if telemetry is 1. FORMAT: SCHED reset telemetry.", MON_Sched_Stats},
+    {"CARD", " Displays the SD card faults and recovery times. Clears them if reset is 1, injects a card fault if fault is 1. FORMAT: CARD reset fault.", MON_Card_Stats},
+    {"AHEAD", " Displays the read-ahead depth and the SD read time percentiles. Clears them and restarts the tuning if reset is 1. FORMAT: AHEAD reset.", MON_Readahead_Stats},
+    {"FRETS", " Displays the finger position and fret table of a string. Clears its calibration if reset is 1. FORMAT: FRETS string reset.", MON_Fret_Stats},
+    {"FRETCAL", " Calibrates a fret of a string while it is pressed, fret 0 while the string isn't touched. FORMAT: FRETCAL string fret.", MON_Fret_Calibrate},
+    {"FIFO", " Displays the monitor buffer drops and benchmarks the FIFO queue. Clears the drops if reset is 1. FORMAT: FIFO reset.", MON_Fifo_Stats},
+    {"UPLOAD", " Writes a sample pack received in frames over the contiguous pack on the card. FORMAT: UPLOAD sectors.", MON_Upload},
     {"", "", NULL}
 };
 
@@ -105,8 +175,11 @@ COMMANDS MON_COMMANDS[] = {
  */
 void UART_Init(void)
 { 
-    cmdReady = FALSE;
+    cmdsReceived = 0;
+    cmdsRun = 0;
     numOfCmds = sizeof(MON_COMMANDS)/sizeof(MON_COMMANDS[0]);
+    FIFO_Init(&rxBuffer, &rxBufferData[0], MON_BUFFERSIZE);
+    FIFO_Init(&txBuffer, &txBufferData[0], MON_BUFFERSIZE);
     
     // Re-mapped pins RPC1 and RPE5 pins to U1RX and U1TX
     mSysUnlockOpLock({
@@ -147,7 +220,7 @@ void UART_Init(void)
     IEC1bits.U1RXIE = 1;        // Enables U1RX Interrupt Enable
     IFS1bits.U1TXIF = 0;        // Clears Transmit Interrupt Flag 
     IEC1bits.U1TXIE = 0;        // Disables U1TX Interrupt Enable
-    IPC7bits.U1IP = 2;          // Sets UART Interrupt Priority 2
+    IPC7bits.U1IP = 2;          // Sets UART Interrupt Priority 2, the priority of the strum handling
     IPC7bits.U1IS = 1;          // Sets UART Interrupt Sub-Priority 2
     
 //    MON_GetHelp();
@@ -164,22 +237,62 @@ int UART_GetBaudRate(int desireBaud)
     return ((GetPeripheralClock()/(16*desireBaud))) - 1;
 }
 
+/**
+ * @brief Changes the baud rate.
+ * @details Waits for the transmit buffer to be sent before changing the baud 
+ * rate. Rates above DESIRED_BAUDRATE use the high speed mode.
+ * @remarks Must not be called from an interrupt at or above the UART priority.
+ * @arg desireBaud The desired baud rate.
+ * @return Void
+ */
+void UART_SetBaudRate(int desireBaud)
+{
+    while(!FIFO_IsEmpty(&txBuffer) || !U1STAbits.TRMT)
+    {
+        CLEAR_WATCHDOG_TIMER;
+    }
+    
+    U1MODEbits.ON = 0;          // Disables the UART module
+    if(desireBaud > DESIRED_BAUDRATE)
+    {
+        U1MODEbits.BRGH = 1;    // High Speed mode, 4x baud clock enabled
+        U1BRG = (GetPeripheralClock()/(4*desireBaud)) - 1;
+    }
+    else
+    {
+        U1MODEbits.BRGH = 0;    // Standard Speed mode, 16x baud clock enabled
+        U1BRG = UART_GetBaudRate(desireBaud);
+    }
+    U1MODEbits.ON = 1;          // Enables the UART module
+}
+
 /**
  * @brief Processes all UART related tasks.
+ * @details Runs the next received command. Run by the monitor task of the main
+ * loop, the UART interrupt only queues the commands in the receive buffer.
  * @return Void.
  */
 void UART_Process(void)
 {
-//    UART_processCommand();
+    UART_processCommand();
 } 
 
+/**
+ * @brief Checks if a received command is waiting to be run.
+ * @return Returns a boolean indicating if a command is waiting.
+ */
+BOOL UART_IsCommandReady(void)
+{
+    return (cmdsReceived != cmdsRun);
+}
+
 /**
  * @brief Processes commands received by the UART module.
  * @return Void.
  */
 void UART_processCommand(void)
 {
-    if(!UART_isBufferEmpty(&rxBuffer) && cmdReady == TRUE)
+    if(UART_IsCommandReady())
     {
         int numOfArgs = 0;
 
@@ -208,8 +321,8 @@ void UART_processCommand(void)
         /* Prepares for the next command. */
         MON_SendString(">");
         
-        /* Resets the ready flag. */
-        cmdReady = FALSE;
+        /* Marks the command as run. */
+        cmdsRun++;
     }
 }
 
@@ -219,7 +332,7 @@ void UART_processCommand(void)
  * @arg buffer The receive buffer.
  * @return Returns the number of command arguments.
  */
-int MON_parseCommand(COMMANDSTR* cmd, MON_FIFO* buffer)
+int MON_parseCommand(COMMANDSTR* cmd, FIFO* buffer)
 {   
     int i = 0, numOfArgs = 0;
     int argIndexes[3] = {0,0,0};
@@ -279,10 +392,7 @@ int MON_parseCommand(COMMANDSTR* cmd, MON_FIFO* buffer)
  */
 void MON_SendChar(const char* character)
 {
-    UART_putNextChar(&txBuffer, *character);
-    
-    IFS1bits.U1TXIF = 0;        // Clears Transmit Interrupt Flag 
-    IEC1bits.U1TXIE = 1;        // Enables U1TX Interrupt Enable
+    UART_SendBytes(character, 1, FALSE);
 }
 
 /**
@@ -295,22 +405,21 @@ void MON_SendString(const char* str)
 {
     if(*str == '>')
     {
-        UART_putNextChar(&txBuffer, *str);
+        UART_SendBytes(str, 1, FALSE);
     }
     else
     {
-        while(*str != '\0')
-        {
-            UART_putNextChar(&txBuffer, *str);
-            str++;
-        }
-
-        UART_putNextChar(&txBuffer, '\n');
-        UART_putNextChar(&txBuffer, '\r');
+        UART_SendBytes(str, strlen(str), TRUE);
     }
-    
-    IFS1bits.U1TXIF = 0;        // Clears Transmit Interrupt Flag 
-    IEC1bits.U1TXIE = 1;        // Enables U1TX Interrupt Enable
+}
+
+/**
+ * @brief Returns the free space in the transmit buffer.
+ * @return Returns the number of characters that can be sent without loss.
+ */
+UINT16 MON_GetTxFree(void)
+{
+    return FIFO_GetFree(&txBuffer);
 }
 
 /**
@@ -323,21 +432,66 @@ void MON_SendStringNR(const char* str)
 {
     if(*str == '>')
     {
-        UART_putNextChar(&txBuffer, *str);
+        UART_SendBytes(str, 1, FALSE);
     }
     else
     {
-        while(*str != '\0')
-        {
-            UART_putNextChar(&txBuffer, *str);
-            str++;
-        }
+        UART_SendBytes(str, strlen(str), FALSE);
     }
+}
+
+/**
+ * @brief Queues bytes to be transmitted.
+ * @details Copies the bytes into the transmit buffer in bulk and starts the 
+ * transmit interrupt. Bytes that don't fit are dropped and counted.
+ * @arg data The bytes to transmit.
+ * @arg count The number of bytes to transmit.
+ * @arg isNewLine Appends a newline and return character (TRUE/FALSE).
+ * @return Void.
+ */
+void UART_SendBytes(const char* data, UINT16 count, BOOL isNewLine)
+{
+    UINT32 status = UART_LockTx();
+    
+    FIFO_Write(&txBuffer, (const BYTE*)data, count);
+    if(isNewLine)
+    {
+        FIFO_Write(&txBuffer, (const BYTE*)"\n\r", 2);
+    }
+    UART_UnlockTx(status);
     
     IFS1bits.U1TXIF = 0;        // Clears Transmit Interrupt Flag 
     IEC1bits.U1TXIE = 1;        // Enables U1TX Interrupt Enable
 }
 
+/**
+ * @brief Locks the transmit buffer.
+ * @details The main loop and the interrupts at UART_TX_IPL all write to the 
+ * transmit buffer, the CPU priority is raised to UART_TX_IPL so they don't 
+ * interrupt each other. The audio output interrupt still runs.
+ * @return Returns the CPU status to restore.
+ */
+UINT32 UART_LockTx(void)
+{
+    UINT32 status = _CP0_GET_STATUS();
+    
+    if(((status & _CP0_STATUS_IPL_MASK) >> _CP0_STATUS_IPL_POSITION) < UART_TX_IPL)
+    {
+        _CP0_SET_STATUS((status & ~_CP0_STATUS_IPL_MASK) | (UART_TX_IPL << _CP0_STATUS_IPL_POSITION));
+    }
+    return status;
+}
+
+/**
+ * @brief Unlocks the transmit buffer.
+ * @arg status The CPU status returned by UART_LockTx.
+ * @return Void.
+ */
+void UART_UnlockTx(UINT32 status)
+{
+    _CP0_SET_STATUS(status);
+}
+
 /**
  * @brief Changes character to undercase.
  * @details Changes character to undercase.
@@ -438,7 +592,7 @@ COMMANDS MON_getCommand(const char* cmdName)
  * @details The UART1 interrupt service routine will handle receiving data. If
  * data is received, the data is pushed into a FIFO queue for later processing. 
  * If data is received is a return key, the received data has ended and the 
- * command is ready flag is set. 
+ * command is counted for the monitor task. 
  * @return Void.
  */
 void __ISR(_UART1_VECTOR, IPL2AUTO) IntUart1Handler(void)
@@ -456,7 +610,15 @@ void __ISR(_UART1_VECTOR, IPL2AUTO) IntUart1Handler(void)
         else
         {
             /* Checks if there is data ready to read from the receive buffer. */
-            if(U1STAbits.URXDA == 1)
+            if(U1STAbits.URXDA == 1 && UPLOAD_IsActive())
+            {
+                // Passes every received BYTE to the upload.
+                while(U1STAbits.URXDA == 1)
+                {
+                    UPLOAD_ReceiveByte(U1RXREG);
+                }
+            }
+            else if(U1STAbits.URXDA == 1)
             {
                 // Reads BYTEs from receive buffer.
                 BYTE rxData = U1RXREG;
@@ -464,11 +626,10 @@ void __ISR(_UART1_VECTOR, IPL2AUTO) IntUart1Handler(void)
                 // Writes data to receive buffer.
                 UART_putNextChar(&rxBuffer, rxData);
                 
-                // Sets a flag for end of receiving a command.
+                // Counts the end of receiving a command.
                 if(rxData == '\r')
                 {
-                    cmdReady = TRUE;
-                    UART_processCommand();
+                    cmdsReceived++;
                 }
             }
         }
@@ -489,12 +650,15 @@ void __ISR(_UART1_VECTOR, IPL2AUTO) IntUart1Handler(void)
         }
         else
         {
-            /* Checks if there is data ready to read from the receive buffer. */
-            if(!U1STAbits.UTXBF && !UART_isBufferEmpty(&txBuffer))
+            /* Fills the transmit FIFO of the UART from the transmit buffer. */
+            const BYTE* txData = NULL;
+            UINT16 span = FIFO_PeekRead(&txBuffer, &txData);
+            UINT16 sent = 0;
+            while(sent < span && !U1STAbits.UTXBF)
             {
-                BYTE txData = UART_getNextChar(&txBuffer);
-                U1TXREG = txData;
+                U1TXREG = txData[sent++];
             }
+            FIFO_CommitRead(&txBuffer, sent);
             /* Checks if the transmit buffer is empty. If so, disable the TX interrupt. */
             if(UART_isBufferEmpty(&txBuffer) && U1STAbits.TRMT)
             {
@@ -516,19 +680,23 @@ void __ISR(_UART1_VECTOR, IPL2AUTO) IntUart1Handler(void)
  * @arg ch The character to push into buffer.
  * @return Void.
  */
-void UART_putNextChar(MON_FIFO* buffer, char ch)
+void UART_putNextChar(FIFO* buffer, char ch)
 {
-    FIFO_MonPush(buffer, ch);
+    FIFO_Push(buffer, (BYTE)ch);
 }
 
 /**
  * @brief Pops a character from the buffer.
  * @arg buffer The buffer to pop the character from.
- * @return Returns the character that is popped off from the buffer.
+ * @return Returns the character that is popped off from the buffer, a return
+ * character if the buffer is empty so a command always ends.
  */
-char UART_getNextChar(MON_FIFO* buffer)
+char UART_getNextChar(FIFO* buffer)
 {
-    return FIFO_MonPop(buffer);
+    BYTE ch = '\r';
+    
+    FIFO_Pop(buffer, &ch);
+    return (char)ch;
 }
 
 /**
@@ -538,13 +706,9 @@ char UART_getNextChar(MON_FIFO* buffer)
  * @retval TRUE if the buffer is empty.
  * @retval FALSE if the buffer is not empty.
  */
-BOOL UART_isBufferEmpty(MON_FIFO* buffer)
+BOOL UART_isBufferEmpty(FIFO* buffer)
 {
-    if(buffer->bufferSize > 0)
-    {
-        return FALSE;
-    }
-    return TRUE;
+    return FIFO_IsEmpty(buffer);
 }
 
 /**
@@ -659,6 +823,8 @@ void MON_TestDAC(void)
     {
         value = 0;
     }
+    // Stops the audio output, its interrupt preempts the monitor.
+    TIMER3_ON(FALSE);
     DAC_WriteToDAC(WRITE_UPDATE_CHN_A_B, value);
 }
 
@@ -668,6 +834,8 @@ void MON_TestDAC(void)
  */
 void MON_ZeroDAC(void)
 {
+    // Stops the audio output, its interrupt preempts the monitor.
+    TIMER3_ON(FALSE);
     DAC_ZeroOutput();
 }
 
@@ -810,6 +978,8 @@ void MON_SinDAC(void)
     UINT16 audioByte;
     UINT16 unsign_audio;
     
+    // Stops the audio output, its interrupt preempts the monitor.
+    TIMER3_ON(FALSE);
     for(j = 0; j < 100; j++)
     {
         for(i = 0; i < 1024; i++)
@@ -840,7 +1010,7 @@ void MON_Timer_ON_OFF(void)
     else
     {
         TIMER3_ON(FALSE);
-        AUDIO_setNewTone(0, 1);
+        AUDIO_setNewTone(0, 1, FALSE);
     }
 }
 
@@ -870,3 +1040,356 @@ void MON_Timer_Set_PS(void)
     snprintf(&buf[0] ,32 ,"The period set to: %d", prd);
     MON_SendString(&buf[0]);
 }
+
+/**
+ * @brief Command used to display the strum detector statistics.
+ * @return Void.
+ */
+void MON_Strum_Stats(void)
+{
+    ADC_ShowStrumStats();
+}
+
+/**
+ * @brief Command used to start capturing the raw samples of a string.
+ * @return Void.
+ */
+void MON_Capture_Start(void)
+{
+    char buf[32];
+    int string = atoi(cmdStr.arg1);
+    
+    if(string < 0 || string > 3)
+    {
+        MON_SendString("Invalid string. MIN: 0, MAX: 3.");
+        return;
+    }
+    
+    if(CAPTURE_Start(string))
+    {
+        snprintf(&buf[0] ,32 ,"Capturing string: %d", string);
+        MON_SendString(&buf[0]);
+    }
+}
+
+/**
+ * @brief Command used to send the captured samples.
+ * @return Void.
+ */
+void MON_Capture_Dump(void)
+{
+    CAPTURE_Dump();
+}
+
+/**
+ * @brief Command used to replay the captured samples through the strum detector.
+ * @return Void.
+ */
+void MON_Capture_Replay(void)
+{
+    CAPTURE_Replay();
+}
+
+/**
+ * @brief Command used to display the strum to sound latency statistics.
+ * @return Void.
+ */
+void MON_Latency_Stats(void)
+{
+    UINT16 reset = atoi(cmdStr.arg1);
+    
+    LATENCY_ShowStats();
+    if(reset == 1)
+    {
+        LATENCY_Init();
+        MON_SendString("The latency statistics have been cleared.");
+    }
+}
+
+/**
+ * @brief Command used to display the audio interrupt timing.
+ * @return Void.
+ */
+void MON_Jitter_Stats(void)
+{
+    UINT16 reset = atoi(cmdStr.arg1);
+    
+    TIMER3_ShowJitter(reset == 1);
+    JITTER_ShowStats(reset == 1);
+    if(reset == 1)
+    {
+        MON_SendString("The audio interrupt timing has been cleared.");
+    }
+}
+
+/**
+ * @brief Command used to display the fret prefetch statistics.
+ * @return Void.
+ */
+void MON_Prefetch_Stats(void)
+{
+    UINT16 reset = atoi(cmdStr.arg1);
+    
+    AUDIO_ShowPrefetch(reset == 1);
+    if(reset == 1)
+    {
+        MON_SendString("The prefetch statistics have been cleared.");
+    }
+}
+
+/**
+ * @brief Command used to display the audio block statistics.
+ * @return Void.
+ */
+void MON_Block_Stats(void)
+{
+    UINT16 reset = atoi(cmdStr.arg1);
+    
+    AUDIO_ShowBlocks(reset == 1);
+    if(reset == 1)
+    {
+        MON_SendString("The block statistics have been cleared.");
+    }
+}
+
+/**
+ * @brief Command used to display the main loop task statistics.
+ * @return Void.
+ */
+void MON_Sched_Stats(void)
+{
+    UINT16 reset = atoi(cmdStr.arg1);
+    UINT16 telemetry = atoi(cmdStr.arg2);
+    
+    SCHED_ShowStats(reset == 1);
+    SCHED_SetTelemetry(telemetry == 1);
+    if(reset == 1)
+    {
+        MON_SendString("The task statistics have been cleared.");
+    }
+}
+
+/**
+ * @brief Command used to display the SD card statistics.
+ * @details An injected fault is recovered from like a card error, the recovery
+ * time is displayed by the next CARD command.
+ * @return Void.
+ */
+void MON_Card_Stats(void)
+{
+    UINT16 reset = atoi(cmdStr.arg1);
+    UINT16 fault = atoi(cmdStr.arg2);
+    
+    AUDIO_ShowCard(reset == 1);
+    if(reset == 1)
+    {
+        MON_SendString("The card statistics have been cleared.");
+    }
+    if(fault == 1)
+    {
+        FILES_SetCardFault();
+        MON_SendString("A card fault has been injected.");
+    }
+}
+
+/**
+ * @brief Command used to display the finger position of a string.
+ * @return Void.
+ */
+void MON_Fret_Stats(void)
+{
+    int string = atoi(cmdStr.arg1);
+    UINT16 reset = atoi(cmdStr.arg2);
+    
+    if(string < 0 || string >= FRET_NUM_OF_STRINGS)
+    {
+        MON_SendString("Invalid string. MIN: 0, MAX: 3.");
+        return;
+    }
+    
+    FRET_ShowStats(string, reset == 1);
+    if(reset == 1)
+    {
+        MON_SendString("The fret calibration has been cleared.");
+    }
+}
+
+/**
+ * @brief Command used to calibrate a fret of a string.
+ * @return Void.
+ */
+void MON_Fret_Calibrate(void)
+{
+    char buf[48];
+    int string = atoi(cmdStr.arg1);
+    int fret = atoi(cmdStr.arg2);
+    
+    if(string < 0 || string >= FRET_NUM_OF_STRINGS)
+    {
+        MON_SendString("Invalid string. MIN: 0, MAX: 3.");
+        return;
+    }
+    if(fret < 0 || fret > FRET_NUM_OF_FRETS)
+    {
+        MON_SendString("Invalid fret. MIN: 0, MAX: 20.");
+        return;
+    }
+    
+    if(FRET_Calibrate(string, fret))
+    {
+        snprintf(&buf[0], 48, "String %d, fret %d calibrated.", string, fret);
+    }
+    else
+    {
+        snprintf(&buf[0], 48, "String %d isn't pressed.", string);
+    }
+    MON_SendString(&buf[0]);
+}
+
+/**
+ * @brief Command used to display the read-ahead statistics.
+ * @return Void.
+ */
+void MON_Readahead_Stats(void)
+{
+    UINT16 reset = atoi(cmdStr.arg1);
+    
+    READAHEAD_ShowStats(reset == 1);
+    if(reset == 1)
+    {
+        MON_SendString("The read-ahead statistics have been cleared.");
+    }
+}
+
+/**
+ * @brief Command used to display the monitor buffer statistics.
+ * @return Void.
+ */
+void MON_Fifo_Stats(void)
+{
+    UINT16 reset = atoi(cmdStr.arg1);
+    char buf[80];
+    
+    snprintf(&buf[0], 80, "RX: %u queued, %u dropped. TX: %u queued, %u dropped.", FIFO_GetCount(&rxBuffer),
+            FIFO_GetDrops(&rxBuffer), FIFO_GetCount(&txBuffer), FIFO_GetDrops(&txBuffer));
+    MON_SendString(&buf[0]);
+    UART_BenchmarkFifo();
+    if(reset == 1)
+    {
+        FIFO_ClearDrops(&rxBuffer);
+        FIFO_ClearDrops(&txBuffer);
+        MON_SendString("The monitor buffer drops have been cleared.");
+    }
+}
+
+/**
+ * @brief Benchmarks the FIFO queue.
+ * @details Moves the same bytes through a scratch queue one byte at a time and
+ * in bulk copies, and displays the cost per byte of each.
+ * @return Void.
+ */
+void UART_BenchmarkFifo(void)
+{
+    static BYTE storage[MON_BUFFERSIZE];
+    BYTE chunk[UART_BENCHMARK_CHUNK];
+    FIFO fifo;
+    UINT32 startTicks, byteTicks, bulkTicks;
+    UINT32 i = 0, j = 0;
+    char buf[80];
+    
+    FIFO_Init(&fifo, &storage[0], MON_BUFFERSIZE);
+    memset(&chunk[0], 0x55, sizeof(chunk));
+    
+    startTicks = TIMER_GetCoreTicks();
+    for(i = 0; i < UART_BENCHMARK_BYTES; i += UART_BENCHMARK_CHUNK)
+    {
+        for(j = 0; j < UART_BENCHMARK_CHUNK; j++)
+        {
+            FIFO_Push(&fifo, chunk[j]);
+        }
+        for(j = 0; j < UART_BENCHMARK_CHUNK; j++)
+        {
+            FIFO_Pop(&fifo, &chunk[j]);
+        }
+    }
+    byteTicks = TIMER_GetCoreTicks() - startTicks;
+    
+    startTicks = TIMER_GetCoreTicks();
+    for(i = 0; i < UART_BENCHMARK_BYTES; i += UART_BENCHMARK_CHUNK)
+    {
+        FIFO_Write(&fifo, &chunk[0], UART_BENCHMARK_CHUNK);
+        FIFO_Read(&fifo, &chunk[0], UART_BENCHMARK_CHUNK);
+    }
+    bulkTicks = TIMER_GetCoreTicks() - startTicks;
+    
+    // The core timer ticks once every two system clocks, in hundredths of a cycle.
+    snprintf(&buf[0], 80, "Push/pop: %u.%02u cycles/byte, bulk: %u.%02u cycles/byte", 
+            (byteTicks*2)/UART_BENCHMARK_BYTES, ((byteTicks*200)/UART_BENCHMARK_BYTES)%100,
+            (bulkTicks*2)/UART_BENCHMARK_BYTES, ((bulkTicks*200)/UART_BENCHMARK_BYTES)%100);
+    MON_SendString(&buf[0]);
+}
+
+/**
+ * @brief Command used to benchmark the resampler.
+ * @return Void.
+ */
+void MON_Resample_Benchmark(void)
+{
+    AUDIO_BenchmarkResampler();
+}
+
+/**
+ * @brief Command used to benchmark the decoder.
+ * @return Void.
+ */
+void MON_Decode_Benchmark(void)
+{
+    AUDIO_BenchmarkDecode();
+}
+
+/**
+ * @brief Command used to set the slide mode.
+ * @return Void.
+ */
+void MON_Slide_Mode(void)
+{
+    UINT16 mode = atoi(cmdStr.arg1);
+    
+    if(mode == AUDIO_SLIDE_FRETTED)
+    {
+        AUDIO_SetSlideMode(AUDIO_SLIDE_FRETTED);
+        MON_SendString("Slide mode enabled.");
+    }
+    else if(mode == AUDIO_SLIDE_FRETLESS)
+    {
+        AUDIO_SetSlideMode(AUDIO_SLIDE_FRETLESS);
+        MON_SendString("Fretless mode enabled.");
+    }
+    else
+    {
+        AUDIO_SetSlideMode(AUDIO_SLIDE_OFF);
+        MON_SendString("Slide mode disabled.");
+    }
+}
+
+/**
+ * @brief Command used to upload a sample pack.
+ * @details The upload starts once this command's reply has been sent. See the
+ * UPLOAD module for the frame format.
+ * @return Void.
+ */
+void MON_Upload(void)
+{
+    UINT32 sectors = atoi(cmdStr.arg1);
+    char buf[64];
+    
+    if(UPLOAD_Start(sectors))
+    {
+        snprintf(&buf[0], 64, "UPLOAD READY %u %u", sectors, UPLOAD_BAUDRATE);
+        MON_SendString(&buf[0]);
+    }
+    else
+    {
+        MON_SendString("Failed to start the upload. The sample pack must be contiguous and hold all the sectors.");
+    }
+}
\ No newline at end of file
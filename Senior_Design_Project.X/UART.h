@@ -11,6 +11,10 @@
 extern "C" {
 #endif
 
+/** @def DESIRED_BAUDRATE 
+ * The desired UART baud rate. */
+#define DESIRED_BAUDRATE        (19200)     //The desired BaudRate
+
 /**
  * @brief COMMANDS data structure.
  * @details The COMMANDS data structure is used to store a command with its 
@@ -43,6 +47,8 @@ typedef struct COMMANDSTR
 
 void UART_Init(void);
 void UART_Process(void);
+BOOL UART_IsCommandReady(void);
+void UART_SetBaudRate(int desireBaud);
 
 /* String Helper Functions. */
 void MON_removeWhiteSpace(const char* string);
@@ -54,6 +60,7 @@ char MON_lowerToUpper(const char* ch);
 void MON_SendStringNR(const char* str);
 void MON_SendString(const char* str);
 void MON_SendChar(const char* character);
+UINT16 MON_GetTxFree(void);
 
 #ifdef	__cplusplus
 }
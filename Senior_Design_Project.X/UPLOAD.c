@@ -0,0 +1,450 @@
+/**
+ * @file UPLOAD.c
+ * @author Kue Yang
+ * @date 10/19/2026
+ * @details The UPLOAD module writes a new sample pack to the card over UART so
+ * the card doesn't have to be removed from the instrument. The pack is written
+ * over the sectors of the existing contiguous pack, so the file system stays
+ * read only. The host sends frames of a 16-bit sequence number,
+ * UPLOAD_BLOCK_SIZE data bytes and a CRC-16/CCITT of the sequence number and
+ * data, all little endian. The last frame is padded to a whole frame. Each frame
+ * is answered with UPLOAD_ACK to request the next frame or UPLOAD_NAK to request
+ * it again. Frames are received into one buffer while the other is written to
+ * the card with a multi-block write, so the UART runs close to line rate. Once
+ * every sector is written, the sectors are read back and their CRC-32 is
+ * reported so the host can verify the upload.
+ * @remarks Audio playback is stopped while a pack is uploaded.
+ */
+
+#include <p32xxxx.h>
+#include <stdio.h>
+#include "HardwareProfile.h"
+#include "STDDEF.h"
+#include "./fatfs/diskio.h"
+#include "TIMER.h"
+#include "PACKDEF.h"
+#include "FILES.h"
+#include "AUDIO.h"
+#include "UART.h"
+#include "UPLOAD.h"
+
+/** @def UPLOAD_IDLE
+ * Defines the state where no upload is running. */
+#define UPLOAD_IDLE             0
+/** @def UPLOAD_STARTING
+ * Defines the state where the UART is switched to the upload baud rate. */
+#define UPLOAD_STARTING         1
+/** @def UPLOAD_RECEIVING
+ * Defines the state where frames are received and written to the card. */
+#define UPLOAD_RECEIVING        2
+/** @def UPLOAD_FRAME_SIZE
+ * Defines the size of a frame, the sequence number, data and CRC. */
+#define UPLOAD_FRAME_SIZE       (2 + UPLOAD_BLOCK_SIZE + 2)
+/** @def UPLOAD_BLOCK_SECTORS
+ * Defines the number of sectors in a frame. */
+#define UPLOAD_BLOCK_SECTORS    (UPLOAD_BLOCK_SIZE/PACK_SECTOR_SIZE)
+/** @def UPLOAD_FRAME_TIMEOUT
+ * Defines the time without a byte after which a partial frame is dropped. */
+#define UPLOAD_FRAME_TIMEOUT    (50*TIMER_TICKS_PER_MS)
+/** @def UPLOAD_ABORT_TIMEOUT
+ * Defines the time without a byte after which the upload is abandoned. */
+#define UPLOAD_ABORT_TIMEOUT    (5000*TIMER_TICKS_PER_MS)
+
+/**
+ * @brief UPLOAD_BUFFER data structure.
+ * @details The UPLOAD_BUFFER data structure stores a received frame until it
+ * has been written to the card.
+ */
+typedef struct UPLOAD_BUFFER
+{
+    /**@{*/
+    BYTE data[UPLOAD_BLOCK_SIZE];   /**< Variable used to store the frame data. */
+    volatile BOOL isFull;           /**< Variable used to store if the data waits to be written. */
+    /**@}*/
+}UPLOAD_BUFFER;
+
+/** @var uploadState
+ * The state of the upload. */
+volatile UINT8 uploadState;
+/** @var uploadBuffers
+ * The frame buffers, one is received while the other is written. */
+UPLOAD_BUFFER uploadBuffers[2];
+/** @var rxIndex
+ * The buffer the current frame is received into. */
+volatile UINT8 rxIndex;
+/** @var writeIndex
+ * The buffer that is written to the card next. */
+UINT8 writeIndex;
+/** @var rxCount
+ * The number of bytes received of the current frame. */
+volatile UINT16 rxCount;
+/** @var rxSequence
+ * The sequence number of the current frame. */
+volatile UINT16 rxSequence;
+/** @var rxCrc
+ * The CRC received with the current frame. */
+volatile UINT16 rxCrc;
+/** @var crc
+ * The CRC calculated over the current frame. */
+volatile UINT16 crc;
+/** @var nextSequence
+ * The sequence number of the next frame to be accepted. */
+volatile UINT16 nextSequence;
+/** @var isAckPending
+ * Stores boolean indicating the next frame is requested once a buffer is free. */
+volatile BOOL isAckPending;
+/** @var lastByteTicks
+ * The core timer count when the last byte was received. */
+volatile UINT32 lastByteTicks;
+/** @var uploadRetries
+ * The number of frames requested again. */
+volatile UINT32 uploadRetries;
+/** @var uploadSector
+ * The first sector of the sample pack. */
+DWORD uploadSector;
+/** @var uploadSectors
+ * The number of sectors to upload. */
+UINT32 uploadSectors;
+/** @var sectorsWritten
+ * The number of sectors written to the card. */
+UINT32 sectorsWritten;
+/** @var uploadTicks
+ * The core timer count the upload time was last updated at. */
+UINT32 uploadTicks;
+/** @var uploadMs
+ * The time spent receiving and writing the upload in milliseconds. */
+UINT32 uploadMs;
+
+/** @var crc32Nibbles
+ * The CRC-32 of each nibble, used to calculate the CRC-32 a nibble at a time. */
+const UINT32 crc32Nibbles[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
+void UPLOAD_EndFrame(void);
+void UPLOAD_Reply(BYTE reply);
+void UPLOAD_Finish(BOOL isDone, const char* reason);
+UINT16 UPLOAD_UpdateCrc16(UINT16 crc, BYTE data);
+UINT32 UPLOAD_UpdateCrc32(UINT32 crc, const BYTE* data, UINT16 bytes);
+
+/**
+ * @brief Initializes the UPLOAD module.
+ * @return Void
+ */
+void UPLOAD_Init(void)
+{
+    uploadState = UPLOAD_IDLE;
+}
+
+/**
+ * @brief Starts uploading a sample pack.
+ * @details The upload starts from the main loop once the reply to the command
+ * has been sent at the monitor baud rate.
+ * @arg sectors The number of sectors to upload.
+ * @return Returns a boolean indicating if the upload has started.
+ * @retval TRUE if the upload has started.
+ * @retval FALSE if an upload is running or the pack is too small or fragmented.
+ */
+BOOL UPLOAD_Start(UINT32 sectors)
+{
+    if(uploadState != UPLOAD_IDLE || sectors == 0 || sectors > FILES_GetPackSectors())
+    {
+        return FALSE;
+    }
+
+    TIMER3_ON(FALSE);
+    uploadSector = FILES_GetPackSector();
+    uploadSectors = sectors;
+    uploadState = UPLOAD_STARTING;
+    return TRUE;
+}
+
+/**
+ * @brief Checks if a sample pack is being uploaded.
+ * @return Returns a boolean indicating if an upload is running.
+ */
+BOOL UPLOAD_IsActive(void)
+{
+    return (uploadState != UPLOAD_IDLE);
+}
+
+/**
+ * @brief Processes the upload.
+ * @details Called from the main loop. Writes the received frames to the card,
+ * drops partial frames that stopped arriving and abandons an upload the host
+ * stopped sending.
+ * @return Void
+ */
+void UPLOAD_Process(void)
+{
+    UPLOAD_BUFFER* buffer = &uploadBuffers[writeIndex];
+    UINT32 ticks = 0, sectors = 0;
+
+    if(uploadState == UPLOAD_STARTING)
+    {
+        UART_SetBaudRate(UPLOAD_BAUDRATE);
+        uploadBuffers[0].isFull = FALSE;
+        uploadBuffers[1].isFull = FALSE;
+        rxIndex = 0;
+        writeIndex = 0;
+        rxCount = 0;
+        nextSequence = 0;
+        isAckPending = FALSE;
+        uploadRetries = 0;
+        sectorsWritten = 0;
+        uploadMs = 0;
+        uploadTicks = TIMER_GetCoreTicks();
+        lastByteTicks = uploadTicks;
+        uploadState = UPLOAD_RECEIVING;
+        UPLOAD_Reply(UPLOAD_ACK);
+        return;
+    }
+    if(uploadState != UPLOAD_RECEIVING)
+    {
+        return;
+    }
+
+    // Keeps the upload time in milliseconds so long uploads don't overflow.
+    ticks = TIMER_GetCoreTicks();
+    uploadMs += (ticks - uploadTicks)/TIMER_TICKS_PER_MS;
+    uploadTicks += ((ticks - uploadTicks)/TIMER_TICKS_PER_MS)*TIMER_TICKS_PER_MS;
+
+    if(buffer->isFull)
+    {
+        sectors = uploadSectors - sectorsWritten;
+        if(sectors > UPLOAD_BLOCK_SECTORS)
+        {
+            sectors = UPLOAD_BLOCK_SECTORS;
+        }
+        if(disk_write(0, &buffer->data[0], uploadSector + sectorsWritten, sectors) != RES_OK)
+        {
+            UPLOAD_Finish(FALSE, "SD write failed");
+            return;
+        }
+        sectorsWritten += sectors;
+        writeIndex ^= 1;
+
+        // Requests the next frame if it was held back for this buffer.
+        IEC1bits.U1RXIE = 0;
+        buffer->isFull = FALSE;
+        if(isAckPending)
+        {
+            isAckPending = FALSE;
+            UPLOAD_Reply(UPLOAD_ACK);
+        }
+        IEC1bits.U1RXIE = 1;
+
+        if(sectorsWritten >= uploadSectors)
+        {
+            UPLOAD_Finish(TRUE, NULL);
+        }
+        return;
+    }
+
+    // Drops a partial frame so the host can send it again.
+    ticks -= lastByteTicks;
+    IEC1bits.U1RXIE = 0;
+    if(rxCount > 0 && ticks > UPLOAD_FRAME_TIMEOUT)
+    {
+        rxCount = 0;
+        uploadRetries++;
+        UPLOAD_Reply(UPLOAD_NAK);
+    }
+    IEC1bits.U1RXIE = 1;
+
+    if(ticks > UPLOAD_ABORT_TIMEOUT)
+    {
+        UPLOAD_Finish(FALSE, "Timed out");
+    }
+}
+
+/**
+ * @brief Receives a byte of the upload.
+ * @details Called by the UART receive interrupt while an upload is running.
+ * @arg data The byte received.
+ * @return Void
+ */
+void UPLOAD_ReceiveByte(BYTE data)
+{
+    UPLOAD_BUFFER* buffer = &uploadBuffers[rxIndex];
+
+    if(uploadState != UPLOAD_RECEIVING)
+    {
+        return;
+    }
+
+    lastByteTicks = TIMER_GetCoreTicks();
+    if(rxCount == 0)
+    {
+        crc = 0xFFFF;
+        rxSequence = 0;
+        rxCrc = 0;
+    }
+
+    if(rxCount < 2)
+    {
+        rxSequence |= (UINT16)data << (8*rxCount);
+        crc = UPLOAD_UpdateCrc16(crc, data);
+    }
+    else if(rxCount < 2 + UPLOAD_BLOCK_SIZE)
+    {
+        if(!buffer->isFull)
+        {
+            buffer->data[rxCount - 2] = data;
+        }
+        crc = UPLOAD_UpdateCrc16(crc, data);
+    }
+    else
+    {
+        rxCrc |= (UINT16)data << (8*(rxCount - 2 - UPLOAD_BLOCK_SIZE));
+    }
+
+    if(++rxCount == UPLOAD_FRAME_SIZE)
+    {
+        rxCount = 0;
+        UPLOAD_EndFrame();
+    }
+}
+
+/**
+ * @brief Accepts or rejects a received frame.
+ * @details A frame that was already accepted is acknowledged again since the
+ * host missed the acknowledgement. The next frame is requested once the other
+ * buffer has been written.
+ * @return Void
+ */
+void UPLOAD_EndFrame(void)
+{
+    if(rxCrc != crc || uploadBuffers[rxIndex].isFull)
+    {
+        uploadRetries++;
+        UPLOAD_Reply(UPLOAD_NAK);
+    }
+    else if(nextSequence > 0 && rxSequence == (UINT16)(nextSequence - 1))
+    {
+        UPLOAD_Reply(UPLOAD_ACK);
+    }
+    else if(rxSequence != nextSequence)
+    {
+        uploadRetries++;
+        UPLOAD_Reply(UPLOAD_NAK);
+    }
+    else
+    {
+        uploadBuffers[rxIndex].isFull = TRUE;
+        rxIndex ^= 1;
+        nextSequence++;
+        if(uploadBuffers[rxIndex].isFull)
+        {
+            isAckPending = TRUE;
+        }
+        else
+        {
+            UPLOAD_Reply(UPLOAD_ACK);
+        }
+    }
+}
+
+/**
+ * @brief Sends a reply byte to the host.
+ * @arg reply The reply, UPLOAD_ACK or UPLOAD_NAK.
+ * @return Void
+ */
+void UPLOAD_Reply(BYTE reply)
+{
+    MON_SendChar((const char*)&reply);
+}
+
+/**
+ * @brief Ends the upload.
+ * @details Returns the UART to the monitor baud rate and reports the result.
+ * A finished upload is read back to calculate its CRC-32 and the new sample pack
+ * is loaded.
+ * @arg isDone Stores boolean indicating every sector has been written.
+ * @arg reason The reason the upload failed.
+ * @return Void
+ */
+void UPLOAD_Finish(BOOL isDone, const char* reason)
+{
+    char buf[128];
+    UINT32 crc32 = 0xFFFFFFFF, sector = 0, sectors = 0, bytesPerSecond = 0;
+
+    uploadState = UPLOAD_IDLE;
+
+    // Verifies the sectors that have been written.
+    while(isDone && sector < uploadSectors)
+    {
+        CLEAR_WATCHDOG_TIMER;
+        sectors = uploadSectors - sector;
+        if(sectors > UPLOAD_BLOCK_SECTORS)
+        {
+            sectors = UPLOAD_BLOCK_SECTORS;
+        }
+        if(disk_read(0, &uploadBuffers[0].data[0], uploadSector + sector, sectors) != RES_OK)
+        {
+            isDone = FALSE;
+            reason = "SD read back failed";
+        }
+        crc32 = UPLOAD_UpdateCrc32(crc32, &uploadBuffers[0].data[0], sectors*PACK_SECTOR_SIZE);
+        sector += sectors;
+    }
+
+    UART_SetBaudRate(DESIRED_BAUDRATE);
+
+    if(isDone)
+    {
+        if(uploadMs > 0)
+        {
+            // Multiplies first in 64 bits, a pack over 8 MB overflows 32 bits.
+            bytesPerSecond = (UINT32)(((UINT64)sectorsWritten*PACK_SECTOR_SIZE*1000)/uploadMs);
+        }
+        snprintf(&buf[0], 128, "UPLOAD DONE %u sectors, %u ms, %u B/s, %u%% of line rate, %u retries, CRC32 %08X",
+                sectorsWritten, uploadMs, bytesPerSecond, (bytesPerSecond*100)/(UPLOAD_BAUDRATE/10),
+                uploadRetries, crc32 ^ 0xFFFFFFFF);
+        MON_SendString(&buf[0]);
+        AUDIO_LoadPack();
+    }
+    else
+    {
+        snprintf(&buf[0], 128, "UPLOAD FAILED %s after %u sectors, %u retries", reason, sectorsWritten, uploadRetries);
+        MON_SendString(&buf[0]);
+    }
+    MON_SendString(">");
+}
+
+/**
+ * @brief Adds a byte to a CRC-16/CCITT.
+ * @arg crc The CRC of the previous bytes.
+ * @arg data The byte.
+ * @return Returns the new CRC.
+ */
+UINT16 UPLOAD_UpdateCrc16(UINT16 crc, BYTE data)
+{
+    int i = 0;
+
+    crc ^= (UINT16)data << 8;
+    for(i = 0; i < 8; i++)
+    {
+        crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+    }
+    return crc;
+}
+
+/**
+ * @brief Adds bytes to a CRC-32.
+ * @arg crc The CRC of the previous bytes.
+ * @arg data The bytes.
+ * @arg bytes The number of bytes.
+ * @return Returns the new CRC.
+ */
+UINT32 UPLOAD_UpdateCrc32(UINT32 crc, const BYTE* data, UINT16 bytes)
+{
+    while(bytes-- > 0)
+    {
+        crc ^= *data++;
+        crc = (crc >> 4) ^ crc32Nibbles[crc & 0x0F];
+        crc = (crc >> 4) ^ crc32Nibbles[crc & 0x0F];
+    }
+    return crc;
+}
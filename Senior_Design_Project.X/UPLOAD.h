@@ -0,0 +1,40 @@
+/**
+ * @file UPLOAD.h
+ * @author Kue Yang
+ * @date 10/19/2026
+ */
+
+#ifndef UPLOAD_H
+#define	UPLOAD_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include "STDDEF.h"
+
+/** @def UPLOAD_BAUDRATE
+ * Defines the UART baud rate used while a sample pack is uploaded. */
+#define UPLOAD_BAUDRATE         460800
+/** @def UPLOAD_BLOCK_SIZE
+ * Defines the data bytes in a frame, four sectors. */
+#define UPLOAD_BLOCK_SIZE       2048
+/** @def UPLOAD_ACK
+ * Defines the byte sent to request the next frame. */
+#define UPLOAD_ACK              0x06
+/** @def UPLOAD_NAK
+ * Defines the byte sent to request the frame again. */
+#define UPLOAD_NAK              0x15
+
+void UPLOAD_Init(void);
+BOOL UPLOAD_Start(UINT32 sectors);
+void UPLOAD_Process(void);
+void UPLOAD_ReceiveByte(BYTE data);
+BOOL UPLOAD_IsActive(void);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* UPLOAD_H */
+
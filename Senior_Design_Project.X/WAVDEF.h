@@ -57,6 +57,22 @@ extern "C" {
 /** @def WAV_DATA 
  * Defines the index of the WAV data. */
 #define WAV_DATA                44
+
+/** @def WAV_CHUNK_HEADER_SIZE 
+ * Defines the size of a chunk ID and chunk size. */
+#define WAV_CHUNK_HEADER_SIZE   8
+/** @def WAV_SMPL_NUM_LOOPS 
+ * Defines the index of the number of loops within the smpl chunk data. */
+#define WAV_SMPL_NUM_LOOPS      28
+/** @def WAV_SMPL_LOOP_START 
+ * Defines the index of the first loop start within the smpl chunk data. */
+#define WAV_SMPL_LOOP_START     44
+/** @def WAV_SMPL_LOOP_END 
+ * Defines the index of the first loop end within the smpl chunk data. */
+#define WAV_SMPL_LOOP_END       48
+/** @def WAV_SMPL_SIZE 
+ * Defines the size of the smpl chunk data with one loop. */
+#define WAV_SMPL_SIZE           60
     
 /** @def WAV_SUCCESS 
  * Defines the success code when accessing a WAV header. */
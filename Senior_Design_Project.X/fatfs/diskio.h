@@ -33,12 +33,16 @@ typedef enum {
 
 
 DSTATUS disk_initialize (BYTE pdrv);
+DSTATUS disk_initialize_start (BYTE pdrv);
+DRESULT disk_initialize_poll (BYTE pdrv);
 DSTATUS disk_status (BYTE pdrv);
 DRESULT disk_read (BYTE pdrv, BYTE* buff, DWORD sector, UINT16 count);
+#if	_USE_WRITE
+DRESULT disk_write (BYTE pdrv, const BYTE* buff, DWORD sector, UINT16 count);
+#endif
 #if	_USE_IOCTL
 DRESULT disk_ioctl (BYTE pdrv, BYTE cmd, void* buff);
 #endif
-void disk_timerproc (void);
 
 
 /* Disk Status Bits (DSTATUS) */
@@ -13,14 +13,24 @@
 
 #include <p32xxxx.h>
 #include "diskio.h"
+#include "../HardwareProfile.h"
 #include "../SPI.h"
+#include "../TIMER.h"
 
 
 /* Socket controls  (Platform dependent) */
 #define CS_LOW()  _LATB7 = 0       /* MMC CS = L */
 #define CS_HIGH() _LATB7 = 1       /* MMC CS = H */
-#define CD	1//(!_RB8)                /* Card detected   (yes:true, no:false, default:true) */
-#define WP	(_RB10)                 /* Write protected (yes:true, no:false, default:false) */
+#if SD_CARD_DETECT
+#define CD	(_RB8 == SD_CARD_DETECT_LEVEL)	/* Card detected   (yes:true, no:false, default:true) */
+#else
+#define CD	1                       /* Card detected   (yes:true, no:false, default:true) */
+#endif
+#define WP	0                       /* Write protected (yes:true, no:false, default:false), micro SD has no switch */
+
+/* Timeouts on the core timer timebase */
+#define TIMEOUT(ms)	(TIMER_GetTicks() + (UINT64)(ms)*1000*TIMER_TICKS_PER_US)	/* Deadline ms from now */
+#define EXPIRED(t)	(TIMER_GetTicks() >= (t))	/* The deadline has passed */
 
 
 /*--------------------------------------------------------------------------
@@ -53,24 +63,30 @@
 static volatile
 DSTATUS Stat = STA_NOINIT;	/* Disk status */
 
-static volatile
-UINT16 Timer1, Timer2;		/* 1000Hz decrement timer */
+static
+UINT64 InitTimeout;		/* Deadline for the card to leave idle state */
 
 static
 UINT16 CardType;
 
+static
+BYTE InitType, InitCmd;		/* Card type and command used while the card leaves idle state */
+
+static
+DWORD InitArg;				/* Argument of the command used while the card leaves idle state */
+
 /*-----------------------------------------------------------------------*/
 /* Wait for card ready                                                   */
 /*-----------------------------------------------------------------------*/
 int wait_ready (void)
 {
 	BYTE d;
+	UINT64 timeout = TIMEOUT(500);  /* Wait for ready in timeout of 500ms */
 
-	Timer2 = 500;               /* Wait for ready in timeout of 500ms */
 	do
     {
 		d = SPI3_ReadWrite(0xFF);
-	}while ((d != 0xFF) && Timer2);
+	}while ((d != 0xFF) && !EXPIRED(timeout));
 
 	return ((d == 0xFF) ? 1 : 0);
 }
@@ -101,6 +117,26 @@ int select (void)	/* 1:Successful, 0:Timeout */
 	return 0;                   /* Timeout */
 }
 
+/*-----------------------------------------------------------------------*/
+/* Update socket status                                                  */
+/*-----------------------------------------------------------------------*/
+/* Reads the card detect and write protect switches when the status is   */
+/* used, there is no timer interrupt polling them.                       */
+void update_socket (void)
+{
+	BYTE s;
+
+	s = Stat;
+
+	if (WP) s |= STA_PROTECT;
+	else	s &= ~STA_PROTECT;
+
+	if (CD) s &= ~STA_NODISK;
+	else	s |= (STA_NODISK | STA_NOINIT);
+
+	Stat = s;
+}
+
 
 
 /*-----------------------------------------------------------------------*/
@@ -112,11 +148,11 @@ int select (void)	/* 1:Successful, 0:Timeout */
 int rcvr_datablock ( BYTE *buff, UINT16 btr	)
 {
 	BYTE token;
+	UINT64 timeout = TIMEOUT(100);  /* Wait for data packet in timeout of 100ms */
 
-	Timer1 = 100;
-	do {							/* Wait for data packet in timeout of 100ms */
+	do {
 		token = SPI3_ReadWrite(0xFF);
-	} while ((token == 0xFF) && Timer1);
+	} while ((token == 0xFF) && !EXPIRED(timeout));
 
 	if(token != 0xFE) 
     {
@@ -130,6 +166,39 @@ int rcvr_datablock ( BYTE *buff, UINT16 btr	)
 	return 1;						/* Return with success */
 }
 
+/*-----------------------------------------------------------------------*/
+/* Send a data packet to MMC                                             */
+/*-----------------------------------------------------------------------*/
+#if _USE_WRITE
+/* buff - 512 byte data block to be transmitted */
+/* token - Data/Stop token */
+/* 1:OK, 0:Failed */
+int xmit_datablock ( const BYTE *buff, BYTE token )
+{
+	BYTE resp;
+
+	if (!wait_ready()) 
+    {
+        return 0;
+    }
+
+	SPI3_ReadWrite(token);				/* Xmit data token */
+	if (token != 0xFD)                  /* Is data token */
+    {	
+		SPI3_MultiWrite(buff, 512);		/* Xmit the data block to the MMC */
+		SPI3_ReadWrite(0xFF);			/* CRC (Dummy) */
+		SPI3_ReadWrite(0xFF);
+		resp = SPI3_ReadWrite(0xFF);	/* Receive data response */
+		if ((resp & 0x1F) != 0x05)		/* If not accepted, return with error */
+        {
+			return 0;
+        }
+	}
+
+	return 1;
+}
+#endif
+
 /*-----------------------------------------------------------------------*/
 /* Send a command packet to MMC                                          */
 /*-----------------------------------------------------------------------*/
@@ -209,35 +278,66 @@ DSTATUS disk_status ( BYTE pdrv )
     {
         return STA_NOINIT;	/* Supports only single drive */
     }
+	update_socket();
 	return Stat;
 }
 
 /*-----------------------------------------------------------------------*/
 /* Initialize Disk Drive                                                 */
 /*-----------------------------------------------------------------------*/
+/* A card already brought up by disk_initialize_start/poll is left as    */
+/* it is, so mounting the volume doesn't put it back in idle state and   */
+/* wait for it again.                                                    */
 /* pdrv - Physical drive nmuber (0) */
 DSTATUS disk_initialize ( BYTE pdrv )
 {
-	BYTE n, cmd, ty, ocr[4];
+	if (pdrv != 0) 
+    {
+        return STA_NOINIT;                                          /* Supports only single drive */
+    }	
+	update_socket();
+	if (!(Stat & STA_NOINIT))
+    {
+        return Stat;                                                /* Already initialized */
+    }
+
+	disk_initialize_start(pdrv);
+	while (disk_initialize_poll(pdrv) == RES_NOTRDY);               /* Wait for leaving idle state */
 
+	return Stat;
+}
+
+/*-----------------------------------------------------------------------*/
+/* Start Initializing Disk Drive                                         */
+/*-----------------------------------------------------------------------*/
+/* Puts the card in idle state and finds its type. The card is left to   */
+/* leave idle state by disk_initialize_poll, so the caller isn't blocked */
+/* for the up to 1000 msec it may take.                                  */
+/* pdrv - Physical drive nmuber (0) */
+DSTATUS disk_initialize_start ( BYTE pdrv )
+{
+	BYTE n, ocr[4];
+
+	InitType = 0;
 	if (pdrv != 0) 
     {
         return STA_NOINIT;                                          /* Supports only single drive */
     }	
+	update_socket();
 	if (Stat & STA_NODISK){
         return Stat;                                                /* No card in the socket */
     }
 
+	Stat |= STA_NOINIT;                                             /* Not readable until initialized */
 	SPI3_Init(400000);                                              /* Initialize memory card interface at 400kHz. */
 	for (n = 10; n; n--) 
     {
         SPI3_ReadWrite(0xFF);                                       /* 80 dummy clocks */
     }	
 
-	ty = 0;
 	if (send_cmd(CMD0, 0) == 1)                                     /* Enter Idle state */
     {                                   
-		Timer1 = 1000;                                              /* Initialization timeout of 1000 msec */
+		InitTimeout = TIMEOUT(1000);                                /* Initialization timeout of 1000 msec */
 		if (send_cmd(CMD8, 0x1AA) == 1)                             /* SDv2? */
         {                           
 			for (n = 0; n < 4; n++) 
@@ -246,35 +346,83 @@ DSTATUS disk_initialize ( BYTE pdrv )
             }			
 			if (ocr[2] == 0x01 && ocr[3] == 0xAA)                   /* The card can work at vdd range of 2.7-3.6V */
             {				
-				while (Timer1 && send_cmd(ACMD41, 0x40000000));     /* Wait for leaving idle state (ACMD41 with HCS bit) */
-				if (Timer1 && send_cmd(CMD58, 0) == 0)              /* Check CCS bit in the OCR */
-                {			
-					for (n = 0; n < 4; n++) 
-                    {
-                        ocr[n] = SPI3_ReadWrite(0xFF);
-                    }
-					ty = (ocr[0] & 0x40) ? (CT_SD2|CT_BLOCK) : CT_SD2;/* SDv2 */
-				}
+				InitType = CT_SD2; InitCmd = ACMD41; InitArg = 0x40000000;  /* ACMD41 with HCS bit */
 			}
 		} 
         else 
         {                                                    /* SDv1 or MMCv3 */
 			if (send_cmd(ACMD41, 0) <= 1)
             {
-				ty = CT_SD1; cmd = ACMD41;                          /* SDv1 */
+				InitType = CT_SD1; InitCmd = ACMD41;                /* SDv1 */
 			} 
             else 
             {
-				ty = CT_MMC; cmd = CMD1;                            /* MMCv3 */
+				InitType = CT_MMC; InitCmd = CMD1;                  /* MMCv3 */
 			}
-            
-			while (Timer1 && send_cmd(cmd, 0));                     /* Wait for leaving idle state */
-			if (!Timer1 || send_cmd(CMD16, 512) != 0)               /* Set read/write block length to 512 */
+			InitArg = 0;
+		}
+	}
+	deselect();
+
+	if (!InitType)                          /* Function failed */ 
+    {
+		CardType = 0;
+		SPI3CONbits.ON = 0;                 /* Deinitialize interface */
+	}
+
+	return Stat;
+}
+
+/*-----------------------------------------------------------------------*/
+/* Poll Disk Drive Initialization                                        */
+/*-----------------------------------------------------------------------*/
+/* Sends the card one command to leave idle state.                       */
+/* pdrv - Physical drive nmuber (0) */
+/* RES_OK:Initialized, RES_NOTRDY:Still idle, RES_ERROR:Failed */
+DRESULT disk_initialize_poll ( BYTE pdrv )
+{
+	BYTE n, ty, ocr[4];
+
+	if (pdrv != 0) 
+    {
+        return RES_PARERR;                                          /* Supports only single drive */
+    }	
+	if (!InitType || (Stat & STA_NODISK))
+    {
+        InitType = 0;
+        return RES_ERROR;                                           /* Not started or card removed */
+    }
+
+	ty = InitType;
+	if (send_cmd(InitCmd, InitArg))                                 /* Still in idle state */
+    {
+		deselect();
+		if (!EXPIRED(InitTimeout))
+        {
+            return RES_NOTRDY;
+        }
+		ty = 0;                                                     /* Initialization timeout */
+	}
+	else if (ty == CT_SD2)
+    {
+		if (send_cmd(CMD58, 0) == 0)                                /* Check CCS bit in the OCR */
+        {			
+			for (n = 0; n < 4; n++) 
             {
-                ty = 0;
+                ocr[n] = SPI3_ReadWrite(0xFF);
             }
+			ty = (ocr[0] & 0x40) ? (CT_SD2|CT_BLOCK) : CT_SD2;      /* SDv2 */
 		}
+        else
+        {
+            ty = 0;
+        }
 	}
+	else if (send_cmd(CMD16, 512) != 0)                             /* Set read/write block length to 512 */
+    {
+        ty = 0;
+    }
+	InitType = 0;
 	CardType = ty;
 	deselect();
 
@@ -282,13 +430,11 @@ DSTATUS disk_initialize ( BYTE pdrv )
     {		
 		Stat &= ~STA_NOINIT;                /* Clear STA_NOINIT */
 		SPI3_Init(20000000);   
+		return RES_OK;
 	} 
-    else                                    /* Function failed */ 
-    {		
-		SPI3CONbits.ON = 0;                 /* Deinitialize interface */
-	}
 
-	return Stat;
+	SPI3CONbits.ON = 0;                     /* Deinitialize interface */
+	return RES_ERROR;
 }
 
 
@@ -306,6 +452,7 @@ DRESULT disk_read ( BYTE pdrv, BYTE *buff, DWORD sector, UINT16 count )
     {
         return RES_PARERR;
     }
+	update_socket();
 	if (Stat & STA_NOINIT)
     {
         return RES_NOTRDY;
@@ -339,6 +486,65 @@ DRESULT disk_read ( BYTE pdrv, BYTE *buff, DWORD sector, UINT16 count )
 	return (count ? RES_ERROR : RES_OK);
 }
 
+/*-----------------------------------------------------------------------*/
+/* Write Sector(s)                                                       */
+/*-----------------------------------------------------------------------*/
+/* pdrv - Physical drive nmuber (0) */
+/* buff - Pointer to the data to be written */
+/* sector - Start sector number (LBA) */
+/* count - Sector count (1..128) */
+#if _USE_WRITE
+DRESULT disk_write ( BYTE pdrv, const BYTE *buff, DWORD sector, UINT16 count )
+{
+	if (pdrv || !count) 
+    {
+        return RES_PARERR;
+    }
+	if (Stat & STA_NOINIT) 
+    {
+        return RES_NOTRDY;
+    }
+	if (Stat & STA_PROTECT) 
+    {
+        return RES_WRPRT;
+    }
+
+	if (!(CardType & CT_BLOCK)) 
+    {
+        sector *= 512;	/* Convert to byte address if needed */
+    }
+
+	if (count == 1) {                       /* Single block write */
+		if ((send_cmd(CMD24, sector) == 0)	/* WRITE_BLOCK */
+			&& xmit_datablock(buff, 0xFE))
+			count = 0;
+	}
+	else {                                  /* Multiple block write */
+		if (CardType & CT_SDC) 
+        {
+            send_cmd(ACMD23, count);        /* Pre-erase the blocks */
+        }
+		if (send_cmd(CMD25, sector) == 0)   /* WRITE_MULTIPLE_BLOCK */
+        {	
+			do {
+				if (!xmit_datablock(buff, 0xFC)) 
+                {
+                    break;
+                }
+				buff += 512;
+			} while (--count);
+			if (!xmit_datablock(0, 0xFD))	/* STOP_TRAN token */
+            {
+				count = 1;
+            }
+		}
+	}
+	deselect();
+
+	return (count ? RES_ERROR : RES_OK);
+}
+#endif
+
 /*-----------------------------------------------------------------------*/
 /* Miscellaneous Functions                                               */
 /*-----------------------------------------------------------------------*/
@@ -448,31 +654,3 @@ DRESULT disk_ioctl (
 	return res;
 }
 #endif
-
-/*-----------------------------------------------------------------------*/
-/* Device Timer Driven Procedure                                         */
-/*-----------------------------------------------------------------------*/
-/* This function must be called by timer interrupt in period of 1ms      */
-void disk_timerproc (void)
-{
-	BYTE s;
-	UINT16 n;
-
-	n = Timer1;					/* 1000Hz decrement timer with zero stopped */
-	if (n) Timer1 = --n;
-	n = Timer2;
-	if (n) Timer2 = --n;
-
-
-	/* Update socket status */
-	s = Stat;
-
-	if (WP) s |= STA_PROTECT;
-	else	s &= ~STA_PROTECT;
-
-	if (CD) s &= ~STA_NODISK;
-	else	s |= (STA_NODISK | STA_NOINIT);
-
-	Stat = s;
-}
-
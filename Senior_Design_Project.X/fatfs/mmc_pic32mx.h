@@ -16,8 +16,10 @@ extern "C" {
     
 DSTATUS disk_status ( BYTE pdrv );
 DSTATUS disk_initialize ( BYTE pdrv );
+DSTATUS disk_initialize_start ( BYTE pdrv );
+DRESULT disk_initialize_poll ( BYTE pdrv );
 DRESULT disk_read ( BYTE pdrv, BYTE *buff, DWORD sector, UINT16 count );
-void disk_timerproc (void);
+DRESULT disk_write ( BYTE pdrv, const BYTE *buff, DWORD sector, UINT16 count );
 
 
 #ifdef	__cplusplus
@@ -0,0 +1,159 @@
+/**
+ * @file capture_replay.c
+ * @author Kue Yang
+ * @date 10/19/2026
+ * @details Runs the firmware's CAPTURE module, built unchanged with the capture
+ * ring, on the host. A trace is fed into the capture ring the way the ADC 
+ * interrupt does and then replayed, or dumped, by calling the capture task 
+ * until it is done. The replay output of the firmware is printed along with 
+ * the number of capture task runs and how long each took. The reference 
+ * strums of the trace stand in for the live detector's strums.
+ * @remarks Host tool, not part of the firmware build.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "STDDEF.h"
+#include "TIMER.h"
+#include "UART.h"
+#include "CAPTURE.h"
+#include "trace.h"
+
+/** @def REPLAY_MAX_BLOCK
+ * Defines the largest number of scans per ADC interrupt. */
+#define REPLAY_MAX_BLOCK        255
+
+/**
+ * @brief Returns the host time in ns.
+ * @return Returns the monotonic clock in ns.
+ */
+static long long REPLAY_GetNs(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec*1000000000LL + now.tv_nsec;
+}
+
+/**
+ * @brief Stands in for the core timer count.
+ * @details The firmware counts two cycles per core timer tick, so half the TSC
+ * makes the replay report TSC cycles. Without a TSC the count runs at the core
+ * timer rate.
+ * @return Returns the core timer count.
+ */
+UINT32 TIMER_GetCoreTicks(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return (UINT32)(__rdtsc() >> 1);
+#else
+    return (UINT32)((REPLAY_GetNs()*TIMER_TICKS_PER_US)/1000);
+#endif
+}
+
+/**
+ * @brief Stands in for sending a line to the monitor.
+ * @arg str The line to send.
+ * @return Void
+ */
+void MON_SendString(const char* str)
+{
+    printf("%s\n", str);
+}
+
+/**
+ * @brief Stands in for the free room of the monitor transmit buffer.
+ * @return Returns the free room, the host never runs out.
+ */
+UINT16 MON_GetTxFree(void)
+{
+    return 0xFFFF;
+}
+
+/**
+ * @brief Prints the usage of the tool.
+ * @return Void
+ */
+static void REPLAY_Usage(void)
+{
+    fprintf(stderr, "usage: capture_replay [-b scans] [-d] trace|-\n"
+            "  -b scans    scans per ADC interrupt (4)\n"
+            "  -d          dump the capture ring instead of replaying it\n");
+}
+
+/**
+ * @brief The main entry point of the tool.
+ * @return Returns 0 on success, 2 on a bad trace.
+ */
+int main(int argc, char** argv)
+{
+    TRACE trace;
+    long i, n, runs = 0;
+    long long start, ns, totalNs = 0, maxNs = 0;
+    int block = 4, opt;
+    BOOL isDump = FALSE, isStrum;
+
+    while((opt = getopt(argc, argv, "b:d")) != -1)
+    {
+        switch(opt)
+        {
+            case 'b': block = atoi(optarg); break;
+            case 'd': isDump = TRUE; break;
+            default: REPLAY_Usage(); return 2;
+        }
+    }
+    if(optind != argc - 1 || block < 1 || block > REPLAY_MAX_BLOCK)
+    {
+        REPLAY_Usage();
+        return 2;
+    }
+    if(!TRACE_Read(&trace, argv[optind]))
+    {
+        return 2;
+    }
+
+    // Fills the capture ring a block at a time, the ring keeps the newest samples.
+    CAPTURE_Init();
+    CAPTURE_Start(0);
+    for(i = 0; i + block <= trace.count; i += block)
+    {
+        isStrum = FALSE;
+        for(n = i; n < i + block; n++)
+        {
+            isStrum |= trace.reference[n];
+        }
+        CAPTURE_AddBlock(&trace.samples[i], block, trace.frets[i + block - 1], isStrum);
+    }
+
+    if(isDump)
+    {
+        CAPTURE_Dump();
+    }
+    else
+    {
+        CAPTURE_Replay();
+    }
+    while(CAPTURE_IsBusy())
+    {
+        start = REPLAY_GetNs();
+        CAPTURE_Process();
+        ns = REPLAY_GetNs() - start;
+        totalNs += ns;
+        maxNs = (ns > maxNs) ? ns : maxNs;
+        runs++;
+    }
+
+    // Keeps the dump readable by strum_replay.
+    if(!isDump)
+    {
+        printf("Capture task: %ld runs, longest %.1f us, mean %.1f us\n", runs, maxNs/1000.0,
+                (runs > 0) ? totalNs/1000.0/runs : 0.0);
+    }
+    return 0;
+}
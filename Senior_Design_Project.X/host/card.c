@@ -0,0 +1,436 @@
+/**
+ * @file card.c
+ * @author Kue Yang
+ * @date 10/19/2026
+ * @details Stands in for the SD card driver, mmc_pic32mx.c, with a card held in
+ * a disk image. The disk functions keep the driver's status and results, so the
+ * firmware's FILES module and FatFs run on it unchanged. Time is simulated: each
+ * command advances a clock by what it takes on the SPI bus, 400 kHz while the 
+ * card is initialized and 20 MHz after, plus the card's access time. The clock 
+ * is also the firmware's millisecond count. A card can be pulled out, made to 
+ * fail reads, or reset to idle state and kept there through initializations.
+ * @remarks Host tool, not part of the firmware build. Writes aren't supported.
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "STDDEF.h"
+#include "TIMER.h"
+#include "../fatfs/diskio.h"
+#include "card.h"
+
+/** @def CARD_SECTOR_SIZE
+ * Defines the size of a sector. */
+#define CARD_SECTOR_SIZE        512
+/** @def CARD_ERASE_SECTORS
+ * Defines the erase block reported to FatFs in sectors, as the image builder 
+ * lays out the card. */
+#define CARD_ERASE_SECTORS      8192
+/** @def CARD_SLOW_BYTE_NS
+ * Defines the time a byte takes on the bus while initializing in ns, 400 kHz. */
+#define CARD_SLOW_BYTE_NS       20000
+/** @def CARD_FAST_BYTE_NS
+ * Defines the time a byte takes on the bus once initialized in ns, 20 MHz. */
+#define CARD_FAST_BYTE_NS       400
+/** @def CARD_COMMAND_BYTES
+ * Defines the bytes clocked by a command and its response. */
+#define CARD_COMMAND_BYTES      8
+/** @def CARD_INIT_MS
+ * Defines the time the driver waits for a card to leave idle state in ms. */
+#define CARD_INIT_MS            1000
+/** @def CARD_NEVER
+ * Defines the wake time of a card that stays in idle state. */
+#define CARD_NEVER              0xFFFFFFFFFFFFFFFFULL
+
+/**  
+ * @privatesection
+ * @{
+ */
+static BYTE* image;                     /* The disk image */
+static DWORD imageSectors;              /* Number of sectors in the image */
+static size_t imageSize;                /* Size of the image in bytes */
+static UINT64 nowNs;                    /* The simulated clock in ns */
+static UINT64 wakeNs;                   /* Time taken by the card to leave idle state */
+static UINT64 accessNs;                 /* Time from a read command to the data */
+static DSTATUS Stat = STA_NOINIT;       /* Disk status, as the driver keeps it */
+static BOOL isInserted;                 /* The card is in the socket */
+static BOOL isIdle;                     /* The card is in idle state */
+static BOOL isInitStarted;              /* The driver is waiting for the card to leave idle state */
+static UINT64 cardWakeNs;               /* Time the card leaves idle state */
+static UINT64 initTimeoutNs;            /* Time the driver gives up on the card */
+static UINT16 stuckInits;               /* Initializations the card stays idle through */
+static UINT16 failedReads;              /* Reads the card fails */
+static UINT32 sectorsRead;              /* Number of sectors read */
+/** @} */
+
+/**
+ * @brief Opens the disk image and inserts the card.
+ * @arg path The disk image.
+ * @arg wakeMs The time the card takes to leave idle state in ms.
+ * @arg accessUs The time from a read command to the data in us.
+ * @return Returns a boolean indicating if the image was opened.
+ */
+BOOL CARD_Open(const char* path, UINT32 wakeMs, UINT32 accessUs)
+{
+    struct stat info;
+    int fd = open(path, O_RDONLY);
+
+    if(fd < 0 || fstat(fd, &info) != 0 || info.st_size < CARD_SECTOR_SIZE)
+    {
+        perror(path);
+        if(fd >= 0)
+        {
+            close(fd);
+        }
+        return FALSE;
+    }
+    imageSize = info.st_size;
+    image = mmap(NULL, imageSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(image == MAP_FAILED)
+    {
+        perror(path);
+        image = NULL;
+        return FALSE;
+    }
+
+    imageSectors = imageSize/CARD_SECTOR_SIZE;
+    wakeNs = (UINT64)wakeMs*1000000;
+    accessNs = (UINT64)accessUs*1000;
+    nowNs = 0;
+    Stat = STA_NOINIT;
+    isInserted = TRUE;
+    isIdle = TRUE;
+    isInitStarted = FALSE;
+    stuckInits = 0;
+    failedReads = 0;
+    sectorsRead = 0;
+    return TRUE;
+}
+
+/**
+ * @brief Closes the disk image.
+ * @return Void
+ */
+void CARD_Close(void)
+{
+    if(image != NULL)
+    {
+        munmap(image, imageSize);
+        image = NULL;
+    }
+}
+
+/**
+ * @brief Returns a sector of the disk image.
+ * @arg sector The sector.
+ * @return Returns the sector, NULL if it is past the end of the image.
+ */
+const BYTE* CARD_GetSector(DWORD sector)
+{
+    return (sector < imageSectors) ? &image[(size_t)sector*CARD_SECTOR_SIZE] : NULL;
+}
+
+/**
+ * @brief Returns the simulated clock.
+ * @return Returns the time since the card was opened in us.
+ */
+UINT64 CARD_GetMicros(void)
+{
+    return nowNs/1000;
+}
+
+/**
+ * @brief Advances the simulated clock.
+ * @arg us The time to advance the clock by in us.
+ * @return Void
+ */
+void CARD_Wait(UINT32 us)
+{
+    nowNs += (UINT64)us*1000;
+}
+
+/**
+ * @brief Pulls the card out of the socket, it loses power.
+ * @return Void
+ */
+void CARD_Remove(void)
+{
+    isInserted = FALSE;
+    isIdle = TRUE;
+    isInitStarted = FALSE;
+}
+
+/**
+ * @brief Puts the card back into the socket.
+ * @return Void
+ */
+void CARD_Insert(void)
+{
+    isInserted = TRUE;
+}
+
+/**
+ * @brief Makes the card fail a number of reads.
+ * @details The card answers each read with an error token.
+ * @arg count The number of reads to fail.
+ * @return Void
+ */
+void CARD_FailReads(UINT16 count)
+{
+    failedReads = count;
+}
+
+/**
+ * @brief Resets the card to idle state, as a brown-out does.
+ * @details The driver still takes the card to be initialized, every read fails 
+ * until the card is initialized again.
+ * @arg stuckCount The number of initializations the card stays in idle state
+ * through, each is given up on by the driver.
+ * @return Void
+ */
+void CARD_Reset(UINT16 stuckCount)
+{
+    isIdle = TRUE;
+    stuckInits = stuckCount;
+}
+
+/**
+ * @brief Returns the number of sectors read from the card.
+ * @return Returns the number of sectors read since the card was opened.
+ */
+UINT32 CARD_GetSectorsRead(void)
+{
+    return sectorsRead;
+}
+
+/**
+ * @brief Stands in for the millisecond count of the firmware.
+ * @return Returns the simulated clock in ms.
+ */
+UINT32 TIMER_GetMSecond(void)
+{
+    return (UINT32)(nowNs/1000000);
+}
+
+/**
+ * @brief Updates the socket status as the driver does when it is used.
+ * @return Void
+ */
+static void CARD_UpdateSocket(void)
+{
+    if(isInserted)
+    {
+        Stat &= ~STA_NODISK;
+    }
+    else
+    {
+        Stat |= (STA_NODISK | STA_NOINIT);
+    }
+}
+
+/**
+ * @brief Gets the disk status.
+ * @arg pdrv The physical drive, only drive 0.
+ * @return Returns the disk status.
+ */
+DSTATUS disk_status(BYTE pdrv)
+{
+    if(pdrv != 0)
+    {
+        return STA_NOINIT;
+    }
+    CARD_UpdateSocket();
+    return Stat;
+}
+
+/**
+ * @brief Initializes the card, waiting for it to leave idle state.
+ * @details A card that is already initialized is left as it is, as the driver
+ * does when FatFs mounts the volume.
+ * @arg pdrv The physical drive, only drive 0.
+ * @return Returns the disk status.
+ */
+DSTATUS disk_initialize(BYTE pdrv)
+{
+    if(pdrv != 0)
+    {
+        return STA_NOINIT;
+    }
+    CARD_UpdateSocket();
+    if(!(Stat & STA_NOINIT))
+    {
+        return Stat;
+    }
+    disk_initialize_start(pdrv);
+    while(disk_initialize_poll(pdrv) == RES_NOTRDY)
+    {
+        CARD_Wait(1000);
+    }
+    return Stat;
+}
+
+/**
+ * @brief Puts the card in idle state.
+ * @details Clocks 80 dummy bits, CMD0 and CMD8 at 400 kHz. A card in the socket
+ * starts leaving idle state, unless it is stuck.
+ * @arg pdrv The physical drive, only drive 0.
+ * @return Returns the disk status.
+ */
+DSTATUS disk_initialize_start(BYTE pdrv)
+{
+    isInitStarted = FALSE;
+    if(pdrv != 0)
+    {
+        return STA_NOINIT;
+    }
+    CARD_UpdateSocket();
+    if(Stat & STA_NODISK)
+    {
+        return Stat;
+    }
+
+    Stat |= STA_NOINIT;
+    nowNs += (10 + 2*CARD_COMMAND_BYTES + 4)*CARD_SLOW_BYTE_NS;
+    if(isIdle && stuckInits > 0)
+    {
+        stuckInits--;
+        cardWakeNs = CARD_NEVER;
+    }
+    else
+    {
+        cardWakeNs = nowNs + wakeNs;
+    }
+    isIdle = TRUE;
+    isInitStarted = TRUE;
+    initTimeoutNs = nowNs + (UINT64)CARD_INIT_MS*1000000;
+    return Stat;
+}
+
+/**
+ * @brief Sends the card one command to leave idle state.
+ * @details Clocks ACMD41 at 400 kHz, and CMD58 once the card is ready.
+ * @arg pdrv The physical drive, only drive 0.
+ * @return Returns RES_OK once initialized, RES_NOTRDY while still idle, 
+ * RES_ERROR if it failed.
+ */
+DRESULT disk_initialize_poll(BYTE pdrv)
+{
+    if(pdrv != 0)
+    {
+        return RES_PARERR;
+    }
+    if(!isInitStarted || (Stat & STA_NODISK))
+    {
+        isInitStarted = FALSE;
+        return RES_ERROR;
+    }
+
+    nowNs += 2*CARD_COMMAND_BYTES*CARD_SLOW_BYTE_NS;
+    if(nowNs < cardWakeNs)
+    {
+        if(nowNs < initTimeoutNs)
+        {
+            return RES_NOTRDY;
+        }
+        isInitStarted = FALSE;
+        return RES_ERROR;
+    }
+
+    nowNs += (CARD_COMMAND_BYTES + 4)*CARD_SLOW_BYTE_NS;
+    isInitStarted = FALSE;
+    isIdle = FALSE;
+    Stat &= ~STA_NOINIT;
+    return RES_OK;
+}
+
+/**
+ * @brief Reads sectors from the card.
+ * @details Reads with CMD17, or CMD18 and CMD12 for more than one sector. A card
+ * in idle state rejects the command, a failed read gets an error token.
+ * @arg pdrv The physical drive, only drive 0.
+ * @arg buff The buffer to store the sectors.
+ * @arg sector The first sector.
+ * @arg count The number of sectors.
+ * @return Returns RES_OK if the sectors were read.
+ */
+DRESULT disk_read(BYTE pdrv, BYTE* buff, DWORD sector, UINT16 count)
+{
+    if(pdrv != 0 || count == 0)
+    {
+        return RES_PARERR;
+    }
+    CARD_UpdateSocket();
+    if(Stat & STA_NOINIT)
+    {
+        return RES_NOTRDY;
+    }
+
+    nowNs += CARD_COMMAND_BYTES*CARD_FAST_BYTE_NS;
+    if(isIdle || sector >= imageSectors || count > imageSectors - sector)
+    {
+        return RES_ERROR;
+    }
+    nowNs += accessNs;
+    if(failedReads > 0)
+    {
+        failedReads--;
+        return RES_ERROR;
+    }
+
+    memcpy(buff, &image[(size_t)sector*CARD_SECTOR_SIZE], (size_t)count*CARD_SECTOR_SIZE);
+    nowNs += (UINT64)count*(CARD_SECTOR_SIZE + 3)*CARD_FAST_BYTE_NS;
+    if(count > 1)
+    {
+        nowNs += CARD_COMMAND_BYTES*CARD_FAST_BYTE_NS;
+    }
+    sectorsRead += count;
+    return RES_OK;
+}
+
+/**
+ * @brief Writes sectors to the card.
+ * @details The image is read only, the card is write protected.
+ * @return Returns RES_WRPRT.
+ */
+DRESULT disk_write(BYTE pdrv, const BYTE* buff, DWORD sector, UINT16 count)
+{
+    (void)pdrv; (void)buff; (void)sector; (void)count;
+    return RES_WRPRT;
+}
+
+/**
+ * @brief Handles the miscellaneous disk functions used by FatFs.
+ * @arg pdrv The physical drive, only drive 0.
+ * @arg cmd The control code.
+ * @arg buff The data of the control code.
+ * @return Returns RES_OK if the control code is handled.
+ */
+DRESULT disk_ioctl(BYTE pdrv, BYTE cmd, void* buff)
+{
+    if(pdrv != 0)
+    {
+        return RES_PARERR;
+    }
+    if(Stat & STA_NOINIT)
+    {
+        return RES_NOTRDY;
+    }
+    switch(cmd)
+    {
+        case CTRL_SYNC:
+            return RES_OK;
+        case GET_SECTOR_COUNT:
+            *(DWORD*)buff = imageSectors;
+            return RES_OK;
+        case GET_BLOCK_SIZE:
+            *(DWORD*)buff = CARD_ERASE_SECTORS;
+            return RES_OK;
+        default:
+            return RES_PARERR;
+    }
+}
@@ -0,0 +1,38 @@
+/**
+ * @file card.h
+ * @author Kue Yang
+ * @date 10/19/2026
+ */
+
+#ifndef CARD_H
+#define	CARD_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include "STDDEF.h"
+
+/** @def CARD_WAKE_MS
+ * Defines the default time a card takes to leave idle state in ms. */
+#define CARD_WAKE_MS            100
+/** @def CARD_ACCESS_US
+ * Defines the default time from a read command to the data token in us. */
+#define CARD_ACCESS_US          300
+
+BOOL CARD_Open(const char* path, UINT32 wakeMs, UINT32 accessUs);
+void CARD_Close(void);
+const BYTE* CARD_GetSector(DWORD sector);
+UINT64 CARD_GetMicros(void);
+void CARD_Wait(UINT32 us);
+void CARD_Remove(void);
+void CARD_Insert(void);
+void CARD_FailReads(UINT16 count);
+void CARD_Reset(UINT16 stuckCount);
+UINT32 CARD_GetSectorsRead(void);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* CARD_H */
@@ -0,0 +1,431 @@
+/**
+ * @file card_recovery.c
+ * @author Kue Yang
+ * @date 10/19/2026
+ * @details Measures how long the firmware takes to recover the SD card from 
+ * injected faults. The firmware's FILES module and FatFs are built unchanged 
+ * on an emulated card holding a card image. The main loop is simulated: the 
+ * card task runs every 10 ms and reopens the pack once the card is mounted, 
+ * and playback borrows the pack a sector at a time at the rate of a stereo 
+ * 44.1 kHz note, checking every sector against the image. Each kind of fault 
+ * is injected a number of times and the time from the fault until the pack 
+ * can be read again is reported, with the time playback went without the card.
+ * A card whose pack is missing must not be reported ready or recovered.
+ * @remarks Host tool, not part of the firmware build. The firmware waits for 
+ * the ringing note to finish before reopening the pack, the simulation reopens
+ * it right away.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "STDDEF.h"
+#include "FILEDEF.h"
+#include "PACKDEF.h"
+#include "FILES.h"
+#include "card.h"
+
+/** @def RECOVERY_CARD_US
+ * Defines the period of the card task in us. */
+#define RECOVERY_CARD_US        10000
+/** @def RECOVERY_PLAY_US
+ * Defines the period playback reads the pack at in us. */
+#define RECOVERY_PLAY_US        1000
+/** @def RECOVERY_PLAY_BYTES
+ * Defines the bytes played per second, stereo 16-bit at 44.1 kHz. */
+#define RECOVERY_PLAY_BYTES     176400
+/** @def RECOVERY_TIMEOUT_US
+ * Defines how long a fault is given to recover in us. */
+#define RECOVERY_TIMEOUT_US     10000000
+/** @def RECOVERY_MIN_GAP_US
+ * Defines the shortest time between a recovery and the next fault in us. */
+#define RECOVERY_MIN_GAP_US     200000
+/** @def RECOVERY_MIN_OUT_MS
+ * Defines the shortest time a removed card is left out in ms. */
+#define RECOVERY_MIN_OUT_MS     100
+/** @def RECOVERY_MAX_OUT_MS
+ * Defines the longest time a removed card is left out in ms. */
+#define RECOVERY_MAX_OUT_MS     1000
+/** @def RECOVERY_NUM_OF_FAULTS
+ * Defines the number of kinds of fault. */
+#define RECOVERY_NUM_OF_FAULTS  4
+
+/** @var faultNames
+ * The names of the kinds of fault. */
+static const char* faultNames[RECOVERY_NUM_OF_FAULTS] = {
+    "Read error", "Card reset", "Stuck reset", "Card removed"
+};
+/** @var randState
+ * The state of the random number generator. */
+static unsigned long long randState;
+/** @var playOffset
+ * The offset in the pack playback reads next. */
+static UINT32 playOffset;
+/** @var playOwed
+ * The bytes playback is waiting for. */
+static double playOwed;
+/** @var mismatches
+ * The number of sectors lent that don't match the image. */
+static UINT32 mismatches;
+/** @var longestTaskUs
+ * The longest run of the card task in us. */
+static UINT64 longestTaskUs;
+/** @var isVerbose
+ * Prints every fault. */
+static BOOL isVerbose;
+/** @var packName
+ * The name of the pack the card task opens. */
+static const char* packName;
+
+/** @var cardRecoveries
+ * The number of faults the FILES module recovered from. */
+extern UINT32 cardRecoveries;
+
+/**
+ * @brief Stands in for sending a line to the monitor.
+ * @arg str The line to send.
+ * @return Void
+ */
+void MON_SendString(const char* str)
+{
+    printf("  %s\n", str);
+}
+
+/**
+ * @brief Stands in for comparing two strings in the monitor.
+ * @return Returns a boolean indicating if the strings match.
+ */
+BOOL MON_stringsMatch(const char* str1, const char* str2)
+{
+    return strcmp(str1, str2) == 0;
+}
+
+/**
+ * @brief Returns a uniform random number.
+ * @arg low The lowest value.
+ * @arg high The highest value.
+ * @return Returns a random number in [low, high).
+ */
+static UINT32 RECOVERY_Random(UINT32 low, UINT32 high)
+{
+    randState = randState*6364136223846793005ULL + 1442695040888963407ULL;
+    return low + (UINT32)((randState >> 33) % (high - low));
+}
+
+/**
+ * @brief Runs the card task, as AUDIO_CardProcess does.
+ * @details Keeps the longest run, the card task must not block the main loop.
+ * @return Void
+ */
+static void RECOVERY_CardTask(void)
+{
+    UINT64 start = CARD_GetMicros();
+
+    FILES_Process();
+    if(FILES_NeedsPack())
+    {
+        FILES_OpenPack(packName);
+    }
+    if(CARD_GetMicros() - start > longestTaskUs)
+    {
+        longestTaskUs = CARD_GetMicros() - start;
+    }
+}
+
+/**
+ * @brief Reads the pack at the playback rate.
+ * @details Borrows the pack a sector at a time while the card is ready and 
+ * checks each sector against the image. While the card recovers the bytes are
+ * played from RAM and flash, they aren't read later.
+ * @return Returns a boolean indicating if the card kept up.
+ */
+static BOOL RECOVERY_PlayTask(void)
+{
+    UINT32 packBytes = FILES_GetPackSectors()*PACK_SECTOR_SIZE;
+    const BYTE* data = NULL;
+    const BYTE* sector = NULL;
+    UINT16 lent = 0;
+
+    playOwed += (double)RECOVERY_PLAY_BYTES*RECOVERY_PLAY_US/1000000;
+    if(!FILES_IsReady() || packBytes == 0)
+    {
+        playOwed = 0.0;
+        return FALSE;
+    }
+    while(playOwed >= PACK_SECTOR_SIZE)
+    {
+        if(FILES_LendPack(playOffset, PACK_SECTOR_SIZE, &data, &lent) != FR_OK || lent == 0)
+        {
+            playOwed = 0.0;
+            return FALSE;
+        }
+        sector = CARD_GetSector(FILES_GetPackSector() + playOffset/PACK_SECTOR_SIZE);
+        if(sector == NULL || memcmp(data, &sector[playOffset%PACK_SECTOR_SIZE], lent) != 0)
+        {
+            mismatches++;
+        }
+        playOffset = (playOffset + lent) % packBytes;
+        playOwed -= lent;
+    }
+    return TRUE;
+}
+
+/**
+ * @brief Injects a fault into the card.
+ * @arg fault The kind of fault.
+ * @return Returns the time the card is left out in us, 0 if it isn't removed.
+ */
+static UINT64 RECOVERY_Inject(int fault)
+{
+    switch(fault)
+    {
+        case 0:
+            CARD_FailReads(1);
+            break;
+        case 1:
+            CARD_Reset(0);
+            break;
+        case 2:
+            CARD_Reset(1);
+            break;
+        default:
+            CARD_Remove();
+            return (UINT64)RECOVERY_Random(RECOVERY_MIN_OUT_MS, RECOVERY_MAX_OUT_MS + 1)*1000;
+    }
+    return 0;
+}
+
+/**
+ * @brief Runs the main loop until the card is ready or the deadline passes.
+ * @arg deadline The time to give up at in us.
+ * @arg insertAt The time a removed card is put back in us, 0 if it isn't out.
+ * @arg starvedUs Adds the time playback went without the card in us.
+ * @return Returns a boolean indicating if the card is ready.
+ */
+static BOOL RECOVERY_Run(UINT64 deadline, UINT64 insertAt, UINT64* starvedUs)
+{
+    UINT64 now = CARD_GetMicros();
+    UINT64 nextCard = now, nextPlay = now;
+
+    while(now < deadline)
+    {
+        if(insertAt != 0 && now >= insertAt)
+        {
+            CARD_Insert();
+            insertAt = 0;
+        }
+        if(now >= nextCard)
+        {
+            RECOVERY_CardTask();
+            nextCard += RECOVERY_CARD_US;
+        }
+        if(now >= nextPlay)
+        {
+            if(!RECOVERY_PlayTask())
+            {
+                *starvedUs += RECOVERY_PLAY_US;
+            }
+            else if(insertAt == 0 && FILES_IsReady())
+            {
+                return TRUE;
+            }
+            nextPlay += RECOVERY_PLAY_US;
+        }
+
+        // Sleeps until the next task, the card calls have advanced the clock.
+        now = CARD_GetMicros();
+        if(now < nextCard && now < nextPlay)
+        {
+            CARD_Wait((UINT32)(((nextCard < nextPlay) ? nextCard : nextPlay) - now));
+            now = CARD_GetMicros();
+        }
+    }
+    return FILES_IsReady();
+}
+
+/**
+ * @brief Runs faults of one kind.
+ * @arg image The card image.
+ * @arg fault The kind of fault.
+ * @arg count The number of faults.
+ * @arg wakeMs The time the card takes to leave idle state in ms.
+ * @arg accessUs The time from a read command to the data in us.
+ * @return Returns the number of faults that weren't recovered, -1 on a bad image.
+ */
+static int RECOVERY_Faults(const char* image, int fault, int count, UINT32 wakeMs, UINT32 accessUs)
+{
+    UINT64 start, insertAt, outUs, starvedUs = 0, us, totalUs = 0, maxUs = 0;
+    UINT64 totalStarvedUs = 0;
+    int i, failed = 0;
+
+    if(!CARD_Open(image, wakeMs, accessUs))
+    {
+        return -1;
+    }
+    playOffset = 0;
+    playOwed = 0.0;
+    longestTaskUs = 0;
+
+    // Brings up the card, the pack is read from the start.
+    FILES_Init();
+    if(!RECOVERY_Run(RECOVERY_TIMEOUT_US, 0, &starvedUs))
+    {
+        fprintf(stderr, "%s: the sample pack couldn't be opened.\n", image);
+        CARD_Close();
+        return -1;
+    }
+    printf("%s, %d faults:\n", faultNames[fault], count);
+    printf("  Startup: %.1f ms to open the pack\n", CARD_GetMicros()/1000.0);
+    FILES_ClearCard();
+
+    for(i = 0; i < count; i++)
+    {
+        starvedUs = 0;
+        RECOVERY_Run(CARD_GetMicros() + RECOVERY_Random(RECOVERY_MIN_GAP_US, 2*RECOVERY_MIN_GAP_US), 0, &starvedUs);
+        start = CARD_GetMicros();
+        outUs = RECOVERY_Inject(fault);
+        insertAt = (outUs > 0) ? start + outUs : 0;
+
+        // Plays until the card stops the playback, then until it is ready again.
+        starvedUs = 0;
+        while(starvedUs == 0 && insertAt == 0 && CARD_GetMicros() < start + RECOVERY_TIMEOUT_US)
+        {
+            RECOVERY_Run(CARD_GetMicros() + RECOVERY_PLAY_US, 0, &starvedUs);
+        }
+        if(!RECOVERY_Run(start + RECOVERY_TIMEOUT_US, insertAt, &starvedUs))
+        {
+            failed++;
+            printf("  Fault %d not recovered\n", i);
+            continue;
+        }
+        us = CARD_GetMicros() - start;
+        totalUs += us;
+        totalStarvedUs += starvedUs;
+        maxUs = (us > maxUs) ? us : maxUs;
+        if(isVerbose)
+        {
+            printf("  Fault %d: ready after %.1f ms, card out %.0f ms, playback without the card %.0f ms\n",
+                    i, us/1000.0, outUs/1000.0, starvedUs/1000.0);
+        }
+    }
+
+    if(count > failed)
+    {
+        printf("  Fault to ready: mean %.1f ms, max %.1f ms, playback without the card %.1f ms mean\n",
+                totalUs/1000.0/(count - failed), maxUs/1000.0, totalStarvedUs/1000.0/(count - failed));
+    }
+    printf("  Longest card task: %.1f ms\n", longestTaskUs/1000.0);
+    FILES_ShowCard(FALSE);
+    CARD_Close();
+    return failed;
+}
+
+/**
+ * @brief Checks a card whose pack is missing.
+ * @details Brings up the card, then resets it and opens a pack that isn't on
+ * the card. The card must stay short of ready, the pack must not be opened 
+ * again every run of the card task and the fault must not count as recovered.
+ * @arg image The card image.
+ * @return Returns a boolean indicating if the missing pack was handled.
+ */
+static BOOL RECOVERY_MissingPack(const char* image)
+{
+    UINT64 starvedUs = 0, deadline;
+    BOOL isHandled = FALSE;
+
+    if(!CARD_Open(image, CARD_WAKE_MS, CARD_ACCESS_US))
+    {
+        return FALSE;
+    }
+    packName = PACK_FILE_NAME;
+    FILES_Init();
+    if(RECOVERY_Run(RECOVERY_TIMEOUT_US, 0, &starvedUs))
+    {
+        FILES_ClearCard();
+        packName = "MISSING.BIN";
+        CARD_Reset(0);
+        // Runs the main loop on past the point a good pack would be open.
+        deadline = CARD_GetMicros() + RECOVERY_TIMEOUT_US/10;
+        while(CARD_GetMicros() < deadline)
+        {
+            RECOVERY_Run(CARD_GetMicros() + RECOVERY_CARD_US, 0, &starvedUs);
+        }
+        isHandled = !FILES_IsReady() && !FILES_NeedsPack() && (cardRecoveries == 0);
+        printf("Missing pack:\n");
+        FILES_ShowCard(FALSE);
+    }
+    packName = PACK_FILE_NAME;
+    CARD_Close();
+    return isHandled;
+}
+
+/**
+ * @brief Prints the usage of the tool.
+ * @return Void
+ */
+static void RECOVERY_Usage(void)
+{
+    fprintf(stderr, "usage: card_recovery [-n faults] [-w wakeMs] [-a accessUs] [-s seed] [-v] image\n"
+            "  -n faults   faults of each kind (10)\n"
+            "  -w wakeMs   time the card takes to leave idle state (%d)\n"
+            "  -a accessUs time from a read command to the data (%d)\n"
+            "  -s seed     random seed (1)\n"
+            "  -v          list every fault\n", CARD_WAKE_MS, CARD_ACCESS_US);
+}
+
+/**
+ * @brief The main entry point of the tool.
+ * @return Returns 0 on success, 1 if a fault wasn't recovered or a sector read
+ * back wrong, 2 on a bad image.
+ */
+int main(int argc, char** argv)
+{
+    int count = 10, wakeMs = CARD_WAKE_MS, accessUs = CARD_ACCESS_US, opt, fault, failed = 0, res;
+
+    randState = 1;
+    isVerbose = FALSE;
+    packName = PACK_FILE_NAME;
+    while((opt = getopt(argc, argv, "n:w:a:s:v")) != -1)
+    {
+        switch(opt)
+        {
+            case 'n': count = atoi(optarg); break;
+            case 'w': wakeMs = atoi(optarg); break;
+            case 'a': accessUs = atoi(optarg); break;
+            case 's': randState = strtoull(optarg, NULL, 0); break;
+            case 'v': isVerbose = TRUE; break;
+            default: RECOVERY_Usage(); return 2;
+        }
+    }
+    if(optind != argc - 1 || count < 1 || wakeMs < 0 || accessUs < 0)
+    {
+        RECOVERY_Usage();
+        return 2;
+    }
+
+    mismatches = 0;
+    for(fault = 0; fault < RECOVERY_NUM_OF_FAULTS; fault++)
+    {
+        res = RECOVERY_Faults(argv[optind], fault, count, wakeMs, accessUs);
+        if(res < 0)
+        {
+            return 2;
+        }
+        failed += res;
+    }
+
+    if(!RECOVERY_MissingPack(argv[optind]))
+    {
+        printf("  Missing pack reported ready or recovered\n");
+        failed++;
+    }
+
+    printf("Not recovered: %d, sectors read back wrong: %u\n", failed, mismatches);
+    if(failed > 0 || mismatches > 0)
+    {
+        printf("FAIL\n");
+        return 1;
+    }
+    return 0;
+}
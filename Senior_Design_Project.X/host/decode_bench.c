@@ -0,0 +1,307 @@
+/**
+ * @file decode_bench.c
+ * @author Kue Yang
+ * @date 10/19/2026
+ * @details Runs the DECODE benchmark of the firmware on the host, over the 
+ * sample pack of a card image. The firmware's FILES module and FatFs are built
+ * unchanged on the emulated card. Every note is decoded the way the benchmark 
+ * does it, once after copying it into a receive buffer and once in place from
+ * the borrowed pack sector, from two bytes past its start and from its start.
+ * The host cost of each is reported per KB of audio, along with the sectors 
+ * read and the time the emulated card's bus took.
+ * @remarks Host tool, not part of the firmware build. The cycles are host TSC 
+ * cycles, the PIC32 runs the same code in more cycles and reads the card at 
+ * the bus times reported.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "STDDEF.h"
+#include "FILEDEF.h"
+#include "PACKDEF.h"
+#include "FILES.h"
+#include "card.h"
+
+/** @def DECODE_BYTES
+ * Defines the note bytes decoded per note, as the DECODE command. */
+#define DECODE_BYTES            8192
+/** @def DECODE_BLOCK
+ * Defines the bytes read at a time, one receive buffer. */
+#define DECODE_BLOCK            PACK_SECTOR_SIZE
+/** @def DECODE_MAX_STRINGS
+ * Defines the strings searched for notes. */
+#define DECODE_MAX_STRINGS      6
+/** @def DECODE_MAX_FRETS
+ * Defines the frets searched for notes. */
+#define DECODE_MAX_FRETS        25
+/** @def DECODE_CARD_MS
+ * Defines the period of the card task in ms. */
+#define DECODE_CARD_MS          10
+/** @def DECODE_MOUNT_MS
+ * Defines how long the card is given to come up in ms. */
+#define DECODE_MOUNT_MS         5000
+
+/**
+ * @brief DECODE_COST data structure.
+ * @details The DECODE_COST data structure stores the cost of a way of decoding.
+ */
+typedef struct DECODE_COST
+{
+    /**@{*/
+    UINT64 cycles;              /**< Variable used to store the host cycles. */
+    UINT64 busUs;               /**< Variable used to store the time the card bus took in us. */
+    UINT64 sectors;             /**< Variable used to store the sectors read from the card. */
+    UINT64 bytes;               /**< Variable used to store the bytes decoded. */
+    /**@}*/
+}DECODE_COST;
+
+/** @var receiveBuffer
+ * The buffer notes are copied into, as the audio receive buffer. */
+static BYTE receiveBuffer[DECODE_BLOCK];
+/** @var sink
+ * Keeps the decoded samples from being optimized away. */
+static volatile UINT32 sink;
+
+/**
+ * @brief Stands in for sending a line to the monitor.
+ * @arg str The line to send.
+ * @return Void
+ */
+void MON_SendString(const char* str)
+{
+    printf("%s\n", str);
+}
+
+/**
+ * @brief Stands in for comparing two strings in the monitor.
+ * @return Returns a boolean indicating if the strings match.
+ */
+BOOL MON_stringsMatch(const char* str1, const char* str2)
+{
+    return strcmp(str1, str2) == 0;
+}
+
+/**
+ * @brief Returns the host cycle count.
+ * @return Returns the TSC, 0 without one.
+ */
+static UINT64 DECODE_GetCycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Sums the samples in a number of bytes.
+ * @details Decodes the 16-bit samples as AUDIO_SumSamples does.
+ * @arg data The bytes to decode.
+ * @arg bytes The number of bytes to decode.
+ * @return Returns the sum of the samples.
+ */
+static UINT32 DECODE_SumSamples(const BYTE* data, UINT16 bytes)
+{
+    UINT32 sum = 0;
+    int i = 0;
+
+    for(i = 0; (i + 1) < bytes; i+=2)
+    {
+        sum += (INT16)((data[i+1] << 8) | (data[i]));
+    }
+    return sum;
+}
+
+/**
+ * @brief Brings up the card and opens the pack, as the card task does.
+ * @return Returns a boolean indicating if the pack is open.
+ */
+static BOOL DECODE_OpenPack(void)
+{
+    UINT64 deadline = CARD_GetMicros() + (UINT64)DECODE_MOUNT_MS*1000;
+
+    FILES_Init();
+    while(!FILES_IsReady() && CARD_GetMicros() < deadline)
+    {
+        FILES_Process();
+        if(FILES_NeedsPack())
+        {
+            FILES_OpenPack(PACK_FILE_NAME);
+        }
+        CARD_Wait(DECODE_CARD_MS*1000);
+    }
+    return FILES_IsReady();
+}
+
+/**
+ * @brief Decodes a note, as the DECODE command does.
+ * @arg offset The offset of the first byte in the pack.
+ * @arg bytes The number of bytes to decode, a number of blocks.
+ * @arg isLent Decodes in place from the borrowed pack sector, else from a copy.
+ * @arg cost The cost to add the decode to.
+ * @return Returns a boolean indicating if the note was read.
+ */
+static BOOL DECODE_Note(UINT32 offset, UINT32 bytes, BOOL isLent, DECODE_COST* cost)
+{
+    UINT64 startCycles, startUs = CARD_GetMicros();
+    UINT32 startSectors = CARD_GetSectorsRead(), done = 0, sum = 0;
+    const BYTE* data = NULL;
+    UINT16 readPtr = 0;
+
+    startCycles = DECODE_GetCycles();
+    for(done = 0; done < bytes; done += readPtr)
+    {
+        if(isLent)
+        {
+            if((FILES_LendPack(offset + done, bytes - done, &data, &readPtr) != FR_OK) || (readPtr == 0))
+            {
+                return FALSE;
+            }
+            sum += DECODE_SumSamples(data, readPtr);
+        }
+        else
+        {
+            if((FILES_ReadPack(offset + done, &receiveBuffer[0], DECODE_BLOCK, &readPtr) != FR_OK) || (readPtr == 0))
+            {
+                return FALSE;
+            }
+            sum += DECODE_SumSamples(&receiveBuffer[0], readPtr);
+        }
+    }
+    cost->cycles += DECODE_GetCycles() - startCycles;
+    cost->busUs += CARD_GetMicros() - startUs;
+    cost->sectors += CARD_GetSectorsRead() - startSectors;
+    cost->bytes += bytes;
+    sink += sum;
+    return TRUE;
+}
+
+/**
+ * @brief Prints the cost of a way of decoding per KB.
+ * @arg name The name of the way.
+ * @arg cost The cost.
+ * @arg base The cost it is compared to, NULL for none.
+ * @return Void
+ */
+static void DECODE_Print(const char* name, const DECODE_COST* cost, const DECODE_COST* base)
+{
+    double kb = cost->bytes/1024.0;
+
+    printf("  %-10s %8.0f cycles/KB %6.2f sectors/KB %7.1f us/KB on the bus", name,
+            cost->cycles/kb, cost->sectors/kb, cost->busUs/kb);
+    if(base != NULL && cost->cycles > 0)
+    {
+        printf("  %.2fx", (double)base->cycles/cost->cycles);
+    }
+    printf("\n");
+}
+
+/**
+ * @brief Prints the usage of the tool.
+ * @return Void
+ */
+static void DECODE_Usage(void)
+{
+    fprintf(stderr, "usage: decode_bench [-r repeats] image\n"
+            "  -r repeats  times every note is decoded each way (20)\n");
+}
+
+/**
+ * @brief The main entry point of the tool.
+ * @return Returns 0 on success, 1 if a note couldn't be read, 2 on a bad image.
+ */
+int main(int argc, char** argv)
+{
+    DECODE_COST costs[2][2];
+    AUDIOINFO info;
+    UINT32 offsets[DECODE_MAX_STRINGS*DECODE_MAX_FRETS], sizes[DECODE_MAX_STRINGS*DECODE_MAX_FRETS];
+    UINT32 dataOffset = 0, bytes;
+    int notes = 0, repeats = 20, string, fret, opt, i, r, skew, lent;
+
+    while((opt = getopt(argc, argv, "r:")) != -1)
+    {
+        switch(opt)
+        {
+            case 'r': repeats = atoi(optarg); break;
+            default: DECODE_Usage(); return 2;
+        }
+    }
+    if(optind != argc - 1 || repeats < 1)
+    {
+        DECODE_Usage();
+        return 2;
+    }
+    if(!CARD_Open(argv[optind], CARD_WAKE_MS, CARD_ACCESS_US))
+    {
+        return 2;
+    }
+    if(!DECODE_OpenPack())
+    {
+        fprintf(stderr, "%s: the sample pack couldn't be opened.\n", argv[optind]);
+        return 2;
+    }
+
+    // Finds every note long enough to benchmark, as the DECODE command sizes it.
+    for(string = 1; string <= DECODE_MAX_STRINGS; string++)
+    {
+        for(fret = 0; fret < DECODE_MAX_FRETS; fret++)
+        {
+            if(FILES_FindNote(PACK_MAKE_NOTE_ID(string, fret), &info, &dataOffset) && (info.dataSize > 2))
+            {
+                bytes = DECODE_BYTES;
+                if(bytes > (info.dataSize - 2))
+                {
+                    bytes = (info.dataSize - 2) & ~(DECODE_BLOCK - 1);
+                }
+                if(bytes > 0)
+                {
+                    offsets[notes] = dataOffset;
+                    sizes[notes] = bytes;
+                    notes++;
+                }
+            }
+        }
+    }
+    if(notes == 0)
+    {
+        fprintf(stderr, "%s: the sample pack has no notes to decode.\n", argv[optind]);
+        return 2;
+    }
+
+    // Alternates the ways so they see the same host caches.
+    memset(costs, 0, sizeof(costs));
+    for(r = 0; r < repeats; r++)
+    {
+        for(i = 0; i < notes; i++)
+        {
+            for(skew = 0; skew < 2; skew++)
+            {
+                for(lent = 0; lent < 2; lent++)
+                {
+                    if(!DECODE_Note(offsets[i] + (skew ? 2 : 0), sizes[i], lent, &costs[skew][lent]))
+                    {
+                        fprintf(stderr, "Failed to read note %d.\n", i);
+                        return 1;
+                    }
+                }
+            }
+        }
+    }
+
+    printf("Decoded %d notes %d times each way, pack %s\n", notes, repeats,
+            (FILES_GetPackSector() != 0) ? "contiguous" : "fragmented");
+    for(skew = 1; skew >= 0; skew--)
+    {
+        printf("%s:\n", skew ? "Two bytes past the note start (DECODE)" : "From the note start");
+        DECODE_Print("Copy", &costs[skew][0], NULL);
+        DECODE_Print("In place", &costs[skew][1], &costs[skew][0]);
+    }
+    CARD_Close();
+    return 0;
+}
@@ -0,0 +1,249 @@
+/**
+ * @file fifo_bench.c
+ * @author Kue Yang
+ * @date 10/19/2026
+ * @details Measures the throughput of the firmware's FIFO module, built 
+ * unchanged, against the MON_FIFO it replaced. Each run fills the queue with
+ * half a monitor buffer and drains it again, a byte at a time, in monitor line 
+ * sized copies, and through the contiguous spans the UART DMA would use.
+ * @remarks Host tool, not part of the firmware build. The numbers compare the 
+ * ways of moving bytes, the PIC32 runs them slower by its clock.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "STDDEF.h"
+#include "FIFO.h"
+
+/** @def BENCH_BURST
+ * Defines the number of bytes queued and drained by each pass. */
+#define BENCH_BURST             (MON_BUFFERSIZE/2)
+/** @def BENCH_LINE
+ * Defines the size of the copies, about one monitor line. */
+#define BENCH_LINE              64
+/** @def BENCH_MIN_NS
+ * Defines how long each way is timed for. */
+#define BENCH_MIN_NS            200000000LL
+
+/**
+ * @brief MON_FIFO data structure.
+ * @details The monitor queue FIFO replaced, kept as the baseline.
+ */
+typedef struct MON_FIFO
+{
+    /**@{*/
+    char buffer[MON_BUFFERSIZE];    /**< Variable used to store the queued data. */
+    UINT16 headPtr;                 /**< Variable used to point to the front of the queue. */
+    UINT16 tailPtr;                 /**< Variable used to point to the back of the queue. */
+    UINT16 bufferSize;              /**< Variable used to store the queue size. */
+    /**@}*/
+}MON_FIFO;
+
+/** @var monFifo
+ * The baseline queue. */
+static MON_FIFO monFifo;
+/** @var fifo
+ * The queue under test. */
+static FIFO fifo;
+/** @var fifoBuffer
+ * The buffer of the queue under test. */
+static BYTE fifoBuffer[MON_BUFFERSIZE];
+/** @var sink
+ * Keeps the drained bytes from being optimized away. */
+static volatile BYTE sink;
+
+/**
+ * @brief Pushes a byte into the baseline queue, as MON_FIFO did.
+ * @return Returns FALSE if the queue is full.
+ */
+static BOOL BENCH_MonPush(MON_FIFO* mon, char ch)
+{
+    if(mon->bufferSize >= MON_BUFFERSIZE)
+    {
+        return FALSE;
+    }
+    mon->buffer[mon->tailPtr++] = ch;
+    mon->bufferSize++;
+    if(mon->tailPtr >= MON_BUFFERSIZE)
+    {
+        mon->tailPtr = 0;
+    }
+    return TRUE;
+}
+
+/**
+ * @brief Pops a byte from the baseline queue, as MON_FIFO did.
+ * @return Returns the byte popped.
+ */
+static char BENCH_MonPop(MON_FIFO* mon)
+{
+    char ch;
+
+    mon->bufferSize--;
+    ch = mon->buffer[mon->headPtr++];
+    if(mon->headPtr >= MON_BUFFERSIZE)
+    {
+        mon->headPtr = 0;
+    }
+    return ch;
+}
+
+/**
+ * @brief Runs one pass through the baseline queue a byte at a time.
+ * @return Void
+ */
+static void BENCH_MonBytes(void)
+{
+    BYTE sum = 0;
+    int i;
+
+    for(i = 0; i < BENCH_BURST; i++)
+    {
+        BENCH_MonPush(&monFifo, (char)i);
+    }
+    while(monFifo.bufferSize > 0)
+    {
+        sum += BENCH_MonPop(&monFifo);
+    }
+    sink = sum;
+}
+
+/**
+ * @brief Runs one pass through the queue a byte at a time.
+ * @return Void
+ */
+static void BENCH_Bytes(void)
+{
+    BYTE sum = 0, data = 0;
+    int i;
+
+    for(i = 0; i < BENCH_BURST; i++)
+    {
+        FIFO_Push(&fifo, (BYTE)i);
+    }
+    while(FIFO_Pop(&fifo, &data))
+    {
+        sum += data;
+    }
+    sink = sum;
+}
+
+/**
+ * @brief Runs one pass through the queue in line sized copies.
+ * @return Void
+ */
+static void BENCH_Lines(void)
+{
+    BYTE line[BENCH_LINE];
+    int i;
+
+    memset(line, 0x55, sizeof(line));
+    for(i = 0; i < BENCH_BURST; i += BENCH_LINE)
+    {
+        FIFO_Write(&fifo, line, BENCH_LINE);
+    }
+    while(FIFO_Read(&fifo, line, BENCH_LINE) > 0)
+    {
+        sink = line[0];
+    }
+}
+
+/**
+ * @brief Runs one pass through the queue in place through the spans.
+ * @details Fills the free span and hands out the queued span whole, as a DMA 
+ * transfer would take it.
+ * @return Void
+ */
+static void BENCH_Spans(void)
+{
+    BYTE* write = NULL;
+    const BYTE* read = NULL;
+    UINT16 span, queued = 0;
+
+    while(queued < BENCH_BURST)
+    {
+        span = FIFO_PeekWrite(&fifo, &write);
+        if(span > BENCH_BURST - queued)
+        {
+            span = BENCH_BURST - queued;
+        }
+        memset(write, 0x55, span);
+        FIFO_CommitWrite(&fifo, span);
+        queued += span;
+    }
+    while((span = FIFO_PeekRead(&fifo, &read)) > 0)
+    {
+        sink = read[span - 1];
+        FIFO_CommitRead(&fifo, span);
+    }
+}
+
+/**
+ * @brief Times a way of moving bytes.
+ * @arg name The name printed for the way.
+ * @arg pass Runs one pass of BENCH_BURST bytes.
+ * @arg baseline The ns per byte of the baseline, 0 for the baseline itself.
+ * @return Returns the ns per byte.
+ */
+static double BENCH_Run(const char* name, void (*pass)(void), double baseline)
+{
+    struct timespec start, end;
+    long long ns = 0, passes = 0;
+    unsigned long long tsc = 0;
+    double nsPerByte;
+    int i;
+
+    do
+    {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+#if defined(__x86_64__) || defined(__i386__)
+        unsigned long long startTsc = __rdtsc();
+#endif
+        for(i = 0; i < 1000; i++)
+        {
+            pass();
+        }
+#if defined(__x86_64__) || defined(__i386__)
+        tsc += __rdtsc() - startTsc;
+#endif
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        ns += (end.tv_sec - start.tv_sec)*1000000000LL + (end.tv_nsec - start.tv_nsec);
+        passes += 1000;
+    } while(ns < BENCH_MIN_NS);
+
+    nsPerByte = (double)ns/((double)passes*BENCH_BURST);
+    printf("%-28s %6.2f ns/byte %8.1f MB/s", name, nsPerByte, 1000.0/nsPerByte);
+    if(tsc > 0)
+    {
+        printf(" %6.2f TSC cycles/byte", (double)tsc/((double)passes*BENCH_BURST));
+    }
+    if(baseline > 0.0)
+    {
+        printf("  %.1fx MON_FIFO", baseline/nsPerByte);
+    }
+    printf("\n");
+    return nsPerByte;
+}
+
+/**
+ * @brief The main entry point of the benchmark.
+ * @return Returns 0.
+ */
+int main(void)
+{
+    double baseline;
+
+    memset(&monFifo, 0, sizeof(monFifo));
+    FIFO_Init(&fifo, fifoBuffer, MON_BUFFERSIZE);
+
+    printf("%d bytes queued and drained per pass, %d byte queue\n", BENCH_BURST, MON_BUFFERSIZE);
+    baseline = BENCH_Run("MON_FIFO push/pop", BENCH_MonBytes, 0.0);
+    BENCH_Run("FIFO push/pop", BENCH_Bytes, baseline);
+    BENCH_Run("FIFO write/read, 64 bytes", BENCH_Lines, baseline);
+    BENCH_Run("FIFO peek/commit spans", BENCH_Spans, baseline);
+    return 0;
+}
@@ -0,0 +1,407 @@
+/**
+ * @file fifo_test.c
+ * @author Kue Yang
+ * @date 10/19/2026
+ * @details Unit tests for the firmware's FIFO module, built unchanged. Covers 
+ * full and empty queues, the 16-bit index wrap, the peek and commit spans, 
+ * the drop counter, and one producer and one consumer thread sharing a queue.
+ * @remarks Host tool, not part of the firmware build. The thread test relies on 
+ * the host keeping stores in order as the PIC32 does, so it is run on x86.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include "STDDEF.h"
+#include "FIFO.h"
+
+/** @def TEST_SIZE
+ * Defines the buffer size of the queues under test. */
+#define TEST_SIZE               16
+/** @def TEST_THREAD_BYTES
+ * Defines the number of bytes passed between the threads. */
+#define TEST_THREAD_BYTES       (1L << 24)
+/** @def TEST_THREAD_SIZE
+ * Defines the buffer size of the queue shared by the threads. */
+#define TEST_THREAD_SIZE        1024
+/** @def TEST_MAX_STALLS
+ * Defines how many times in a row a thread may find no progress before the 
+ * queue is taken to be stuck. */
+#define TEST_MAX_STALLS         1000000L
+/** @def CHECK
+ * Counts and prints a failed check. */
+#define CHECK(cond)             TEST_Check((cond), #cond, __LINE__)
+
+/** @var failures
+ * The number of failed checks. */
+static int failures;
+/** @var shared
+ * The queue shared by the producer and consumer threads. */
+static FIFO shared;
+/** @var sharedBuffer
+ * The buffer of the shared queue. */
+static BYTE sharedBuffer[TEST_THREAD_SIZE];
+/** @var rejected
+ * The number of pushes the shared queue turned away while full. */
+static UINT32 rejected;
+/** @var sent
+ * The number of bytes the producer thread queued. */
+static long sent;
+
+/**
+ * @brief Counts and prints a failed check.
+ * @arg cond The result of the check.
+ * @arg text The check.
+ * @arg line The line of the check.
+ * @return Void
+ */
+static void TEST_Check(int cond, const char* text, int line)
+{
+    if(!cond)
+    {
+        printf("fifo_test.c:%d: failed: %s\n", line, text);
+        failures++;
+    }
+}
+
+/**
+ * @brief Tests the sizes accepted by FIFO_Init.
+ * @return Void
+ */
+static void TEST_Init(void)
+{
+    FIFO fifo;
+    BYTE buffer[TEST_SIZE];
+
+    CHECK(!FIFO_Init(&fifo, buffer, 0));
+    CHECK(!FIFO_Init(&fifo, buffer, 12));
+    CHECK(FIFO_Init(&fifo, buffer, 1));
+    CHECK(FIFO_Init(&fifo, buffer, TEST_SIZE));
+    CHECK(FIFO_IsEmpty(&fifo));
+    CHECK(FIFO_GetCount(&fifo) == 0);
+    CHECK(FIFO_GetFree(&fifo) == TEST_SIZE);
+}
+
+/**
+ * @brief Tests filling and emptying a queue one byte at a time.
+ * @return Void
+ */
+static void TEST_FullEmpty(void)
+{
+    FIFO fifo;
+    BYTE buffer[TEST_SIZE], data = 0xA5;
+    int i;
+
+    FIFO_Init(&fifo, buffer, TEST_SIZE);
+    CHECK(!FIFO_Pop(&fifo, &data));
+    CHECK(data == 0xA5);
+    for(i = 0; i < TEST_SIZE; i++)
+    {
+        CHECK(FIFO_Push(&fifo, (BYTE)i));
+    }
+    CHECK(FIFO_GetCount(&fifo) == TEST_SIZE);
+    CHECK(FIFO_GetFree(&fifo) == 0);
+    CHECK(!FIFO_Push(&fifo, 0xFF));
+    CHECK(FIFO_GetDrops(&fifo) == 1);
+    for(i = 0; i < TEST_SIZE; i++)
+    {
+        CHECK(FIFO_Pop(&fifo, &data) && data == (BYTE)i);
+    }
+    CHECK(FIFO_IsEmpty(&fifo));
+    CHECK(!FIFO_Pop(&fifo, &data));
+}
+
+/**
+ * @brief Tests the queue across the wrap of the 16-bit indices.
+ * @details The indices are started just short of the wrap and the queue is 
+ * run full and empty across it, through every operation.
+ * @return Void
+ */
+static void TEST_IndexWrap(void)
+{
+    FIFO fifo;
+    BYTE buffer[TEST_SIZE], in[TEST_SIZE], out[TEST_SIZE], data = 0;
+    int i, pass;
+
+    FIFO_Init(&fifo, buffer, TEST_SIZE);
+    fifo.head = fifo.tail = 0xFFFA;
+    for(pass = 0; pass < 3; pass++)
+    {
+        for(i = 0; i < TEST_SIZE; i++)
+        {
+            in[i] = (BYTE)(pass*TEST_SIZE + i);
+        }
+        CHECK(FIFO_Write(&fifo, in, TEST_SIZE) == TEST_SIZE);
+        CHECK(FIFO_GetCount(&fifo) == TEST_SIZE);
+        CHECK(FIFO_GetFree(&fifo) == 0);
+        CHECK(!FIFO_Push(&fifo, 0));
+        CHECK(FIFO_Read(&fifo, out, TEST_SIZE) == TEST_SIZE);
+        CHECK(memcmp(in, out, TEST_SIZE) == 0);
+        CHECK(FIFO_IsEmpty(&fifo));
+    }
+    CHECK(fifo.tail < 0xFFFA);
+
+    // Single bytes across the wrap.
+    fifo.head = fifo.tail = 0xFFFE;
+    for(i = 0; i < 4; i++)
+    {
+        CHECK(FIFO_Push(&fifo, (BYTE)i));
+    }
+    CHECK(FIFO_GetCount(&fifo) == 4);
+    for(i = 0; i < 4; i++)
+    {
+        CHECK(FIFO_Pop(&fifo, &data) && data == (BYTE)i);
+    }
+    CHECK(FIFO_IsEmpty(&fifo));
+}
+
+/**
+ * @brief Tests the contiguous spans at the head and tail.
+ * @return Void
+ */
+static void TEST_Spans(void)
+{
+    FIFO fifo;
+    BYTE buffer[TEST_SIZE], in[TEST_SIZE], out[TEST_SIZE];
+    BYTE* write = NULL;
+    const BYTE* read = NULL;
+    int i;
+
+    for(i = 0; i < TEST_SIZE; i++)
+    {
+        in[i] = (BYTE)(0x40 + i);
+    }
+    FIFO_Init(&fifo, buffer, TEST_SIZE);
+
+    // An empty queue offers the whole buffer to write and nothing to read.
+    CHECK(FIFO_PeekWrite(&fifo, &write) == TEST_SIZE && write == &buffer[0]);
+    CHECK(FIFO_PeekRead(&fifo, &read) == 0);
+
+    // With 10 bytes written and read, the free space splits at the buffer end.
+    CHECK(FIFO_Write(&fifo, in, 10) == 10);
+    CHECK(FIFO_Read(&fifo, out, 10) == 10);
+    CHECK(FIFO_PeekWrite(&fifo, &write) == TEST_SIZE - 10 && write == &buffer[10]);
+    memcpy(write, in, TEST_SIZE - 10);
+    FIFO_CommitWrite(&fifo, TEST_SIZE - 10);
+    CHECK(FIFO_PeekWrite(&fifo, &write) == 10 && write == &buffer[0]);
+    memcpy(write, &in[TEST_SIZE - 10], 4);
+    FIFO_CommitWrite(&fifo, 4);
+    CHECK(FIFO_GetCount(&fifo) == TEST_SIZE - 6);
+
+    // The queued bytes are read back as the two spans they were written in.
+    CHECK(FIFO_PeekRead(&fifo, &read) == TEST_SIZE - 10 && read == &buffer[10]);
+    CHECK(memcmp(read, in, TEST_SIZE - 10) == 0);
+    FIFO_CommitRead(&fifo, TEST_SIZE - 10);
+    CHECK(FIFO_PeekRead(&fifo, &read) == 4 && read == &buffer[0]);
+    CHECK(memcmp(read, &in[TEST_SIZE - 10], 4) == 0);
+
+    // A partial commit leaves the rest of the span queued.
+    FIFO_CommitRead(&fifo, 1);
+    CHECK(FIFO_PeekRead(&fifo, &read) == 3 && read == &buffer[1]);
+    FIFO_CommitRead(&fifo, 3);
+    CHECK(FIFO_IsEmpty(&fifo));
+
+    // A full queue offers nothing to write.
+    CHECK(FIFO_Write(&fifo, in, TEST_SIZE) == TEST_SIZE);
+    CHECK(FIFO_PeekWrite(&fifo, &write) == 0);
+}
+
+/**
+ * @brief Tests the drop counter.
+ * @return Void
+ */
+static void TEST_Drops(void)
+{
+    FIFO fifo;
+    BYTE buffer[TEST_SIZE], in[TEST_SIZE + 8], out[TEST_SIZE];
+
+    memset(in, 0x5A, sizeof(in));
+    FIFO_Init(&fifo, buffer, TEST_SIZE);
+    CHECK(FIFO_Write(&fifo, in, 6) == 6);
+    CHECK(FIFO_GetDrops(&fifo) == 0);
+    CHECK(FIFO_Write(&fifo, in, TEST_SIZE) == TEST_SIZE - 6);
+    CHECK(FIFO_GetDrops(&fifo) == 6);
+    CHECK(!FIFO_Push(&fifo, 0));
+    CHECK(FIFO_GetDrops(&fifo) == 7);
+    CHECK(FIFO_Write(&fifo, in, sizeof(in)) == 0);
+    CHECK(FIFO_GetDrops(&fifo) == 7 + sizeof(in));
+
+    // Reading frees room again, clearing doesn't touch the data.
+    FIFO_ClearDrops(&fifo);
+    CHECK(FIFO_GetDrops(&fifo) == 0);
+    CHECK(FIFO_GetCount(&fifo) == TEST_SIZE);
+    CHECK(FIFO_Read(&fifo, out, 4) == 4);
+    CHECK(FIFO_Write(&fifo, in, 4) == 4);
+    CHECK(FIFO_GetDrops(&fifo) == 0);
+}
+
+/**
+ * @brief Writes a counting sequence into the shared queue.
+ * @details Alternates bulk writes, spans and single pushes, yielding while full.
+ * Gives up if the queue stays full.
+ * @return Returns NULL.
+ */
+static void* TEST_Producer(void* arg)
+{
+    BYTE chunk[97];
+    BYTE* span = NULL;
+    long last = 0, stalls = 0;
+    UINT16 count, i;
+
+    (void)arg;
+    while(sent < TEST_THREAD_BYTES && stalls < TEST_MAX_STALLS)
+    {
+        switch(sent % 3)
+        {
+            case 0:
+                count = (UINT16)(1 + sent % sizeof(chunk));
+                if(count > TEST_THREAD_BYTES - sent)
+                {
+                    count = (UINT16)(TEST_THREAD_BYTES - sent);
+                }
+                if(count > FIFO_GetFree(&shared))
+                {
+                    count = FIFO_GetFree(&shared);
+                }
+                for(i = 0; i < count; i++)
+                {
+                    chunk[i] = (BYTE)(sent + i);
+                }
+                sent += FIFO_Write(&shared, chunk, count);
+                break;
+            case 1:
+                count = FIFO_PeekWrite(&shared, &span);
+                if(count > TEST_THREAD_BYTES - sent)
+                {
+                    count = (UINT16)(TEST_THREAD_BYTES - sent);
+                }
+                for(i = 0; i < count; i++)
+                {
+                    span[i] = (BYTE)(sent + i);
+                }
+                FIFO_CommitWrite(&shared, count);
+                sent += count;
+                break;
+            default:
+                if(FIFO_Push(&shared, (BYTE)sent))
+                {
+                    sent++;
+                }
+                else
+                {
+                    rejected++;
+                }
+                break;
+        }
+        if(sent == last)
+        {
+            stalls++;
+            sched_yield();
+        }
+        else
+        {
+            stalls = 0;
+        }
+        last = sent;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Reads the counting sequence back from the shared queue.
+ * @details Alternates bulk reads, spans and single pops, yielding while empty.
+ * Gives up if the queue stays empty.
+ * @return Returns the number of bytes received in sequence, -1 if a byte was 
+ * out of sequence.
+ */
+static void* TEST_Consumer(void* arg)
+{
+    BYTE chunk[61], data = 0;
+    const BYTE* span = NULL;
+    long received = 0, last = 0, stalls = 0, errors = 0;
+    UINT16 count, i;
+
+    while(received < TEST_THREAD_BYTES && stalls < TEST_MAX_STALLS)
+    {
+        switch(received % 3)
+        {
+            case 0:
+                count = FIFO_Read(&shared, chunk, sizeof(chunk));
+                for(i = 0; i < count; i++)
+                {
+                    errors += (chunk[i] != (BYTE)(received + i));
+                }
+                received += count;
+                break;
+            case 1:
+                count = FIFO_PeekRead(&shared, &span);
+                for(i = 0; i < count; i++)
+                {
+                    errors += (span[i] != (BYTE)(received + i));
+                }
+                FIFO_CommitRead(&shared, count);
+                received += count;
+                break;
+            default:
+                if(FIFO_Pop(&shared, &data))
+                {
+                    errors += (data != (BYTE)received);
+                    received++;
+                }
+                break;
+        }
+        if(received == last)
+        {
+            stalls++;
+            sched_yield();
+        }
+        else
+        {
+            stalls = 0;
+        }
+        last = received;
+    }
+    *(long*)arg = (errors == 0) ? received : -1;
+    return NULL;
+}
+
+/**
+ * @brief Tests a producer and a consumer thread sharing a queue.
+ * @return Void
+ */
+static void TEST_Threads(void)
+{
+    pthread_t producer, consumer;
+    long received = -1;
+
+    FIFO_Init(&shared, sharedBuffer, TEST_THREAD_SIZE);
+    rejected = 0;
+    sent = 0;
+    shared.head = shared.tail = 0xFF00;
+    CHECK(pthread_create(&consumer, NULL, TEST_Consumer, &received) == 0);
+    CHECK(pthread_create(&producer, NULL, TEST_Producer, NULL) == 0);
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+    CHECK(sent == TEST_THREAD_BYTES);
+    CHECK(received == TEST_THREAD_BYTES);
+    CHECK(FIFO_IsEmpty(&shared));
+    CHECK(FIFO_GetDrops(&shared) == rejected);
+}
+
+/**
+ * @brief The main entry point of the tests.
+ * @return Returns 0 if every check passed, 1 otherwise.
+ */
+int main(void)
+{
+    TEST_Init();
+    TEST_FullEmpty();
+    TEST_IndexWrap();
+    TEST_Spans();
+    TEST_Drops();
+    TEST_Threads();
+
+    printf("FIFO tests: %s\n", (failures == 0) ? "passed" : "FAILED");
+    return (failures == 0) ? 0 : 1;
+}
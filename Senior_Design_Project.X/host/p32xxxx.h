@@ -0,0 +1,7 @@
+/**
+ * @file p32xxxx.h
+ * @author Kue Yang
+ * @date 10/19/2026
+ * @details Stands in for the device header in the host builds. The modules 
+ * built on the host don't touch any register.
+ */
@@ -0,0 +1,324 @@
+/**
+ * @file strum_replay.c
+ * @author Kue Yang
+ * @date 10/19/2026
+ * @details Replays a strumming sensor trace through the firmware's STRUM
+ * module, built unchanged, and reports the detection latency, the missed strums
+ * and the false triggers against the reference strums of the trace. The strum
+ * velocities are compared against the peak of each strum in the trace.
+ * @remarks Host tool, not part of the firmware build.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "STDDEF.h"
+#include "STRUM.h"
+#include "trace.h"
+
+/** @def REPLAY_MAX_BLOCK
+ * Defines the largest number of scans per ADC interrupt. */
+#define REPLAY_MAX_BLOCK        255
+/** @def REPLAY_MIN_NS
+ * Defines how long the detector is timed for, repeating the trace if needed. */
+#define REPLAY_MIN_NS           200000000LL
+/** @def REPLAY_PEAK_SAMPLES
+ * Defines the samples after a strum searched for its peak, one period of the
+ * lowest string (~25 ms). */
+#define REPLAY_PEAK_SAMPLES     123
+/** @def REPLAY_BASE_SAMPLES
+ * Defines the samples before a strum averaged for its resting level. */
+#define REPLAY_BASE_SAMPLES     8
+
+/** @var trace
+ * The trace that is replayed. */
+static TRACE trace;
+/** @var detected
+ * The strums found by the replay. */
+static BOOL* detected;
+/** @var velocities
+ * The settled velocity of each strum found. */
+static UINT16* velocities;
+/** @var levels
+ * The envelope of each strum found when it was detected. */
+static UINT16* levels;
+
+/**
+ * @brief Runs the trace through a strum detector the way the ADC interrupt does.
+ * @details Samples are handed to the detector a block at a time and a strum is
+ * placed at the sample its age points to, as the firmware does when it dates
+ * the strum onset. The velocity is kept once it settles.
+ * @arg count The number of samples.
+ * @arg block The number of scans per ADC interrupt.
+ * @return Returns the number of strums detected.
+ */
+static long REPLAY_Detect(long count, int block)
+{
+    STRUM strum;
+    long i, n, found = 0;
+
+    memset(detected, 0, count*sizeof(BOOL));
+    STRUM_Init(&strum, trace.samples[0]);
+    for(i = 0; i + block <= count; i += block)
+    {
+        if(STRUM_DetectBlock(&strum, &trace.samples[i], block))
+        {
+            n = i + block - 1 - STRUM_GetAge(&strum);
+            detected[n] = TRUE;
+            levels[n] = (UINT16)(strum.peak >> STRUM_Q);
+            found++;
+        }
+        if(STRUM_HasSettled(&strum, block))
+        {
+            velocities[i + block - 1 - STRUM_GetAge(&strum)] = STRUM_GetVelocity(&strum);
+        }
+    }
+    return found;
+}
+
+/**
+ * @brief Measures how hard a strum in the trace was struck.
+ * @arg onset The sample the strum starts at.
+ * @return Returns the largest swing from the resting level in ADC counts.
+ */
+static double REPLAY_GetPeak(long onset)
+{
+    double base = 0.0, peak = 0.0;
+    long i, first = (onset > REPLAY_BASE_SAMPLES) ? onset - REPLAY_BASE_SAMPLES : 0;
+
+    for(i = first; i < onset; i++)
+    {
+        base += trace.samples[i];
+    }
+    base = (onset > first) ? base/(onset - first) : trace.samples[onset];
+    for(i = onset; i < onset + REPLAY_PEAK_SAMPLES && i < trace.count; i++)
+    {
+        peak = (fabs(trace.samples[i] - base) > peak) ? fabs(trace.samples[i] - base) : peak;
+    }
+    return peak;
+}
+
+/**
+ * @brief Returns the correlation of two series.
+ * @arg x The first series.
+ * @arg y The second series.
+ * @arg count The number of values in each series.
+ * @return Returns the Pearson correlation, 0 if either series is flat.
+ */
+static double REPLAY_Correlate(const double* x, const double* y, long count)
+{
+    double mx = 0.0, my = 0.0, sxy = 0.0, sxx = 0.0, syy = 0.0;
+    long i;
+
+    for(i = 0; i < count; i++)
+    {
+        mx += x[i]/count;
+        my += y[i]/count;
+    }
+    for(i = 0; i < count; i++)
+    {
+        sxy += (x[i] - mx)*(y[i] - my);
+        sxx += (x[i] - mx)*(x[i] - mx);
+        syy += (y[i] - my)*(y[i] - my);
+    }
+    return (sxx > 0.0 && syy > 0.0) ? sxy/sqrt(sxx*syy) : 0.0;
+}
+
+/**
+ * @brief Times the strum detector over the trace.
+ * @arg count The number of samples.
+ * @arg cycles Stores the TSC cycles per sample, 0 if there is no TSC.
+ * @return Returns the ns per sample.
+ */
+static double REPLAY_Time(long count, double* cycles)
+{
+    struct timespec start, end;
+    long long ns = 0;
+    unsigned long long tsc = 0, passes = 0;
+    volatile BOOL sink = FALSE;
+    STRUM strum;
+    long i;
+
+    *cycles = 0.0;
+    do
+    {
+        STRUM_Init(&strum, trace.samples[0]);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+#if defined(__x86_64__) || defined(__i386__)
+        unsigned long long startTsc = __rdtsc();
+#endif
+        for(i = 0; i < count; i++)
+        {
+            sink |= STRUM_Detect(&strum, trace.samples[i]);
+        }
+#if defined(__x86_64__) || defined(__i386__)
+        tsc += __rdtsc() - startTsc;
+#endif
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        ns += (end.tv_sec - start.tv_sec)*1000000000LL + (end.tv_nsec - start.tv_nsec);
+        passes++;
+    } while(ns < REPLAY_MIN_NS);
+
+    *cycles = (double)tsc/((double)passes*count);
+    return (double)ns/((double)passes*count);
+}
+
+/**
+ * @brief Prints the usage of the tool.
+ * @return Void
+ */
+static void REPLAY_Usage(void)
+{
+    fprintf(stderr, "usage: strum_replay [-b scans] [-w window] [-m misses] [-f false] [-v] trace|-\n"
+            "  -b scans    scans per ADC interrupt (1)\n"
+            "  -w window   samples a strum may trail its reference (64)\n"
+            "  -m misses   fail if more strums are missed\n"
+            "  -f false    fail if there are more false triggers\n"
+            "  -v          list every strum\n");
+}
+
+/**
+ * @brief The main entry point of the tool.
+ * @return Returns 0 on success, 1 if a limit was exceeded, 2 on a bad trace.
+ */
+int main(int argc, char** argv)
+{
+    long count, i, n, found;
+    long matched = 0, misses = 0, falseTriggers = 0, references = 0;
+    long maxMisses = -1, maxFalse = -1;
+    double detectSum = 0.0, decisionSum = 0.0, detectMax = 0.0, decisionMax = 0.0;
+    double nsPerSample, cyclesPerSample;
+    double *peaks, *settled, *atDetection;
+    int block = 1, window = 64, opt;
+    BOOL isOnset, isVerbose = FALSE;
+
+    while((opt = getopt(argc, argv, "b:w:m:f:v")) != -1)
+    {
+        switch(opt)
+        {
+            case 'b': block = atoi(optarg); break;
+            case 'w': window = atoi(optarg); break;
+            case 'm': maxMisses = atol(optarg); break;
+            case 'f': maxFalse = atol(optarg); break;
+            case 'v': isVerbose = TRUE; break;
+            default: REPLAY_Usage(); return 2;
+        }
+    }
+    if(optind != argc - 1 || block < 1 || block > REPLAY_MAX_BLOCK || window < 0)
+    {
+        REPLAY_Usage();
+        return 2;
+    }
+    if(!TRACE_Read(&trace, argv[optind]))
+    {
+        return 2;
+    }
+    count = trace.count;
+    isOnset = trace.isOnset;
+    detected = malloc(count*sizeof(BOOL));
+    velocities = calloc(count, sizeof(UINT16));
+    levels = calloc(count, sizeof(UINT16));
+    peaks = malloc(count*sizeof(double));
+    settled = malloc(count*sizeof(double));
+    atDetection = malloc(count*sizeof(double));
+    if(detected == NULL || velocities == NULL || levels == NULL || peaks == NULL || settled == NULL || atDetection == NULL)
+    {
+        fprintf(stderr, "Out of memory.\n");
+        return 2;
+    }
+    found = REPLAY_Detect(count, block);
+
+    /*
+     * Matches each reference strum to the first detection within the window.
+     * An onset can only be detected after it, a live strum on either side.
+     */
+    for(i = 0; i < count; i++)
+    {
+        if(!trace.reference[i])
+        {
+            continue;
+        }
+        references++;
+        for(n = isOnset ? i : ((i > window) ? i - window : 0); n <= i + window && n < count; n++)
+        {
+            if(detected[n])
+            {
+                break;
+            }
+        }
+        if(n <= i + window && n < count)
+        {
+            // The ADC interrupt decides at the end of the block holding the strum.
+            long decision = (n/block)*block + block - 1;
+            double detectUs = (n - i)*TRACE_SCAN_US;
+            double decisionUs = (decision - i)*TRACE_SCAN_US;
+
+            detected[n] = FALSE;
+            peaks[matched] = REPLAY_GetPeak(i);
+            settled[matched] = velocities[n];
+            atDetection[matched] = levels[n];
+            matched++;
+            detectSum += detectUs;
+            decisionSum += decisionUs;
+            detectMax = (detectUs > detectMax) ? detectUs : detectMax;
+            decisionMax = (decisionUs > decisionMax) ? decisionUs : decisionMax;
+            if(isVerbose)
+            {
+                printf("Strum at %ld, detected at %ld, decided at %ld, peak %.0f, velocity %u\n", 
+                        i, n, decision, peaks[matched - 1], velocities[n]);
+            }
+        }
+        else
+        {
+            misses++;
+            if(isVerbose)
+            {
+                printf("Strum at %ld missed\n", i);
+            }
+        }
+    }
+    for(i = 0; i < count; i++)
+    {
+        if(detected[i])
+        {
+            falseTriggers++;
+            if(isVerbose)
+            {
+                printf("False trigger at %ld\n", i);
+            }
+        }
+    }
+
+    nsPerSample = REPLAY_Time(count, &cyclesPerSample);
+
+    printf("Trace: %ld samples, %ld %s, %d scans per interrupt\n", count, references,
+            isOnset ? "onsets" : "live strums", block);
+    printf("Detected: %ld, matched: %ld, missed: %ld, false: %ld\n", found, matched, misses, falseTriggers);
+    if(matched > 0)
+    {
+        const char* from = isOnset ? "Onset" : "Live strum";
+        printf("%s to detection: mean %.1f us, max %.1f us\n", from, detectSum/matched, detectMax);
+        printf("%s to decision: mean %.1f us, max %.1f us\n", from, decisionSum/matched, decisionMax);
+        printf("Velocity: correlation %.2f with the strum peak, %.2f for the envelope at detection\n",
+                REPLAY_Correlate(settled, peaks, matched), REPLAY_Correlate(atDetection, peaks, matched));
+    }
+    printf("Detector cost: %.1f ns per sample", nsPerSample);
+    if(cyclesPerSample > 0.0)
+    {
+        printf(", %.1f TSC cycles per sample", cyclesPerSample);
+    }
+    printf("\n");
+
+    if((maxMisses >= 0 && misses > maxMisses) || (maxFalse >= 0 && falseTriggers > maxFalse))
+    {
+        printf("FAIL: limits are %ld missed, %ld false\n", maxMisses, maxFalse);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file trace.c
+ * @author Kue Yang
+ * @date 10/19/2026
+ * @details Reads strumming sensor traces. A trace is a CAPTURE dump, "CAPTURE
+ * string count", one "index,sample,fret,strum" line per sample and "END". An
+ * optional fifth column marks the true strum onsets, as written by trace_gen. 
+ * Without it the live detector's strums in the fourth column are the reference.
+ * @remarks Host tool, not part of the firmware build.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "trace.h"
+
+/**
+ * @brief Reads a trace.
+ * @details The monitor output around the dump is skipped.
+ * @arg trace The trace to fill.
+ * @arg path The file to read, "-" for the standard input.
+ * @return Returns a boolean indicating if a trace was read.
+ */
+BOOL TRACE_Read(TRACE* trace, const char* path)
+{
+    FILE* file = stdin;
+    char line[128];
+    unsigned int index, sample, fret, strum, onset;
+    BOOL isStarted = FALSE;
+    int fields;
+
+    if(strcmp(path, "-") != 0 && (file = fopen(path, "r")) == NULL)
+    {
+        perror(path);
+        return FALSE;
+    }
+
+    trace->count = 0;
+    trace->isOnset = FALSE;
+    trace->samples = malloc(TRACE_MAX_SAMPLES*sizeof(UINT16));
+    trace->frets = malloc(TRACE_MAX_SAMPLES*sizeof(UINT8));
+    trace->reference = malloc(TRACE_MAX_SAMPLES*sizeof(BOOL));
+    if(trace->samples == NULL || trace->frets == NULL || trace->reference == NULL)
+    {
+        fprintf(stderr, "Out of memory.\n");
+        return FALSE;
+    }
+
+    while(fgets(&line[0], sizeof(line), file) != NULL)
+    {
+        if(!isStarted)
+        {
+            isStarted = (strncmp(&line[0], "CAPTURE", 7) == 0);
+            continue;
+        }
+        if(strncmp(&line[0], "END", 3) == 0)
+        {
+            if(trace->count == 0)
+            {
+                fprintf(stderr, "The trace is empty.\n");
+            }
+            return (trace->count > 0);
+        }
+
+        fields = sscanf(&line[0], "%u,%u,%u,%u,%u", &index, &sample, &fret, &strum, &onset);
+        if(fields < 4 || trace->count >= TRACE_MAX_SAMPLES)
+        {
+            fprintf(stderr, "Bad trace line %ld: %s", trace->count, &line[0]);
+            return FALSE;
+        }
+        if(fields == 5)
+        {
+            trace->isOnset = TRUE;
+        }
+        trace->samples[trace->count] = (UINT16)sample;
+        trace->frets[trace->count] = (UINT8)fret;
+        trace->reference[trace->count] = (fields == 5) ? (onset != 0) : (strum != 0);
+        trace->count++;
+    }
+
+    fprintf(stderr, "The trace has no %s line.\n", isStarted ? "END" : "CAPTURE");
+    return FALSE;
+}
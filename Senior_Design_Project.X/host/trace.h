@@ -0,0 +1,45 @@
+/**
+ * @file trace.h
+ * @author Kue Yang
+ * @date 10/19/2026
+ */
+
+#ifndef TRACE_H
+#define	TRACE_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include "STDDEF.h"
+
+/** @def TRACE_SCAN_US
+ * Defines the time between two samples of a string in us. */
+#define TRACE_SCAN_US           204.8
+/** @def TRACE_MAX_SAMPLES
+ * Defines the largest trace that can be read. */
+#define TRACE_MAX_SAMPLES       (1L << 22)
+
+/**
+ * @brief TRACE data structure.
+ * @details The TRACE data structure stores a strumming sensor trace.
+ */
+typedef struct TRACE
+{
+    /**@{*/
+    long    count;              /**< Variable used to store the number of samples. */
+    UINT16* samples;            /**< Variable used to store the raw ADC samples. */
+    UINT8*  frets;              /**< Variable used to store the fret of each sample. */
+    BOOL*   reference;          /**< Variable used to mark the reference strums. */
+    BOOL    isOnset;            /**< Variable used to indicate the reference strums are true onsets. */
+    /**@}*/
+}TRACE;
+
+BOOL TRACE_Read(TRACE* trace, const char* path);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* TRACE_H */
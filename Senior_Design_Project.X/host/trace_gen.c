@@ -0,0 +1,156 @@
+/**
+ * @file trace_gen.c
+ * @author Kue Yang
+ * @date 10/19/2026
+ * @details Generates a synthetic strumming sensor trace in the format of the
+ * CAPTURE dump, with a fifth column marking the true strum onsets. Each strum
+ * is a decaying oscillation around the mid-rail on top of noise and mains hum.
+ * Some strums land on a string that is still ringing.
+ * @remarks Host tool, not part of the firmware build.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/** @def TRACE_RATE
+ * Defines the samples per second of one string, one scan every 204.8 us. */
+#define TRACE_RATE              4882.8125
+/** @def TRACE_MIDRAIL
+ * Defines the resting ADC reading of the sensor. */
+#define TRACE_MIDRAIL           512
+/** @def TRACE_MAX_READING
+ * Defines the largest ADC reading. */
+#define TRACE_MAX_READING       1023
+/** @def TRACE_PI
+ * Defines pi. */
+#define TRACE_PI                3.14159265358979
+
+/** @var randState
+ * The state of the random number generator. */
+static unsigned long long randState;
+
+/**
+ * @brief Returns a uniform random number.
+ * @arg low The lowest value.
+ * @arg high The highest value.
+ * @return Returns a random number in [low, high).
+ */
+static double TRACE_Uniform(double low, double high)
+{
+    randState = randState*6364136223846793005ULL + 1442695040888963407ULL;
+    return low + (high - low)*((double)(randState >> 11)/9007199254740992.0);
+}
+
+/**
+ * @brief Returns a normally distributed random number.
+ * @arg sigma The standard deviation.
+ * @return Returns a random number with a mean of 0.
+ */
+static double TRACE_Gaussian(double sigma)
+{
+    double u = TRACE_Uniform(1e-12, 1.0);
+    double v = TRACE_Uniform(0.0, 1.0);
+
+    return sigma*sqrt(-2.0*log(u))*cos(2.0*TRACE_PI*v);
+}
+
+/**
+ * @brief Prints the usage of the tool.
+ * @return Void
+ */
+static void TRACE_Usage(void)
+{
+    fprintf(stderr, "usage: trace_gen [-s seed] [-n samples] [-e noise] [-a minAmp] [-A maxAmp]\n"
+            "  -s seed     random seed (1)\n"
+            "  -n samples  number of samples (60000, ~12 s)\n"
+            "  -e noise    noise standard deviation in ADC counts (2)\n"
+            "  -a minAmp   smallest strum amplitude in ADC counts (60)\n"
+            "  -A maxAmp   largest strum amplitude in ADC counts (400)\n");
+}
+
+/**
+ * @brief The main entry point of the tool.
+ * @return Returns 0 on success.
+ */
+int main(int argc, char** argv)
+{
+    long samples = 60000, i = 0, nextStrum = 0;
+    double noise = 2.0, minAmp = 60.0, maxAmp = 400.0;
+    double amp = 0.0, freq = 0.0, phase = 0.0, decay = 0.0, t = 0.0;
+    int fret = 0, onset = 0, opt;
+
+    randState = 1;
+    while((opt = getopt(argc, argv, "s:n:e:a:A:")) != -1)
+    {
+        switch(opt)
+        {
+            case 's': randState = strtoull(optarg, NULL, 0); break;
+            case 'n': samples = atol(optarg); break;
+            case 'e': noise = atof(optarg); break;
+            case 'a': minAmp = atof(optarg); break;
+            case 'A': maxAmp = atof(optarg); break;
+            default: TRACE_Usage(); return 2;
+        }
+    }
+    if(samples <= 0 || minAmp <= 0.0 || maxAmp < minAmp)
+    {
+        TRACE_Usage();
+        return 2;
+    }
+
+    // The first strum comes after the detector has settled on the noise.
+    nextStrum = (long)(TRACE_Uniform(0.5, 1.0)*TRACE_RATE);
+
+    printf("CAPTURE 0 %ld\n", samples);
+    for(i = 0; i < samples; i++)
+    {
+        double value, ringing = amp*exp(-t/decay);
+        long reading;
+
+        onset = 0;
+        if(i == nextStrum)
+        {
+            // A strum on a ringing string has to stand out of the ringing.
+            amp = TRACE_Uniform(minAmp, maxAmp);
+            if(decay > 0.0 && amp < 2.0*ringing + minAmp)
+            {
+                amp = 2.0*ringing + minAmp;
+            }
+            freq = TRACE_Uniform(40.0, 200.0);
+            phase = TRACE_Uniform(0.0, 2.0*TRACE_PI);
+            decay = TRACE_Uniform(0.1, 0.5);
+            fret = (int)TRACE_Uniform(0.0, 13.0);
+            t = 0.0;
+            onset = 1;
+
+            // Most strums let the string ring out, some land while it rings.
+            nextStrum += (long)(TRACE_Uniform(0.0, 1.0) < 0.7 ?
+                    TRACE_Uniform(0.6, 1.5)*TRACE_RATE : TRACE_Uniform(0.3, 0.6)*TRACE_RATE);
+        }
+
+        value = TRACE_MIDRAIL + TRACE_Gaussian(noise) + 3.0*sin(2.0*TRACE_PI*60.0*i/TRACE_RATE);
+        if(decay > 0.0)
+        {
+            // The sensor takes a few samples to swing out to the strum amplitude.
+            double rise = (t*TRACE_RATE < 3.0) ? (t*TRACE_RATE + 1.0)/4.0 : 1.0;
+            value += rise*amp*exp(-t/decay)*sin(2.0*TRACE_PI*freq*t + phase);
+            t += 1.0/TRACE_RATE;
+        }
+
+        reading = lround(value);
+        if(reading < 0)
+        {
+            reading = 0;
+        }
+        else if(reading > TRACE_MAX_READING)
+        {
+            reading = TRACE_MAX_READING;
+        }
+        printf("%ld,%ld,%d,0,%d\n", i, reading, fret, onset);
+    }
+    printf("END\n");
+
+    return 0;
+}
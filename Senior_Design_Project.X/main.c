@@ -16,6 +16,12 @@
 #include "UART.h"
 #include "DAC.h"
 #include "AUDIO.h"
+#include "CAPTURE.h"
+#include "UPLOAD.h"
+#include "LATENCY.h"
+#include "JITTER.h"
+#include "FRET.h"
+#include "SCHED.h"
 
 /**
  * @defgroup usbConfig USB configurations
@@ -88,7 +94,15 @@ int main(void)
 //    CLEAR_WATCHDOG_TIMER;           // Clears the watchdog timer
 //    DEVCFG1bits.WDTPS = 0b00110;    // PostScalar 1:64, 64ms
     
-    /* Enable multi-vector interrupts */
+    /* 
+     * Enable multi-vector interrupts. The interrupt priorities are:
+     *  7  Timer 3, writes one DAC frame using the shadow register set.
+     *  2  DMA 0 (ADC), core software 0 and UART 1. These set new tones and 
+     *     send to the monitor, so they share a priority and never preempt each
+     *     other. UART 1 only queues the monitor commands, the monitor task of
+     *     the main loop runs them.
+     *  1  Core timer, reads the 64-bit timebase twice per wrap of the count.
+     */
     INTConfigureSystem(INT_SYSTEM_CONFIG_MULT_VECTOR);
     INTEnableInterrupts();
 
@@ -99,11 +113,32 @@ int main(void)
 //    ((RCONbits.WDTO == 1) ?  (ERROR_LED = 0) : (ERROR_LED = 1));
     
     TIMER_Init();                   // Initializes all timer modules.
+    LATENCY_Init();                 // Initializes the latency statistics.
+    JITTER_Init();                  // Initializes the DAC capture ring.
+    FRET_Init();                    // Initializes the fret position sensors.
     ADC_Init();                     // Initializes all ADC modules.
     SPI_Init();                     // Initializes all SPI modules.
     UART_Init();                    // Initializes all UART modules
     AUDIO_Init();                   // Initializes the Audio module.
     DAC_Init();                     // Initializes the DACs.
+    CAPTURE_Init();                 // Initializes the ADC capture ring.
+    UPLOAD_Init();                  // Initializes the sample pack upload.
+    SCHED_Init();                   // Initializes the main loop scheduler.
+    
+    /* 
+     * Registers the main loop tasks. Higher priorities run first, the refill
+     * priority rises from 2 to 7 as the audio buffers empty. Periods and 
+     * deadlines are in ms, a period of 0 runs the task whenever it is ready.
+     */
+    SCHED_AddTask("REFILL", AUDIO_Process, AUDIO_NeedsRefill, AUDIO_GetRefillPriority, 2, 0, 2);
+    SCHED_AddTask("CARD", AUDIO_CardProcess, AUDIO_IsCardFree, NULL, 2, 10, 10);
+    SCHED_AddTask("FRETS", AUDIO_FretProcess, NULL, NULL, 4, 2, 2);
+    SCHED_AddTask("PREFETCH", AUDIO_PrefetchProcess, AUDIO_NeedsPrefetch, NULL, 3, 0, 20);
+    SCHED_AddTask("UPLOAD", UPLOAD_Process, UPLOAD_IsActive, NULL, 3, 0, 5);
+    SCHED_AddTask("CAPTURE", CAPTURE_Process, CAPTURE_IsBusy, NULL, 2, 0, 100);
+    SCHED_AddTask("DECODE", AUDIO_BenchmarkProcess, AUDIO_NeedsBenchmark, NULL, 1, 0, 1000);
+    SCHED_AddTask("TELEMETRY", SCHED_SendTelemetry, NULL, NULL, 1, 1000, 100);
+    SCHED_AddTask("MONITOR", UART_Process, UART_IsCommandReady, NULL, 1, 0, 100);
 
     INITIALIZE_LED = 1;             // Turn off the initialize LED
     
@@ -112,7 +147,7 @@ int main(void)
     while(1)
     {
         CLEAR_WATCHDOG_TIMER;           // Clears the watchdog timer
-        AUDIO_Process();
+        SCHED_Run();                    // Runs the most urgent task that is due
     }
 
     return (0);
@@ -51,17 +51,17 @@ OBJECTDIR=build/${CND_CONF}/${IMAGE_TYPE}
 DISTDIR=dist/${CND_CONF}/${IMAGE_TYPE}
 
 # Source Files Quoted if spaced
-SOURCEFILES_QUOTED_IF_SPACED=fatfs/ff.c fatfs/mmc_pic32mx.c main.c ADC.c IO.c SPI.c UART.c FIFO.c DAC.c FILES.c TIMER.c AUDIO.c Interrupts.c
+SOURCEFILES_QUOTED_IF_SPACED=fatfs/ff.c fatfs/mmc_pic32mx.c main.c ADC.c IO.c SPI.c UART.c FIFO.c DAC.c FILES.c TIMER.c AUDIO.c Interrupts.c STRUM.c CAPTURE.c LATENCY.c RESAMPLE.c ATTACKS.c UPLOAD.c JITTER.c SCHED.c READAHEAD.c FRET.c
 
 # Object Files Quoted if spaced
-OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/fatfs/ff.o ${OBJECTDIR}/fatfs/mmc_pic32mx.o ${OBJECTDIR}/main.o ${OBJECTDIR}/ADC.o ${OBJECTDIR}/IO.o ${OBJECTDIR}/SPI.o ${OBJECTDIR}/UART.o ${OBJECTDIR}/FIFO.o ${OBJECTDIR}/DAC.o ${OBJECTDIR}/FILES.o ${OBJECTDIR}/TIMER.o ${OBJECTDIR}/AUDIO.o ${OBJECTDIR}/Interrupts.o
-POSSIBLE_DEPFILES=${OBJECTDIR}/fatfs/ff.o.d ${OBJECTDIR}/fatfs/mmc_pic32mx.o.d ${OBJECTDIR}/main.o.d ${OBJECTDIR}/ADC.o.d ${OBJECTDIR}/IO.o.d ${OBJECTDIR}/SPI.o.d ${OBJECTDIR}/UART.o.d ${OBJECTDIR}/FIFO.o.d ${OBJECTDIR}/DAC.o.d ${OBJECTDIR}/FILES.o.d ${OBJECTDIR}/TIMER.o.d ${OBJECTDIR}/AUDIO.o.d ${OBJECTDIR}/Interrupts.o.d
+OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/fatfs/ff.o ${OBJECTDIR}/fatfs/mmc_pic32mx.o ${OBJECTDIR}/main.o ${OBJECTDIR}/ADC.o ${OBJECTDIR}/IO.o ${OBJECTDIR}/SPI.o ${OBJECTDIR}/UART.o ${OBJECTDIR}/FIFO.o ${OBJECTDIR}/DAC.o ${OBJECTDIR}/FILES.o ${OBJECTDIR}/TIMER.o ${OBJECTDIR}/AUDIO.o ${OBJECTDIR}/Interrupts.o ${OBJECTDIR}/STRUM.o ${OBJECTDIR}/CAPTURE.o ${OBJECTDIR}/LATENCY.o ${OBJECTDIR}/RESAMPLE.o ${OBJECTDIR}/ATTACKS.o ${OBJECTDIR}/UPLOAD.o ${OBJECTDIR}/JITTER.o ${OBJECTDIR}/SCHED.o ${OBJECTDIR}/READAHEAD.o ${OBJECTDIR}/FRET.o
+POSSIBLE_DEPFILES=${OBJECTDIR}/fatfs/ff.o.d ${OBJECTDIR}/fatfs/mmc_pic32mx.o.d ${OBJECTDIR}/main.o.d ${OBJECTDIR}/ADC.o.d ${OBJECTDIR}/IO.o.d ${OBJECTDIR}/SPI.o.d ${OBJECTDIR}/UART.o.d ${OBJECTDIR}/FIFO.o.d ${OBJECTDIR}/DAC.o.d ${OBJECTDIR}/FILES.o.d ${OBJECTDIR}/TIMER.o.d ${OBJECTDIR}/AUDIO.o.d ${OBJECTDIR}/Interrupts.o.d ${OBJECTDIR}/STRUM.o.d ${OBJECTDIR}/CAPTURE.o.d ${OBJECTDIR}/LATENCY.o.d ${OBJECTDIR}/RESAMPLE.o.d ${OBJECTDIR}/ATTACKS.o.d ${OBJECTDIR}/UPLOAD.o.d ${OBJECTDIR}/JITTER.o.d ${OBJECTDIR}/SCHED.o.d ${OBJECTDIR}/READAHEAD.o.d ${OBJECTDIR}/FRET.o.d
 
 # Object Files
-OBJECTFILES=${OBJECTDIR}/fatfs/ff.o ${OBJECTDIR}/fatfs/mmc_pic32mx.o ${OBJECTDIR}/main.o ${OBJECTDIR}/ADC.o ${OBJECTDIR}/IO.o ${OBJECTDIR}/SPI.o ${OBJECTDIR}/UART.o ${OBJECTDIR}/FIFO.o ${OBJECTDIR}/DAC.o ${OBJECTDIR}/FILES.o ${OBJECTDIR}/TIMER.o ${OBJECTDIR}/AUDIO.o ${OBJECTDIR}/Interrupts.o
+OBJECTFILES=${OBJECTDIR}/fatfs/ff.o ${OBJECTDIR}/fatfs/mmc_pic32mx.o ${OBJECTDIR}/main.o ${OBJECTDIR}/ADC.o ${OBJECTDIR}/IO.o ${OBJECTDIR}/SPI.o ${OBJECTDIR}/UART.o ${OBJECTDIR}/FIFO.o ${OBJECTDIR}/DAC.o ${OBJECTDIR}/FILES.o ${OBJECTDIR}/TIMER.o ${OBJECTDIR}/AUDIO.o ${OBJECTDIR}/Interrupts.o ${OBJECTDIR}/STRUM.o ${OBJECTDIR}/CAPTURE.o ${OBJECTDIR}/LATENCY.o ${OBJECTDIR}/RESAMPLE.o ${OBJECTDIR}/ATTACKS.o ${OBJECTDIR}/UPLOAD.o ${OBJECTDIR}/JITTER.o ${OBJECTDIR}/SCHED.o ${OBJECTDIR}/READAHEAD.o ${OBJECTDIR}/FRET.o
 
 # Source Files
-SOURCEFILES=fatfs/ff.c fatfs/mmc_pic32mx.c main.c ADC.c IO.c SPI.c UART.c FIFO.c DAC.c FILES.c TIMER.c AUDIO.c Interrupts.c
+SOURCEFILES=fatfs/ff.c fatfs/mmc_pic32mx.c main.c ADC.c IO.c SPI.c UART.c FIFO.c DAC.c FILES.c TIMER.c AUDIO.c Interrupts.c STRUM.c CAPTURE.c LATENCY.c RESAMPLE.c ATTACKS.c UPLOAD.c JITTER.c SCHED.c READAHEAD.c FRET.c
 
 
 CFLAGS=
@@ -178,6 +178,66 @@ ${OBJECTDIR}/Interrupts.o: Interrupts.c  nbproject/Makefile-${CND_CONF}.mk
 	@${RM} ${OBJECTDIR}/Interrupts.o 
 	@${FIXDEPS} "${OBJECTDIR}/Interrupts.o.d" $(SILENT) -rsi ${MP_CC_DIR}../  -c ${MP_CC}  $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1 -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION)  -D_SUPPRESS_PLIB_WARNING -D_DISABLE_OPENADC10_CONFIGSCAN_WARNING -MMD -MF "${OBJECTDIR}/Interrupts.o.d" -o ${OBJECTDIR}/Interrupts.o Interrupts.c    -DXPRJ_default=$(CND_CONF)  -no-legacy-libc  $(COMPARISON_BUILD) 
 	
+${OBJECTDIR}/FRET.o: FRET.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/FRET.o.d 
+	@${RM} ${OBJECTDIR}/FRET.o 
+	@${FIXDEPS} "${OBJECTDIR}/FRET.o.d" $(SILENT) -rsi ${MP_CC_DIR}../  -c ${MP_CC}  $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1 -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION)  -D_SUPPRESS_PLIB_WARNING -D_DISABLE_OPENADC10_CONFIGSCAN_WARNING -MMD -MF "${OBJECTDIR}/FRET.o.d" -o ${OBJECTDIR}/FRET.o FRET.c    -DXPRJ_default=$(CND_CONF)  -no-legacy-libc  $(COMPARISON_BUILD) 
+	
+${OBJECTDIR}/READAHEAD.o: READAHEAD.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/READAHEAD.o.d 
+	@${RM} ${OBJECTDIR}/READAHEAD.o 
+	@${FIXDEPS} "${OBJECTDIR}/READAHEAD.o.d" $(SILENT) -rsi ${MP_CC_DIR}../  -c ${MP_CC}  $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1 -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION)  -D_SUPPRESS_PLIB_WARNING -D_DISABLE_OPENADC10_CONFIGSCAN_WARNING -MMD -MF "${OBJECTDIR}/READAHEAD.o.d" -o ${OBJECTDIR}/READAHEAD.o READAHEAD.c    -DXPRJ_default=$(CND_CONF)  -no-legacy-libc  $(COMPARISON_BUILD) 
+	
+${OBJECTDIR}/SCHED.o: SCHED.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/SCHED.o.d 
+	@${RM} ${OBJECTDIR}/SCHED.o 
+	@${FIXDEPS} "${OBJECTDIR}/SCHED.o.d" $(SILENT) -rsi ${MP_CC_DIR}../  -c ${MP_CC}  $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1 -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION)  -D_SUPPRESS_PLIB_WARNING -D_DISABLE_OPENADC10_CONFIGSCAN_WARNING -MMD -MF "${OBJECTDIR}/SCHED.o.d" -o ${OBJECTDIR}/SCHED.o SCHED.c    -DXPRJ_default=$(CND_CONF)  -no-legacy-libc  $(COMPARISON_BUILD) 
+	
+${OBJECTDIR}/JITTER.o: JITTER.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/JITTER.o.d 
+	@${RM} ${OBJECTDIR}/JITTER.o 
+	@${FIXDEPS} "${OBJECTDIR}/JITTER.o.d" $(SILENT) -rsi ${MP_CC_DIR}../  -c ${MP_CC}  $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1 -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION)  -D_SUPPRESS_PLIB_WARNING -D_DISABLE_OPENADC10_CONFIGSCAN_WARNING -MMD -MF "${OBJECTDIR}/JITTER.o.d" -o ${OBJECTDIR}/JITTER.o JITTER.c    -DXPRJ_default=$(CND_CONF)  -no-legacy-libc  $(COMPARISON_BUILD) 
+	
+${OBJECTDIR}/UPLOAD.o: UPLOAD.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/UPLOAD.o.d 
+	@${RM} ${OBJECTDIR}/UPLOAD.o 
+	@${FIXDEPS} "${OBJECTDIR}/UPLOAD.o.d" $(SILENT) -rsi ${MP_CC_DIR}../  -c ${MP_CC}  $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1 -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION)  -D_SUPPRESS_PLIB_WARNING -D_DISABLE_OPENADC10_CONFIGSCAN_WARNING -MMD -MF "${OBJECTDIR}/UPLOAD.o.d" -o ${OBJECTDIR}/UPLOAD.o UPLOAD.c    -DXPRJ_default=$(CND_CONF)  -no-legacy-libc  $(COMPARISON_BUILD) 
+	
+${OBJECTDIR}/ATTACKS.o: ATTACKS.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/ATTACKS.o.d 
+	@${RM} ${OBJECTDIR}/ATTACKS.o 
+	@${FIXDEPS} "${OBJECTDIR}/ATTACKS.o.d" $(SILENT) -rsi ${MP_CC_DIR}../  -c ${MP_CC}  $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1 -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION)  -D_SUPPRESS_PLIB_WARNING -D_DISABLE_OPENADC10_CONFIGSCAN_WARNING -MMD -MF "${OBJECTDIR}/ATTACKS.o.d" -o ${OBJECTDIR}/ATTACKS.o ATTACKS.c    -DXPRJ_default=$(CND_CONF)  -no-legacy-libc  $(COMPARISON_BUILD) 
+	
+${OBJECTDIR}/RESAMPLE.o: RESAMPLE.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/RESAMPLE.o.d 
+	@${RM} ${OBJECTDIR}/RESAMPLE.o 
+	@${FIXDEPS} "${OBJECTDIR}/RESAMPLE.o.d" $(SILENT) -rsi ${MP_CC_DIR}../  -c ${MP_CC}  $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1 -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION)  -D_SUPPRESS_PLIB_WARNING -D_DISABLE_OPENADC10_CONFIGSCAN_WARNING -MMD -MF "${OBJECTDIR}/RESAMPLE.o.d" -o ${OBJECTDIR}/RESAMPLE.o RESAMPLE.c    -DXPRJ_default=$(CND_CONF)  -no-legacy-libc  $(COMPARISON_BUILD) 
+	
+${OBJECTDIR}/LATENCY.o: LATENCY.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/LATENCY.o.d 
+	@${RM} ${OBJECTDIR}/LATENCY.o 
+	@${FIXDEPS} "${OBJECTDIR}/LATENCY.o.d" $(SILENT) -rsi ${MP_CC_DIR}../  -c ${MP_CC}  $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1 -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION)  -D_SUPPRESS_PLIB_WARNING -D_DISABLE_OPENADC10_CONFIGSCAN_WARNING -MMD -MF "${OBJECTDIR}/LATENCY.o.d" -o ${OBJECTDIR}/LATENCY.o LATENCY.c    -DXPRJ_default=$(CND_CONF)  -no-legacy-libc  $(COMPARISON_BUILD) 
+	
+${OBJECTDIR}/CAPTURE.o: CAPTURE.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/CAPTURE.o.d 
+	@${RM} ${OBJECTDIR}/CAPTURE.o 
+	@${FIXDEPS} "${OBJECTDIR}/CAPTURE.o.d" $(SILENT) -rsi ${MP_CC_DIR}../  -c ${MP_CC}  $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1 -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION)  -D_SUPPRESS_PLIB_WARNING -D_DISABLE_OPENADC10_CONFIGSCAN_WARNING -MMD -MF "${OBJECTDIR}/CAPTURE.o.d" -o ${OBJECTDIR}/CAPTURE.o CAPTURE.c    -DXPRJ_default=$(CND_CONF)  -no-legacy-libc  $(COMPARISON_BUILD) 
+	
+${OBJECTDIR}/STRUM.o: STRUM.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/STRUM.o.d 
+	@${RM} ${OBJECTDIR}/STRUM.o 
+	@${FIXDEPS} "${OBJECTDIR}/STRUM.o.d" $(SILENT) -rsi ${MP_CC_DIR}../  -c ${MP_CC}  $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1 -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION)  -D_SUPPRESS_PLIB_WARNING -D_DISABLE_OPENADC10_CONFIGSCAN_WARNING -MMD -MF "${OBJECTDIR}/STRUM.o.d" -o ${OBJECTDIR}/STRUM.o STRUM.c    -DXPRJ_default=$(CND_CONF)  -no-legacy-libc  $(COMPARISON_BUILD) 
+	
 else
 ${OBJECTDIR}/fatfs/ff.o: fatfs/ff.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}/fatfs" 
@@ -257,6 +317,66 @@ ${OBJECTDIR}/Interrupts.o: Interrupts.c  nbproject/Makefile-${CND_CONF}.mk
 	@${RM} ${OBJECTDIR}/Interrupts.o 
 	@${FIXDEPS} "${OBJECTDIR}/Interrupts.o.d" $(SILENT) -rsi ${MP_CC_DIR}../  -c ${MP_CC}  $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION)  -D_SUPPRESS_PLIB_WARNING -D_DISABLE_OPENADC10_CONFIGSCAN_WARNING -MMD -MF "${OBJECTDIR}/Interrupts.o.d" -o ${OBJECTDIR}/Interrupts.o Interrupts.c    -DXPRJ_default=$(CND_CONF)  -no-legacy-libc  $(COMPARISON_BUILD) 
 	
+${OBJECTDIR}/FRET.o: FRET.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/FRET.o.d 
+	@${RM} ${OBJECTDIR}/FRET.o 
+	@${FIXDEPS} "${OBJECTDIR}/FRET.o.d" $(SILENT) -rsi ${MP_CC_DIR}../  -c ${MP_CC}  $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION)  -D_SUPPRESS_PLIB_WARNING -D_DISABLE_OPENADC10_CONFIGSCAN_WARNING -MMD -MF "${OBJECTDIR}/FRET.o.d" -o ${OBJECTDIR}/FRET.o FRET.c    -DXPRJ_default=$(CND_CONF)  -no-legacy-libc  $(COMPARISON_BUILD) 
+	
+${OBJECTDIR}/READAHEAD.o: READAHEAD.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/READAHEAD.o.d 
+	@${RM} ${OBJECTDIR}/READAHEAD.o 
+	@${FIXDEPS} "${OBJECTDIR}/READAHEAD.o.d" $(SILENT) -rsi ${MP_CC_DIR}../  -c ${MP_CC}  $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION)  -D_SUPPRESS_PLIB_WARNING -D_DISABLE_OPENADC10_CONFIGSCAN_WARNING -MMD -MF "${OBJECTDIR}/READAHEAD.o.d" -o ${OBJECTDIR}/READAHEAD.o READAHEAD.c    -DXPRJ_default=$(CND_CONF)  -no-legacy-libc  $(COMPARISON_BUILD) 
+	
+${OBJECTDIR}/SCHED.o: SCHED.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/SCHED.o.d 
+	@${RM} ${OBJECTDIR}/SCHED.o 
+	@${FIXDEPS} "${OBJECTDIR}/SCHED.o.d" $(SILENT) -rsi ${MP_CC_DIR}../  -c ${MP_CC}  $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION)  -D_SUPPRESS_PLIB_WARNING -D_DISABLE_OPENADC10_CONFIGSCAN_WARNING -MMD -MF "${OBJECTDIR}/SCHED.o.d" -o ${OBJECTDIR}/SCHED.o SCHED.c    -DXPRJ_default=$(CND_CONF)  -no-legacy-libc  $(COMPARISON_BUILD) 
+	
+${OBJECTDIR}/JITTER.o: JITTER.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/JITTER.o.d 
+	@${RM} ${OBJECTDIR}/JITTER.o 
+	@${FIXDEPS} "${OBJECTDIR}/JITTER.o.d" $(SILENT) -rsi ${MP_CC_DIR}../  -c ${MP_CC}  $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION)  -D_SUPPRESS_PLIB_WARNING -D_DISABLE_OPENADC10_CONFIGSCAN_WARNING -MMD -MF "${OBJECTDIR}/JITTER.o.d" -o ${OBJECTDIR}/JITTER.o JITTER.c    -DXPRJ_default=$(CND_CONF)  -no-legacy-libc  $(COMPARISON_BUILD) 
+	
+${OBJECTDIR}/UPLOAD.o: UPLOAD.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/UPLOAD.o.d 
+	@${RM} ${OBJECTDIR}/UPLOAD.o 
+	@${FIXDEPS} "${OBJECTDIR}/UPLOAD.o.d" $(SILENT) -rsi ${MP_CC_DIR}../  -c ${MP_CC}  $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION)  -D_SUPPRESS_PLIB_WARNING -D_DISABLE_OPENADC10_CONFIGSCAN_WARNING -MMD -MF "${OBJECTDIR}/UPLOAD.o.d" -o ${OBJECTDIR}/UPLOAD.o UPLOAD.c    -DXPRJ_default=$(CND_CONF)  -no-legacy-libc  $(COMPARISON_BUILD) 
+	
+${OBJECTDIR}/ATTACKS.o: ATTACKS.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/ATTACKS.o.d 
+	@${RM} ${OBJECTDIR}/ATTACKS.o 
+	@${FIXDEPS} "${OBJECTDIR}/ATTACKS.o.d" $(SILENT) -rsi ${MP_CC_DIR}../  -c ${MP_CC}  $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION)  -D_SUPPRESS_PLIB_WARNING -D_DISABLE_OPENADC10_CONFIGSCAN_WARNING -MMD -MF "${OBJECTDIR}/ATTACKS.o.d" -o ${OBJECTDIR}/ATTACKS.o ATTACKS.c    -DXPRJ_default=$(CND_CONF)  -no-legacy-libc  $(COMPARISON_BUILD) 
+	
+${OBJECTDIR}/RESAMPLE.o: RESAMPLE.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/RESAMPLE.o.d 
+	@${RM} ${OBJECTDIR}/RESAMPLE.o 
+	@${FIXDEPS} "${OBJECTDIR}/RESAMPLE.o.d" $(SILENT) -rsi ${MP_CC_DIR}../  -c ${MP_CC}  $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION)  -D_SUPPRESS_PLIB_WARNING -D_DISABLE_OPENADC10_CONFIGSCAN_WARNING -MMD -MF "${OBJECTDIR}/RESAMPLE.o.d" -o ${OBJECTDIR}/RESAMPLE.o RESAMPLE.c    -DXPRJ_default=$(CND_CONF)  -no-legacy-libc  $(COMPARISON_BUILD) 
+	
+${OBJECTDIR}/LATENCY.o: LATENCY.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/LATENCY.o.d 
+	@${RM} ${OBJECTDIR}/LATENCY.o 
+	@${FIXDEPS} "${OBJECTDIR}/LATENCY.o.d" $(SILENT) -rsi ${MP_CC_DIR}../  -c ${MP_CC}  $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION)  -D_SUPPRESS_PLIB_WARNING -D_DISABLE_OPENADC10_CONFIGSCAN_WARNING -MMD -MF "${OBJECTDIR}/LATENCY.o.d" -o ${OBJECTDIR}/LATENCY.o LATENCY.c    -DXPRJ_default=$(CND_CONF)  -no-legacy-libc  $(COMPARISON_BUILD) 
+	
+${OBJECTDIR}/CAPTURE.o: CAPTURE.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/CAPTURE.o.d 
+	@${RM} ${OBJECTDIR}/CAPTURE.o 
+	@${FIXDEPS} "${OBJECTDIR}/CAPTURE.o.d" $(SILENT) -rsi ${MP_CC_DIR}../  -c ${MP_CC}  $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION)  -D_SUPPRESS_PLIB_WARNING -D_DISABLE_OPENADC10_CONFIGSCAN_WARNING -MMD -MF "${OBJECTDIR}/CAPTURE.o.d" -o ${OBJECTDIR}/CAPTURE.o CAPTURE.c    -DXPRJ_default=$(CND_CONF)  -no-legacy-libc  $(COMPARISON_BUILD) 
+	
+${OBJECTDIR}/STRUM.o: STRUM.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/STRUM.o.d 
+	@${RM} ${OBJECTDIR}/STRUM.o 
+	@${FIXDEPS} "${OBJECTDIR}/STRUM.o.d" $(SILENT) -rsi ${MP_CC_DIR}../  -c ${MP_CC}  $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION)  -D_SUPPRESS_PLIB_WARNING -D_DISABLE_OPENADC10_CONFIGSCAN_WARNING -MMD -MF "${OBJECTDIR}/STRUM.o.d" -o ${OBJECTDIR}/STRUM.o STRUM.c    -DXPRJ_default=$(CND_CONF)  -no-legacy-libc  $(COMPARISON_BUILD) 
+	
 endif
 
 # ------------------------------------------------------------------------------------